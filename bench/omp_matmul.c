@@ -0,0 +1,37 @@
+// 矩陣乘法：以 #pragma omp parallel for 將列分給執行緒池
+int printf(char *format, ...);
+
+double a[512][512];
+double b[512][512];
+double c[512][512];
+
+int main() {
+    int n = 512;
+    double checksum = 0.0;
+
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            a[i][j] = (i * 7 + j) % 13 - 6;
+            b[i][j] = (i + j * 5) % 11 - 5;
+        }
+    }
+
+#pragma omp parallel for schedule(static)
+    for (int row = 0; row < n; row++) {
+        for (int k = 0; k < n; k++) {
+            double scale = a[row][k];
+            for (int col = 0; col < n; col++) {
+                c[row][col] += scale * b[k][col];
+            }
+        }
+    }
+
+#pragma omp parallel for reduction(+: checksum)
+    for (int r = 0; r < n; r++) {
+        for (int s = 0; s < n; s++) {
+            checksum += c[r][s];
+        }
+    }
+    printf("checksum %d\n", (int)checksum);
+    return 0;
+}
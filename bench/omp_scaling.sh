@@ -0,0 +1,45 @@
+#!/bin/bash
+# Scaling of a `#pragma omp parallel for` program across thread counts.
+# Usage: bench/omp_scaling.sh [program.c] [thread counts...]
+# Defaults to bench/omp_matmul.c and 1, 2, 4, ... up to the number of online CPUs.
+set -e
+
+ROOT="$(cd "$(dirname "$0")/.." && pwd)"
+SOURCE="${1:-$ROOT/bench/omp_matmul.c}"
+shift || true
+THREADS=("$@")
+if [ ${#THREADS[@]} -eq 0 ]; then
+    CPUS=$(nproc)
+    for ((t = 1; t < CPUS; t *= 2)); do
+        THREADS+=("$t")
+    done
+    THREADS+=("$CPUS")
+fi
+RUNS=${RUNS:-3}
+
+BINARY="$(mktemp)"
+trap 'rm -f "$BINARY"' EXIT
+"$ROOT/toyc" "$SOURCE" -o "$BINARY"
+
+# Best wall time of RUNS runs, in milliseconds
+best_time() {
+    local best=""
+    for ((run = 0; run < RUNS; run++)); do
+        local start=$(date +%s%N)
+        TOYC_NUM_THREADS=$1 "$BINARY" > /dev/null
+        local elapsed=$((($(date +%s%N) - start) / 1000000))
+        if [ -z "$best" ] || [ "$elapsed" -lt "$best" ]; then
+            best=$elapsed
+        fi
+    done
+    echo "$best"
+}
+
+echo "$(basename "$SOURCE"): $("$BINARY")"
+printf "%8s %10s %8s\n" threads "time (ms)" speedup
+baseline=""
+for t in "${THREADS[@]}"; do
+    ms=$(best_time "$t")
+    baseline=${baseline:-$ms}
+    printf "%8d %10d %8s\n" "$t" "$ms" "$(awk -v b="$baseline" -v m="$ms" 'BEGIN { printf "%.2fx", b / (m > 0 ? m : 1) }')"
+done
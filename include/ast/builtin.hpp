@@ -0,0 +1,50 @@
+#pragma once
+
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+
+#include "ast/expression.hpp"
+#include "ast/node.hpp"
+
+namespace toyc::ast {
+
+// Functions the compiler lowers itself instead of emitting a call. Consulted before the functions declared
+// in the program, so a prototype does not hide a builtin; a library function the program defines still wins.
+class BuiltinRegistry {
+public:
+    using Lowering = std::function<ExprCodegenResult(ASTContext &context, const std::string &name, NArguments *args)>;
+
+    static const BuiltinRegistry &instance();
+
+    // `__builtin_` names are always lowered; known library functions only while -fno-builtin allows it, and
+    // those that may set errno only under -fno-math-errno
+    const Lowering *find(const std::string &name, const CodegenOptions &options) const;
+
+private:
+    BuiltinRegistry();
+    // Registers both `name`, as a library function, and `__builtin_name`
+    void addLibraryFunction(const std::string &name, const Lowering &lowering, bool setsErrno = false);
+
+    std::map<std::string, Lowering> builtins;
+    std::map<std::string, Lowering> libraryFunctions;
+    std::set<std::string> errnoFunctions;
+};
+
+// An x86 feature that `__builtin_cpu_supports` and `target_clones` can test at run time: its bit in libgcc's
+// __cpu_model.__cpu_features[0] and how strongly a clone for it is preferred over the others
+struct CpuFeature {
+    const char *name;
+    unsigned bit;
+    unsigned priority;
+};
+
+// The feature called `name` (as GCC spells it, e.g. "avx2" or "sse4.2"), or nullptr if it cannot be tested
+const CpuFeature *findCpuFeature(const std::string &name);
+// Has libgcc fill in __cpu_model; ifunc resolvers run before its constructor does
+llvm::CallInst *emitCpuInit(ASTContext &context);
+// An i1 that is true when the running CPU has the feature
+llvm::Value *emitCpuSupports(ASTContext &context, const CpuFeature &feature);
+
+}  // namespace toyc::ast
@@ -70,6 +70,11 @@ public:
         return data.allocInst;
     }
 
+    template <typename U = T>
+    auto getBitField() const -> decltype(std::declval<U>().bitField) {
+        return data.bitField;
+    }
+
 private:
     T data;
     std::string errorMessage;
@@ -112,12 +117,24 @@ struct ExprValue {
     bool isValid() const { return value != nullptr && type != InvalidTypeIdx; }
 };
 
+/**
+ * Where a bit-field lvalue lives: `width` bits starting at bit `shift` (counted from the least significant bit)
+ * of the storageBits-wide integer at the lvalue's address. A width of 0 marks an ordinary lvalue.
+ */
+struct BitFieldSlot {
+    unsigned storageBits = 0;
+    unsigned shift = 0;
+    unsigned width = 0;
+};
+
 struct AllocValue {
     llvm::Value* allocInst = nullptr;
     TypeIdx type = InvalidTypeIdx;
+    BitFieldSlot bitField;
 
     AllocValue() = default;
     AllocValue(llvm::Value* a, TypeIdx t) : allocInst(a), type(t) {}
+    AllocValue(llvm::Value* a, TypeIdx t, BitFieldSlot b) : allocInst(a), type(t), bitField(b) {}
     bool isValid() const { return allocInst != nullptr && type != InvalidTypeIdx; }
 };
 
@@ -2,6 +2,8 @@
 
 #include <climits>
 #include <cstdint>
+#include <string>
+#include <vector>
 
 namespace toyc::ast {
 
@@ -17,7 +19,11 @@ enum VarType {
     VAR_TYPE_DOUBLE = 8,
     VAR_TYPE_PTR = 9,
     VAR_TYPE_STRUCT = 10,
-    VAR_TYPE_ARRAY = 11
+    VAR_TYPE_ARRAY = 11,
+    VAR_TYPE_UCHAR = 12,
+    VAR_TYPE_USHORT = 13,
+    VAR_TYPE_UINT = 14,
+    VAR_TYPE_ULONG = 15
 };
 
 // ==================== TypeIdx ====================
@@ -31,13 +37,59 @@ enum TypeQualifier : uint8_t {
     QUAL_NONE = 0,
     QUAL_CONST = 1 << 0,
     QUAL_VOLATILE = 1 << 1,
+    QUAL_RESTRICT = 1 << 2,
+    QUAL_ATOMIC = 1 << 3,
 };
 
 // Bit positions used when the grammar encodes a pointer level + qualifiers into one int.
-// Bits 0-15: pointer level count. Bit 16: CONST. Bit 17: VOLATILE.
+// Bits 0-15: pointer level count. Bit 16: CONST. Bit 17: VOLATILE. Bit 18: RESTRICT. Bit 19: ATOMIC.
 static constexpr int POINTER_LEVEL_MASK = 0xFFFF;
 static constexpr int POINTER_CONST_BIT = (1 << 16);
 static constexpr int POINTER_VOLATILE_BIT = (1 << 17);
+static constexpr int POINTER_RESTRICT_BIT = (1 << 18);
+static constexpr int POINTER_ATOMIC_BIT = (1 << 19);
+
+// Storage class of a declaration; STORAGE_NONE means automatic inside functions and external at file scope
+enum StorageClass { STORAGE_NONE, STORAGE_STATIC, STORAGE_EXTERN };
+
+// One entry of a GNU `__attribute__((...))` list. The name has any surrounding `__` stripped, and the
+// arguments keep their source spelling (string literals without quotes).
+struct GnuAttribute {
+    std::string name;
+    std::vector<std::string> arguments;
+};
+using GnuAttributeList = std::vector<GnuAttribute>;
+
+// Work-sharing schedule of an `omp parallel for`; the values are the schedule codes the runtime library expects
+enum OmpSchedule { OMP_SCHEDULE_STATIC = 0, OMP_SCHEDULE_DYNAMIC = 1 };
+
+// Loop pragmas (`#pragma clang loop`, `#pragma unroll`, `#pragma GCC unroll/ivdep`, `#pragma omp parallel for`) for
+// the loop statement that follows them. Zero counts and false flags mean the pragma did not ask for anything.
+struct LoopHints {
+    bool vectorizeEnable = false;
+    bool vectorizeDisable = false;
+    int vectorizeWidth = 0;
+    int interleaveCount = 0;
+    bool unrollEnable = false;
+    bool unrollFull = false;
+    bool unrollDisable = false;
+    int unrollCount = 0;
+    bool parallelAccesses = false;  // ivdep / vectorize(assume_safety): iterations do not depend on each other
+
+    // `#pragma omp parallel for`: iterations are split across the runtime library's thread pool
+    bool parallelFor = false;
+    OmpSchedule schedule = OMP_SCHEDULE_STATIC;
+    int64_t chunkSize = 0;                   // schedule(kind, N); 0 leaves the chunk size to the runtime
+    std::vector<std::string> privateVars;    // private(...)
+    std::vector<std::string> reductionVars;  // reduction(+: ...)
+
+    // True when there is no llvm.loop metadata to attach
+    bool empty() const {
+        return false == vectorizeEnable && false == vectorizeDisable && 0 == vectorizeWidth && 0 == interleaveCount &&
+               false == unrollEnable && false == unrollFull && false == unrollDisable && 0 == unrollCount &&
+               false == parallelAccesses;
+    }
+};
 
 enum BineryOperator { AND, OR, ADD, SUB, MUL, DIV, MOD, LEFT, RIGHT, EQ, NE, LE, GE, LT, GT, BIT_AND, BIT_OR, XOR };
 
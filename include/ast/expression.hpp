@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <iostream>
 #include <memory>
 
@@ -13,6 +14,9 @@ public:
     virtual AllocCodegenResult allocgen(ASTContext & /*context*/) {
         return AllocCodegenResult("Allocation not supported for " + getType());
     }
+    // Address of the struct or union this expression yields: the object itself if it designates one (a call's
+    // result slot included), otherwise a temporary holding the value
+    AllocCodegenResult aggregategen(ASTContext &context);
     virtual std::string getType() const override { return "Expression"; }
 };
 
@@ -21,6 +25,9 @@ public:
     NBinaryOperator(NExpression *lhs, BineryOperator op, NExpression *rhs) : lhs(lhs), rhs(rhs), op(op) {}
     virtual ExprCodegenResult codegen(ASTContext &context) override;
     virtual std::string getType() const override { return "BinaryOperator"; }
+    NExpression *getLHS() const { return lhs.get(); }
+    NExpression *getRHS() const { return rhs.get(); }
+    BineryOperator getOperator() const { return op; }
 
 protected:
     std::unique_ptr<NExpression> lhs;
@@ -40,7 +47,9 @@ public:
     NUnaryExpression(UnaryOperator op, NExpression *expr) : op(op), expr(expr) {}
     virtual ExprCodegenResult codegen(ASTContext &context) override;
     virtual std::string getType() const override { return "UnaryOperator"; }
-    virtual AllocCodegenResult allocgen(ASTContext &context) override { return expr->allocgen(context); };
+    virtual AllocCodegenResult allocgen(ASTContext &context) override;
+    UnaryOperator getOperator() const { return op; }
+    NExpression *getOperand() const { return expr.get(); }
 
 private:
     UnaryOperator op;
@@ -66,6 +75,7 @@ public:
     virtual ExprCodegenResult codegen(ASTContext &context) override;
     virtual AllocCodegenResult allocgen(ASTContext &context) override;
     virtual std::string getType() const override { return "Identifier"; }
+    const std::string &getName() const { return name; }
 
 private:
     std::string name;
@@ -73,23 +83,25 @@ private:
 
 class NInteger : public NExpression {
 public:
-    explicit NInteger(int value) : value(value) {}
+    explicit NInteger(int64_t value, VarType varType = VAR_TYPE_INT) : value(value), varType(varType) {}
     virtual ExprCodegenResult codegen(ASTContext &context) override;
     virtual std::string getType() const override { return "Integer"; }
-    int getValue() const { return value; }
+    int64_t getValue() const { return value; }
 
 private:
-    int value;
+    int64_t value;
+    VarType varType;  // picked from the literal's value and suffix, VAR_TYPE_INT for character constants
 };
 
 class NFloat : public NExpression {
 public:
-    explicit NFloat(double value) : value(value) {}
+    explicit NFloat(double value, VarType varType = VAR_TYPE_DOUBLE) : value(value), varType(varType) {}
     virtual ExprCodegenResult codegen(ASTContext &context) override;
     virtual std::string getType() const override { return "Float"; }
 
 private:
     double value;
+    VarType varType;  // VAR_TYPE_FLOAT for an `f` suffix, VAR_TYPE_DOUBLE otherwise
 };
 
 class NString : public NExpression {
@@ -97,6 +109,7 @@ public:
     explicit NString(const std::string &value) : value(value) {}
     virtual ExprCodegenResult codegen(ASTContext &context) override;
     virtual std::string getType() const override { return "String"; }
+    const std::string &getValue() const { return value; }
 
 private:
     std::string value;
@@ -133,6 +146,12 @@ public:
     std::unique_ptr<NExpression> expr;
     std::vector<std::unique_ptr<NExpression>> arrayDimensions;
     bool isVLA = false;
+    uint64_t alignment = 0;   // aligned(N) on this declarator, 0 if absent
+    bool packed = false;      // packed on a struct field
+    int bitWidth = -1;        // width of a bit-field struct member, -1 for an ordinary member
+    uint64_t vectorSize = 0;  // vector_size(N) in bytes on a typedef, 0 if absent
+    // tls_model("...") on a thread-local variable; NotThreadLocal defers to -ftls-model
+    llvm::GlobalValue::ThreadLocalMode tlsModel = llvm::GlobalValue::NotThreadLocal;
 
 private:
     std::string name;
@@ -143,6 +162,8 @@ public:
     NAssignment(NExpression *lhs, NExpression *rhs) : lhs(lhs), rhs(rhs) {}
     virtual ExprCodegenResult codegen(ASTContext &context) override;
     virtual std::string getType() const override { return "Assignment"; }
+    NExpression *getLHS() const { return lhs.get(); }
+    NExpression *getRHS() const { return rhs.get(); }
 
 private:
     std::unique_ptr<NExpression> lhs;
@@ -164,9 +185,16 @@ class NFunctionCall : public NExpression {
 public:
     NFunctionCall(const std::string &name, NArguments *argNodes) : name(name), argNodes(argNodes) {}
     virtual ExprCodegenResult codegen(ASTContext &context) override;
+    // The temporary a struct or union result is returned in
+    virtual AllocCodegenResult allocgen(ASTContext &context) override;
     virtual std::string getType() const override { return "FunctionCall"; }
+    const std::string &getName() const { return name; }
+    NArguments *getArguments() const { return argNodes.get(); }
 
 private:
+    // Passes the arguments as the callee's ABI lowering expects; a record result is left in resultSlot
+    ExprCodegenResult emitCall(ASTContext &context, NFunctionDefinition *function, llvm::Value *resultSlot);
+
     std::string name;
     std::unique_ptr<NArguments> argNodes;
 };
@@ -191,8 +219,14 @@ public:
     virtual ExprCodegenResult codegen(ASTContext &context) override;
     virtual AllocCodegenResult allocgen(ASTContext &context) override;
     virtual std::string getType() const override { return "ArraySubscript"; }
+    // `array[index] = value`; a vector lane is inserted into the whole vector rather than stored on its own
+    ExprCodegenResult assign(ASTContext &context, NExpression *value);
 
 private:
+    // Evaluates the index, then the storage of the array, pointer or vector being subscripted
+    AllocCodegenResult basegen(ASTContext &context, ExprCodegenResult &indexResult);
+    AllocCodegenResult elementgen(ASTContext &context, const AllocCodegenResult &baseResult, llvm::Value *indexValue);
+
     std::unique_ptr<NExpression> array;
     std::unique_ptr<NExpression> index;
 };
@@ -244,6 +278,9 @@ public:
     NCompoundAssignment(NExpression *lhs, BineryOperator op, NExpression *rhs) : lhs(lhs), op(op), rhs(rhs) {}
     virtual ExprCodegenResult codegen(ASTContext &context) override;
     virtual std::string getType() const override { return "CompoundAssignment"; }
+    NExpression *getLHS() const { return lhs.get(); }
+    NExpression *getRHS() const { return rhs.get(); }
+    BineryOperator getOperator() const { return op; }
 
 private:
     std::unique_ptr<NExpression> lhs;
@@ -3,6 +3,7 @@
 #include <iostream>
 #include <memory>
 
+#include "ast/builtin.hpp"
 #include "ast/expression.hpp"
 #include "ast/node.hpp"
 #include "ast/statement.hpp"
@@ -38,12 +39,27 @@ public:
         : name(name), returnTypeIdx(returnTypeIdx), params(params), body(body) {}
     ~NFunctionDefinition();
     virtual StmtCodegenResult codegen(ASTContext &context) override;
+    // Checks and cleanups once the body is emitted; also used for bodies outlined into their own function
+    StmtCodegenResult finalizeBody(ASTContext &context);
     virtual std::string getType() const override { return "FunctionDefinition"; }
     llvm::Function *getFunction() const { return llvmFunction; }
+    // What calls go to: the function itself, or the ifunc choosing among its target_clones versions
+    llvm::FunctionCallee getCallee() const;
     llvm::Type *getReturnType() const { return returnType; }
     TypeIdx getReturnTypeIdx() const { return returnTypeIdx; }
     NParameter *getParams() const { return params.get(); }
+    // LLVM arguments follow the named parameters in order, after the sret pointer if the result is Indirect
+    const ArgumentPassing &getReturnPassing() const { return returnPassing; }
+    const std::vector<ArgumentPassing> &getParamPassing() const { return paramPassing; }
     NBlock *getBody() const { return body.get(); }
+    void setSpecifiers(StorageClass storageClass, bool isInline) {
+        this->storageClass = storageClass;
+        this->isInline = isInline;
+    }
+    void addAttributes(GnuAttributeList attributes) {
+        this->attributes.insert(this->attributes.end(), std::make_move_iterator(attributes.begin()),
+                                std::make_move_iterator(attributes.end()));
+    }
 
 private:
     llvm::Function *llvmFunction = nullptr;
@@ -52,6 +68,19 @@ private:
     llvm::Type *returnType = nullptr;
     std::unique_ptr<NParameter> params;
     std::unique_ptr<NBlock> body;
+    ArgumentPassing returnPassing;
+    std::vector<ArgumentPassing> paramPassing;
+    StmtCodegenResult applyAttributes();
+    StmtCodegenResult parseTargetClones();
+    void emitTargetClones(ASTContext &context);
+    void applyPassingAttributes(ASTContext &context);
+    void flattenCalls();
+
+    StorageClass storageClass = STORAGE_NONE;
+    bool isInline = false;
+    GnuAttributeList attributes;
+    std::vector<const CpuFeature *> cloneFeatures;  // target_clones versions besides "default", least preferred first
+    llvm::GlobalIFunc *dispatcher = nullptr;
 };
 
 }  // namespace toyc::ast
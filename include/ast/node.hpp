@@ -9,9 +9,11 @@
 #include <iostream>
 #include <map>
 #include <memory>
+#include <set>
 #include <stack>
 #include <string>
 #include <unordered_set>
+#include <vector>
 
 #include "ast/codegen_result.hpp"
 #include "ast/type.hpp"
@@ -55,6 +57,16 @@ private:
     friend class ASTContext;
 };
 
+// Stack bookkeeping for one lexical scope, kept parallel to the variable scope chain.
+// Used to release VLA stack space and end local lifetimes when control leaves the scope.
+struct ScopeStackState {
+    unsigned id = 0;
+    llvm::Value *stackSave = nullptr;           // llvm.stacksave taken before the scope's first VLA
+    std::vector<llvm::AllocaInst *> lifetimes;  // fixed-size locals with an open llvm.lifetime.start
+};
+
+using ScopeChain = std::vector<ScopeStackState>;
+
 // Jump context for break/continue statements
 // Used by loops (for/while/do-while) and switch statements
 class NJumpContext {
@@ -65,6 +77,10 @@ public:
     llvm::BasicBlock *getContinueTarget() const { return continueTarget; }
     llvm::BasicBlock *getBreakTarget() const { return breakTarget; }
 
+    // Number of scopes open when the loop/switch was entered; jumps unwind everything above it
+    size_t getScopeDepth() const { return scopeDepth; }
+    void setScopeDepth(size_t depth) { scopeDepth = depth; }
+
     virtual bool supportsContinue() const { return true; }
     virtual bool supportsBreak() const { return true; }
     virtual std::string getContextName() const { return "loop"; }
@@ -72,6 +88,7 @@ public:
 protected:
     llvm::BasicBlock *continueTarget;
     llvm::BasicBlock *breakTarget;
+    size_t scopeDepth = 0;
 };
 
 // Switch context - only supports break, not continue
@@ -84,32 +101,98 @@ public:
     virtual std::string getContextName() const override { return "switch"; }
 };
 
+// Body of an outlined `omp parallel for` - continue ends the iteration, but nothing may leave the loop early
+class NParallelForContext : public NJumpContext {
+public:
+    explicit NParallelForContext(llvm::BasicBlock *continueTarget) : NJumpContext(continueTarget, nullptr) {}
+
+    virtual bool supportsContinue() const override { return true; }
+    virtual bool supportsBreak() const override { return false; }
+    virtual std::string getContextName() const override { return "omp parallel for"; }
+};
+
+// -ffp-contract=: whether a * b + c may be computed with a single rounding
+enum FPContract {
+    FP_CONTRACT_OFF,   // never
+    FP_CONTRACT_ON,    // within one expression, as llvm.fmuladd
+    FP_CONTRACT_FAST,  // anywhere the optimizer finds the pattern, through the `contract` flag
+};
+
+// Code generation switches set from the command line
+struct CodegenOptions {
+    bool strictAliasing = true;       // attach !tbaa to loads and stores; cleared by -fno-strict-aliasing
+    bool structLayoutReport = false;  // print every struct layout after codegen; set by -fstruct-layout-report
+    bool libraryBuiltins = true;      // lower known libc/libm calls to intrinsics; cleared by -fno-builtin
+    std::set<std::string> noBuiltinFunctions;  // library functions excluded by -fno-builtin-<name>
+    bool positionIndependent = false;          // code may end up in a shared object; set by -fPIC/-fpic
+    // TLS model for thread-local variables from -ftls-model=; NotThreadLocal picks one by positionIndependent
+    llvm::GlobalValue::ThreadLocalMode tlsModel = llvm::GlobalValue::NotThreadLocal;
+    // Fast-math flags put on every floating-point instruction: from -ffast-math, -fassociative-math and
+    // -freciprocal-math, plus `contract` under -ffp-contract=fast
+    llvm::FastMathFlags fastMath;
+    FPContract fpContract = FP_CONTRACT_OFF;
+    bool mathErrno = true;  // sqrt may set errno, so it stays a library call; cleared by -fno-math-errno
+};
+
+// GCC's TLS model names (global-dynamic, local-dynamic, initial-exec, local-exec) as used by -ftls-model= and
+// __attribute__((tls_model)); false for any other name
+bool parseTlsModel(const std::string &name, llvm::GlobalValue::ThreadLocalMode &mode);
+
 struct ASTContext {
     llvm::LLVMContext llvmContext;
     llvm::Module module;
     llvm::IRBuilder<> builder;
     NFunctionDefinition *currentFunction = nullptr;
-    ScopeTable<std::pair<llvm::AllocaInst *, TypeIdx>> *variableTable = nullptr;
+    ScopeTable<std::pair<llvm::Value *, TypeIdx>> *variableTable = nullptr;
 
     std::map<std::string, NFunctionDefinition *> functionDefinitions;
     bool isInitializingFunction = false;
 
     std::unique_ptr<TypeManager> typeManager;
     TypeManager &getTypeManager() { return *typeManager; }
+    CodegenOptions options;
 
     // Jump context stack for break/continue statements
     // Used by loops (for/while/do-while) and switch statements
     std::stack<std::shared_ptr<NJumpContext>> jumpContextStack;
 
+    // String literal pool: one private global per distinct literal, keyed by its reversed contents so a
+    // literal that is a suffix of a pooled one is found by prefix search and points into its tail
+    std::map<std::string, llvm::GlobalVariable *> stringPool;
+
+    // File-scope variables defined with an initializer; a second initialized definition is an error even when
+    // both initializers are zero
+    std::set<llvm::GlobalVariable *> initializedGlobals;
+
+    // Scope chain for VLA stack save/restore and lifetime markers (innermost scope last)
+    ScopeChain scopeStack;
+    unsigned nextScopeId = 0;
+
     // Label management for goto statements
+    // A forward goto remembers its branch and scope chain so scope exits can be patched in
+    // once the label (and therefore the set of scopes left) is known.
+    struct PendingGoto {
+        llvm::BranchInst *branch;
+        ScopeChain scopes;
+    };
     std::map<std::string, llvm::BasicBlock *> labels;
-    std::unordered_set<std::string> pendingGotos;
+    std::map<std::string, ScopeChain> labelScopes;
+    std::map<std::string, std::vector<PendingGoto>> pendingGotos;
 
     // Switch statement tracking (for case/default statements)
     llvm::SwitchInst *currentSwitch = nullptr;
     llvm::BasicBlock *currentSwitchAfter = nullptr;
     llvm::BasicBlock *currentSwitchDefault = nullptr;
     bool switchHasDefault = false;
+    ScopeChain currentSwitchScopes;
+    TypeIdx currentSwitchTypeIdx = InvalidTypeIdx;  // promoted condition type that case labels convert to
+    // GNU case ranges too wide to enumerate as individual cases; checked on the switch's default path
+    struct CaseRange {
+        llvm::ConstantInt *low;
+        llvm::ConstantInt *high;
+        llvm::BasicBlock *block;
+    };
+    std::vector<CaseRange> currentSwitchRanges;
 
     ASTContext();
     ~ASTContext();
@@ -126,6 +209,36 @@ struct ASTContext {
 
     void pushScope();
     void popScope();
+
+    llvm::Constant *getStringLiteral(const std::string &value);
+
+    // Stack management for locals
+    llvm::AllocaInst *createEntryAlloca(llvm::Type *type, const std::string &name);
+    void beginLifetime(llvm::AllocaInst *allocaInst);
+    void saveStackForVLA();
+    void emitScopeExit(const ScopeChain &from, const ScopeChain &to);
+    void dropBypassedLifetimes(const ScopeChain &from, const ScopeChain &to);
+
+    void alignPackedAccesses(llvm::Function *function);
+    // TBAA tag for the access type; loads and stores of _Atomic objects also become seq_cst atomics
+    void annotateAccess(llvm::Instruction *access, TypeIdx accessTypeIdx);
+
+    // Bit-fields are read and written through their storage unit; storeBitField returns the value the field
+    // holds afterwards, i.e. value cut down to the field's width
+    llvm::Value *loadBitField(const AllocCodegenResult &lvalue);
+    llvm::Value *storeBitField(const AllocCodegenResult &lvalue, llvm::Value *value);
+
+    // A struct or union moves as a whole with one llvm.memcpy. One passed in registers (ArgumentPassing::Coerced)
+    // travels as one value per piece, read from or written to the object at address.
+    void copyAggregate(llvm::Value *destination, llvm::Value *source, TypeIdx typeIdx);
+    std::vector<llvm::Value *> loadPieces(llvm::Value *address, TypeIdx typeIdx, const ArgumentPassing &passing);
+    void storePieces(llvm::Value *address, TypeIdx typeIdx, const std::vector<llvm::Value *> &pieces);
+
+    // Whole-module pass run once every definition is emitted: nounwind, readnone/readonly, nocapture, tail calls
+    void inferFunctionAttributes();
+
+private:
+    void eraseLifetimeMarkers(llvm::AllocaInst *allocaInst);
 };
 
 class BasicNode {
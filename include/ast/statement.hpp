@@ -2,6 +2,7 @@
 
 #include <map>
 #include <memory>
+#include <vector>
 
 #include "ast/expression.hpp"
 #include "ast/node.hpp"
@@ -22,13 +23,28 @@ public:
 
 class NDeclarationStatement : public NStatement, public NExternalDeclaration {
 public:
-    NDeclarationStatement(TypeIdx typeIdx, NDeclarator *declarator) : typeIdx(typeIdx), declarator(declarator) {}
+    NDeclarationStatement(TypeIdx typeIdx, NDeclarator *declarator, StorageClass storageClass = STORAGE_NONE,
+                          bool threadLocal = false)
+        : typeIdx(typeIdx), declarator(declarator), storageClass(storageClass), threadLocal(threadLocal) {}
     virtual StmtCodegenResult codegen(ASTContext &context) override;
     virtual std::string getType() const override { return "DeclarationStatement"; }
+    NDeclarator *getDeclarators() const { return declarator.get(); }
 
 private:
-    StmtCodegenResult initializeArrayElements(llvm::AllocaInst *allocaInst, TypeIdx arrayTypeIdx,
-                                              NInitializerList *initList, ASTContext &context);
+    // A scalar reached while walking a braced initializer, addressed by its GEP indices from the object; a
+    // bit-field is addressed by its storage unit
+    struct InitializerLeaf {
+        std::vector<llvm::Value *> indices;
+        llvm::Value *value;
+        TypeIdx typeIdx;
+        BitFieldSlot bitField;
+    };
+
+    StmtCodegenResult initializeAggregate(llvm::AllocaInst *allocaInst, TypeIdx aggregateTypeIdx,
+                                          NExpression *initializer, ASTContext &context);
+    StmtCodegenResult lowerInitializer(ASTContext &context, TypeIdx typeIdx, NExpression *initializer,
+                                       std::vector<llvm::Value *> &indices, std::vector<InitializerLeaf> &leaves,
+                                       bool &complete, llvm::Constant *&constant);
 
     AllocCodegenResult createSingleAllocation(ASTContext &context, llvm::Type *type, TypeIdx typeIdx,
                                               NDeclarator *declarator);
@@ -36,9 +52,12 @@ private:
                                              NDeclarator *declarator);
     AllocCodegenResult createPointerAllocation(ASTContext &context, llvm::Type *baseType, TypeIdx baseTypeIdx,
                                                NDeclarator *declarator);
+    AllocCodegenResult createGlobalVariable(ASTContext &context, TypeIdx baseTypeIdx, NDeclarator *declarator);
 
     TypeIdx typeIdx;
     std::unique_ptr<NDeclarator> declarator;
+    StorageClass storageClass;
+    bool threadLocal;  // _Thread_local / __thread: one instance per thread
 };
 
 class NExpressionStatement : public NStatement {
@@ -46,6 +65,7 @@ public:
     explicit NExpressionStatement(NExpression *expression) : expression(expression) {}
     virtual StmtCodegenResult codegen(ASTContext &context) override;
     virtual std::string getType() const override { return "ExpressionStatement"; }
+    NExpression *getExpression() const { return expression.get(); }
 
 private:
     std::unique_ptr<NExpression> expression;
@@ -117,12 +137,17 @@ public:
     }
     virtual StmtCodegenResult codegen(ASTContext &context) override;
     virtual std::string getType() const override { return "ForStatement"; }
+    void setLoopHints(const LoopHints &hints) { loopHints = hints; }
 
 private:
+    // `#pragma omp parallel for`: outline the body and hand the iteration space to the runtime library
+    StmtCodegenResult parallelCodegen(ASTContext &context);
+
     std::unique_ptr<NStatement> initializationNode;
     std::unique_ptr<NExpression> conditionNode;
     std::unique_ptr<NExpression> incrementNode;
     std::unique_ptr<NBlock> bodyNode;
+    LoopHints loopHints;
 };
 
 class NWhileStatement : public NStatement {
@@ -137,11 +162,13 @@ public:
     }
     virtual StmtCodegenResult codegen(ASTContext &context) override;
     virtual std::string getType() const override { return "WhileStatement"; }
+    void setLoopHints(const LoopHints &hints) { loopHints = hints; }
 
 private:
     std::unique_ptr<NExpression> conditionNode;
     std::unique_ptr<NBlock> bodyNode;
     bool isDoWhile;  // true if this is a do-while loop
+    LoopHints loopHints;
 };
 
 class NBreakStatement : public NStatement {
@@ -179,6 +206,35 @@ private:
     std::string label;
 };
 
+// One `[name] "constraint" (expression)` operand of a GNU asm statement; the name is empty when not given
+struct AsmOperand {
+    std::string name;
+    std::string constraint;
+    std::unique_ptr<NExpression> expression;
+};
+
+// GNU `asm [volatile] ("template" : outputs : inputs : clobbers);`, lowered to a call of an llvm::InlineAsm
+class NAsmStatement : public NStatement {
+public:
+    NAsmStatement(const std::string &asmTemplate, bool isVolatile, std::vector<AsmOperand> outputs,
+                  std::vector<AsmOperand> inputs, std::vector<std::string> clobbers)
+        : asmTemplate(asmTemplate), isVolatile(isVolatile), outputs(std::move(outputs)), inputs(std::move(inputs)),
+          clobbers(std::move(clobbers)) {}
+    virtual StmtCodegenResult codegen(ASTContext &context) override;
+    virtual std::string getType() const override { return "AsmStatement"; }
+
+private:
+    // Rewrites the GCC template (`%0`, `%[name]`, `%k1`, `%%`, `%=`) into LLVM's `$`-based syntax
+    StmtCodegenResult lowerTemplate(std::string &lowered) const;
+    int findOperand(const std::string &name) const;
+
+    std::string asmTemplate;
+    bool isVolatile;
+    std::vector<AsmOperand> outputs;
+    std::vector<AsmOperand> inputs;
+    std::vector<std::string> clobbers;
+};
+
 class NSwitchStatement : public NStatement {
 public:
     NSwitchStatement(NExpression *condition, NStatement *body) : condition(condition), body(body) {}
@@ -192,8 +248,8 @@ private:
 
 class NCaseStatement : public NStatement {
 public:
-    explicit NCaseStatement(NExpression *value, NStatement *statements = nullptr)
-        : value(value), statements(statements), isDefault(false) {}
+    explicit NCaseStatement(NExpression *value, NStatement *statements = nullptr, NExpression *rangeEnd = nullptr)
+        : value(value), rangeEnd(rangeEnd), statements(statements), isDefault(false) {}
 
     explicit NCaseStatement(bool isDefault, NStatement *statements = nullptr)
         : value(nullptr), statements(statements), isDefault(isDefault) {}
@@ -202,11 +258,15 @@ public:
     virtual std::string getType() const override { return "CaseStatement"; }
 
     NExpression *getValue() const { return value.get(); }
+    NExpression *getRangeEnd() const { return rangeEnd.get(); }
     bool getIsDefault() const { return isDefault; }
     NStatement *getStatements() const { return statements.get(); }
 
 private:
+    ExprCodegenResult evaluateLabel(ASTContext &context, NExpression *label);
+
     std::unique_ptr<NExpression> value;
+    std::unique_ptr<NExpression> rangeEnd;  // GNU `case lo ... hi:` upper bound
     std::unique_ptr<NStatement> statements;
     bool isDefault;
 
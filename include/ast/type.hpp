@@ -6,6 +6,7 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <ostream>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -73,6 +74,8 @@ public:
     uint8_t getQualifiers() const { return qualifiers; }
     bool isConst() const { return (qualifiers & QUAL_CONST) != 0; }
     bool isVolatile() const { return (qualifiers & QUAL_VOLATILE) != 0; }
+    bool isRestrict() const { return (qualifiers & QUAL_RESTRICT) != 0; }
+    bool isAtomic() const { return (qualifiers & QUAL_ATOMIC) != 0; }
 
 private:
     TypeIdx baseIdx;
@@ -91,36 +94,94 @@ private:
     int size;
 };
 
+// GCC vector extension type (vector_size): a fixed number of lanes of an arithmetic element type
+class VectorTypeCodegen : public TypeCodegen {
+public:
+    VectorTypeCodegen(TypeIdx elem, int lanes) : elementIdx(elem), lanes(lanes) {}
+    llvm::Type* getLLVMType(TypeManager& tm, llvm::LLVMContext& context, llvm::Module& module) override;
+    TypeIdx getElementIdx() const { return elementIdx; }
+    int getLaneCount() const { return lanes; }
+
+private:
+    TypeIdx elementIdx;
+    int lanes;
+};
+
 class StructTypeCodegen : public TypeCodegen {
 public:
     struct MemberInfo {
         std::string name;
         TypeIdx typeIdx;
+        uint64_t alignment = 0;  // aligned(N) on the field, 0 if absent
+        bool packed = false;     // packed on the field
+        int bitWidth = -1;       // width of a bit-field, -1 for an ordinary member
+    };
+
+    // The storage unit a bit-field is read and written through: byteOffset bytes into its LLVM element
+    struct BitFieldStorage {
+        unsigned byteOffset = 0;
+        BitFieldSlot slot;
     };
 
-    StructTypeCodegen(std::string name, NStructDeclaration* members);
+    // Element index of a member that occupies no storage (a zero-width bit-field)
+    static constexpr unsigned NoElement = ~0u;
+
+    StructTypeCodegen(std::string name, std::vector<MemberInfo> members);
     llvm::Type* getLLVMType(TypeManager& tm, llvm::LLVMContext& context, llvm::Module& module) override;
+    virtual bool isUnion() const { return false; }
     const std::string& getName() const { return name; }
+    // "union.U" for unions, so a struct and a union of the same tag get distinct LLVM types
+    std::string getLLVMName() const { return isUnion() ? "union." + name : name; }
     bool hasMembers() const { return !memberInfos.empty(); }
-    void setMembers(NStructDeclaration* m);
+    void setMembers(std::vector<MemberInfo> members);
     int getMemberIndex(const std::string& memberName) const;
     TypeIdx getMemberTypeIdx(int index) const;
-
-private:
+    size_t getMemberCount() const { return memberInfos.size(); }
+    const MemberInfo& getMember(int index) const { return memberInfos[index]; }
+    bool isBitField(int index) const { return memberInfos[index].bitWidth >= 0; }
+
+    // Layout attributes of the struct type itself
+    void setLayoutAttributes(bool packed, uint64_t alignment);
+    bool isPacked() const { return packed; }
+    uint64_t getRequestedAlignment() const { return requestedAlignment; }
+
+    // Valid once realized. A layout the target would not pick by itself (packed, over-aligned, with bit-fields) is
+    // emitted as an LLVM packed struct with explicit [N x i8] padding, so member and LLVM element indices can
+    // differ. Consecutive bit-fields share one [N x i8] element.
+    uint64_t getAlignment() const { return alignment; }
+    unsigned getElementIndex(int memberIndex) const;
+    int getMemberIndexForElement(unsigned elementIndex) const;
+    const BitFieldStorage& getBitFieldStorage(int memberIndex) const { return bitFieldStorage[memberIndex]; }
+
+protected:
     std::string name;
     std::vector<MemberInfo> memberInfos;
+    bool packed = false;
+    uint64_t requestedAlignment = 0;
+    uint64_t alignment = 1;
+    std::vector<unsigned> elementIndices;
+    std::vector<BitFieldStorage> bitFieldStorage;
+};
+
+// Every member of a union starts at offset 0. The LLVM type holds the first named member (so an initializer,
+// which sets that member, is a constant of the union's own type) padded out to the size of the largest one.
+class UnionTypeCodegen : public StructTypeCodegen {
+public:
+    using StructTypeCodegen::StructTypeCodegen;
+    llvm::Type* getLLVMType(TypeManager& tm, llvm::LLVMContext& context, llvm::Module& module) override;
+    bool isUnion() const override { return true; }
 };
 
 // ==================== TypeKey ====================
 
 struct TypeKey {
-    enum Kind { Primitive, Pointer, Array, Struct, Qualified } kind;
+    enum Kind { Primitive, Pointer, Array, Struct, Union, Qualified, Vector } kind;
     VarType varType = VAR_TYPE_VOID;      // Primitive only
     TypeIdx pointeeIdx = InvalidTypeIdx;  // Pointer only
     int level = 0;                        // Pointer only
-    TypeIdx elementIdx = InvalidTypeIdx;  // Array only
-    int size = 0;                         // Array only
-    std::string structName;               // Struct only
+    TypeIdx elementIdx = InvalidTypeIdx;  // Array and Vector only
+    int size = 0;                         // Array and Vector (lane count) only
+    std::string structName;               // Struct and Union only
     TypeIdx baseIdx = InvalidTypeIdx;     // Qualified only
     uint8_t qualifiers = QUAL_NONE;       // Qualified only
 
@@ -133,8 +194,10 @@ struct TypeKey {
             case Pointer:
                 return pointeeIdx == o.pointeeIdx && level == o.level;
             case Array:
+            case Vector:
                 return elementIdx == o.elementIdx && size == o.size;
             case Struct:
+            case Union:
                 return structName == o.structName;
             case Qualified:
                 return baseIdx == o.baseIdx && qualifiers == o.qualifiers;
@@ -159,10 +222,12 @@ struct TypeKeyHash {
                 h ^= std::hash<uint8_t>{}(k.qualifiers) << 2;
                 break;
             case TypeKey::Array:
+            case TypeKey::Vector:
                 h ^= std::hash<uint32_t>{}(k.elementIdx) << 1;
                 h ^= std::hash<int>{}(k.size) << 2;
                 break;
             case TypeKey::Struct:
+            case TypeKey::Union:
                 h ^= std::hash<std::string>{}(k.structName) << 1;
                 break;
         }
@@ -170,6 +235,28 @@ struct TypeKeyHash {
     }
 };
 
+// ==================== ArgumentPassing ====================
+// How a parameter or return value travels under the x86-64 System V calling convention. A struct or union of at
+// most 16 bytes with no misaligned field is split into eightbytes, each carried by one integer or SSE register;
+// a larger one goes in memory, copied by the caller (byval) or written through a hidden pointer (sret).
+
+struct ArgumentPassing {
+    enum Kind {
+        Direct,    // a scalar, passed as its own LLVM type
+        Coerced,   // a record carried in registers, one LLVM value per piece
+        Indirect,  // a record passed by address
+        Ignored    // an empty record, not passed at all
+    };
+    Kind kind = Direct;
+    std::vector<llvm::Type*> pieces;  // Coerced only: an iN, float, double or vector per eightbyte
+};
+
+// Argument registers left while a signature is classified from left to right
+struct ArgumentRegisters {
+    unsigned integer = 6;
+    unsigned sse = 8;
+};
+
 // ==================== TypeManager ====================
 
 class TypeManager {
@@ -185,12 +272,25 @@ public:
     TypeIdx getQualifiedIdx(TypeIdx base, uint8_t qualifiers);
     TypeIdx getArrayIdx(TypeIdx elem, std::vector<int> dims);
     TypeIdx getStructIdx(const std::string& name, NStructDeclaration* members);
+    TypeIdx getUnionIdx(const std::string& name, NStructDeclaration* members);
+    TypeIdx getVectorIdx(TypeIdx elem, int lanes);
+    void setStructLayoutAttributes(TypeIdx idx, bool packed, uint64_t alignment);
 
     // ==================== Type Info Access ====================
     bool isFloatingPointType(TypeIdx idx) const;
+    bool isIntegerType(TypeIdx idx) const;
+    bool isUnsignedType(TypeIdx idx) const;  // bool counts as unsigned
+    bool isSignedIntegerType(TypeIdx idx) const;
+    bool isVectorType(TypeIdx idx) const;
+    bool isRecordType(TypeIdx idx) const;  // struct or union
+    // Lane type of a vector, the (unqualified) type itself otherwise; like llvm::Type::getScalarType
+    TypeIdx getScalarTypeIdx(TypeIdx idx) const;
     bool isConstQualified(TypeIdx idx) const;
     bool isVolatileQualified(TypeIdx idx) const;
+    bool isRestrictQualified(TypeIdx idx) const;
+    bool isAtomicQualified(TypeIdx idx) const;
     TypeIdx unqualify(TypeIdx idx) const;
+    TypeIdx getDeclaratorType(TypeIdx baseIdx, const NDeclarator* declarator);
     ExprCodegenResult typeCast(llvm::Value* value, TypeIdx fromTypeIdx, TypeIdx toTypeIdx, llvm::IRBuilder<>& builder);
 
     // ==================== TypeCodegen Access ====================
@@ -200,20 +300,45 @@ public:
     llvm::Type* realize(TypeIdx idx);
 
     // ==================== TypeIdx-level helpers ====================
+    TypeIdx promoteInteger(TypeIdx idx);
     TypeIdx getCommonTypeIdx(TypeIdx a, TypeIdx b);
 
+    // ==================== Data layout ====================
+    // C alignment in bytes from the module's DataLayout, including aligned/packed attributes on structs
+    uint64_t getAlignment(TypeIdx idx);
+    const StructTypeCodegen* findStruct(llvm::StructType* structType) const;
+    // Size, member offsets, padding holes and cache-line crossings of every defined struct and union
+    void printStructLayouts(std::ostream& out);
+
+    // ==================== Calling convention ====================
+    // A record that needs more registers than are left is passed in memory instead, and takes none of them
+    ArgumentPassing classifyArgument(TypeIdx idx, ArgumentRegisters& registers);
+    ArgumentPassing classifyReturn(TypeIdx idx);
+
     // ==================== LLVM-level helpers (for codegen use) ====================
     std::string getTypeName(llvm::Type* type) const;
     llvm::Type* getCommonType(llvm::Type* type1, llvm::Type* type2);
 
+    // ==================== Type-based alias analysis ====================
+    // Access tag for a scalar load/store of accessIdx at address; a struct field address yields a
+    // struct-path tag. Returns nullptr for aggregate accesses.
+    llvm::MDNode* getTBAAAccessTag(TypeIdx accessIdx, llvm::Value* address);
+
 private:
     TypeIdx registerType(const TypeKey& key, std::unique_ptr<TypeCodegen> node);
+    TypeIdx getRecordIdx(TypeKey::Kind kind, const std::string& name, NStructDeclaration* members);
+    TypeIdx findRecordIdx(llvm::StructType* structType) const;
+    llvm::MDNode* getTBAATypeNode(TypeIdx idx);
 
     llvm::LLVMContext& context;
     llvm::Module& module;
 
     std::vector<std::unique_ptr<TypeCodegen>> types_;
     std::unordered_map<TypeKey, TypeIdx, TypeKeyHash> cache_;
+
+    // C-style TBAA tree: scalar and struct type descriptors below a single root, built on demand
+    llvm::MDNode* tbaaRoot_ = nullptr;
+    std::unordered_map<TypeIdx, llvm::MDNode*> tbaaTypeNodes_;
 };
 
 }  // namespace toyc::ast
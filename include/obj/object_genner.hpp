@@ -1,6 +1,10 @@
 #pragma once
 
 #include <llvm/IR/Module.h>
+#include <llvm/Target/TargetMachine.h>
+
+#include <memory>
+#include <string>
 
 namespace toyc::obj {
 
@@ -8,7 +12,15 @@ class ObjectGenner {
 public:
     ObjectGenner() = default;
 
-    bool generate(llvm::Module& module, const std::string& outputFileName);
+    // Sets the host triple and its data layout on the module, so sizes and offsets computed during codegen
+    // match the object file
+    static bool configureModule(llvm::Module& module);
+
+    // libraryBuiltins = false (-fno-builtin) stops the backend from treating libc functions as known builtins
+    bool generate(llvm::Module& module, const std::string& outputFileName, bool libraryBuiltins = true);
+
+private:
+    static std::unique_ptr<llvm::TargetMachine> createTargetMachine(const std::string& triple);
 };
 
 }  // namespace toyc::obj
@@ -36,6 +36,17 @@ public:
     ast::NFunctionDefinition* handleFunctionDeclaration(ast::TypeIdx returnTypeIdx, const std::string& name,
                                                         ast::NParameter* params, int line = 0, int column = 0);
 
+    ast::NExternalDeclaration* handleFunctionSpecifiers(ast::NExternalDeclaration* function,
+                                                        ast::StorageClass storageClass, bool isInline);
+
+    // GNU Attributes
+    ast::GnuAttribute* handleAttribute(const std::string& name, std::vector<std::string>* arguments);
+    ast::GnuAttributeList* handleAttributeList(ast::GnuAttributeList* list, ast::GnuAttribute* attribute);
+    ast::GnuAttributeList* handleAttributeSpecifiers(ast::GnuAttributeList* list, ast::GnuAttributeList* more);
+    ast::NExternalDeclaration* handleDeclarationAttributes(ast::NExternalDeclaration* declaration,
+                                                           ast::GnuAttributeList* attributes);
+    ast::NDeclarator* handleDeclaratorAttributes(ast::NDeclarator* declarator, ast::GnuAttributeList* attributes);
+
     // Parameters
     ast::NParameter* handleParameterList(ast::NParameter* current, ast::NParameter* next, int line = 0, int column = 0);
 
@@ -64,7 +75,7 @@ public:
     // Labeled Statements
     ast::NLabelStatement* handleLabelStatement(const std::string& label, ast::NStatement* statement);
 
-    ast::NCaseStatement* handleCaseStatement(ast::NExpression* value);
+    ast::NCaseStatement* handleCaseStatement(ast::NExpression* value, ast::NExpression* rangeEnd = nullptr);
     ast::NCaseStatement* handleDefaultStatement();
 
     // Jump Statements
@@ -73,11 +84,27 @@ public:
     ast::NBreakStatement* handleBreakStatement();
     ast::NContinueStatement* handleContinueStatement();
 
+    // GNU asm statements; the operand and clobber lists may be null when the section is empty
+    std::vector<ast::AsmOperand>* handleAsmOperand(std::vector<ast::AsmOperand>* list, const std::string& name,
+                                                   const std::string& constraint, ast::NExpression* expr);
+    ast::NAsmStatement* handleAsmStatement(bool isVolatile, const std::string& asmTemplate,
+                                           std::vector<ast::AsmOperand>* outputs, std::vector<ast::AsmOperand>* inputs,
+                                           std::vector<std::string>* clobbers);
+
+    // Loop pragmas: each PRAGMA token adds to the hints, which then apply to the loop statement after them
+    ast::LoopHints* handleLoopPragma(ast::LoopHints* hints, const std::string& pragma);
+    ast::NStatement* handleLoopHints(ast::LoopHints* hints, ast::NStatement* loop);
+
     // Declarations
-    ast::NDeclarationStatement* handleDeclarationStatement(ast::TypeIdx typeIdx, ast::NDeclarator* declarator);
+    ast::NDeclarationStatement* handleDeclarationStatement(ast::TypeIdx typeIdx, ast::NDeclarator* declarator,
+                                                           ast::StorageClass storageClass = ast::STORAGE_NONE,
+                                                           bool threadLocal = false);
 
     ast::NDeclarationStatement* handleEmptyDeclaration(ast::TypeIdx typeIdx);
 
+    // typedef: records each declarator's type under its name and declares nothing
+    ast::NDeclarationStatement* handleTypedef(ast::TypeIdx typeIdx, ast::NDeclarator* declarator);
+
     ast::NDeclarator* handleDeclaratorList(ast::NDeclarator* current, ast::NDeclarator* next);
 
     ast::NDeclarator* handleInitDeclarator(ast::NDeclarator* declarator, ast::NExpression* initializer = nullptr);
@@ -140,6 +167,10 @@ public:
     ast::TypeIdx handlePrimitiveType(const std::string& typeName);
     ast::TypeIdx handlePointerType(ast::TypeIdx baseTypeIdx, int pointerLevel);
     ast::TypeIdx handleQualifiedType(ast::TypeIdx baseTypeIdx, uint8_t qualifiers);
+    ast::TypeIdx handleTypedefName(const std::string& name);
+
+    // Consulted by the lexer, which returns TYPEDEF_NAME instead of IDENTIFIER for these
+    bool isTypedefName(const std::string& name) const { return typedefs_.count(name) > 0; }
 
     // Struct
     ast::NStructDeclaration* handleStructDeclaration(ast::TypeIdx typeIdx, ast::NDeclarator* declarator);
@@ -147,10 +178,17 @@ public:
     ast::NStructDeclaration* handleStructDeclarationList(ast::NStructDeclaration* current,
                                                          ast::NStructDeclaration* next);
 
-    ast::TypeIdx handleStructSpecifier(const std::string& name, ast::NStructDeclaration* declarations = nullptr);
+    // `declarator : width`, or an unnamed bit-field when declarator is null
+    ast::NDeclarator* handleBitField(ast::NDeclarator* declarator, ast::NExpression* width);
+
+    // isUnion selects `union` over `struct`; both share one tag syntax
+    ast::TypeIdx handleStructSpecifier(bool isUnion, const std::string& name,
+                                       ast::NStructDeclaration* declarations = nullptr,
+                                       ast::GnuAttributeList* attributes = nullptr);
 
-    ast::TypeIdx handleAnonymousStruct(ast::NStructDeclaration* declarations);
-    ast::TypeIdx handleStructReference(const std::string& name);
+    ast::TypeIdx handleAnonymousStruct(bool isUnion, ast::NStructDeclaration* declarations,
+                                       ast::GnuAttributeList* attributes = nullptr);
+    ast::TypeIdx handleStructReference(bool isUnion, const std::string& name);
 
     // Type name with pointer/array — return TypeIdx
     ast::TypeIdx handleTypeNameWithPointer(ast::TypeIdx baseTypeIdx, int pointerLevel);
@@ -166,7 +204,16 @@ public:
     void clearError() { errorOccurred = false; }
 
 private:
+    // aligned(N) and packed; anything else is reported and ignored
+    void parseLayoutAttributes(const ast::GnuAttributeList& attributes, const std::string& subject,
+                               uint64_t& alignment, bool& packed);
+
+    // The vector type vector_size(N) makes of typeIdx, or InvalidTypeIdx after reporting why it cannot
+    ast::TypeIdx getVectorTypeIdx(ast::TypeIdx typeIdx, uint64_t vectorSize, const std::string& name);
+
     ast::TypeManager* typeManager_;
+    // typedefs are file-scoped: a block-scope typedef stays visible after its block
+    std::unordered_map<std::string, ast::TypeIdx> typedefs_;
     bool errorOccurred;
 };
 
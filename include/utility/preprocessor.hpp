@@ -53,6 +53,7 @@ private:
     void handleElse(int lineNumber);
     void handleElif(const std::string& line, int lineNumber);
     void handleEndif(int lineNumber);
+    std::string handlePragma(const std::string& line, int lineNumber);
 
     // 條件編譯
     bool evaluateCondition(const std::string& condition);
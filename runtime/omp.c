@@ -0,0 +1,230 @@
+/*
+ * Work-sharing runtime for `#pragma omp parallel for`.
+ *
+ * toyc outlines the loop body into `void body(int64_t lower, int64_t upper, void *context)`, which runs
+ * iterations [lower, upper) of the loop, and calls __toyc_omp_parallel_for with the trip count. The calling
+ * thread and a pool of worker threads, started on first use, then share the iterations:
+ *
+ *   schedule(static)      each thread runs one contiguous block of iterations
+ *   schedule(static, N)   chunks of N iterations are dealt to the threads round-robin
+ *   schedule(dynamic, N)  each thread takes N iterations at a time from its own block; a thread whose block is
+ *                         empty steals the back half of another thread's remaining iterations
+ *
+ * The pool has one thread per online CPU unless TOYC_NUM_THREADS (or OMP_NUM_THREADS) says otherwise.
+ * A parallel loop reached from inside another one runs serially on the thread that reaches it.
+ */
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#define TOYC_OMP_STATIC 0
+#define TOYC_OMP_DYNAMIC 1
+#define TOYC_OMP_MAX_THREADS 256
+
+typedef void (*toyc_omp_body)(int64_t lower, int64_t upper, void *context);
+
+/* Iterations [next, end) not yet claimed from one thread's block; padded to keep each on its own cache line */
+struct toyc_omp_range {
+    pthread_mutex_t lock;
+    int64_t next;
+    int64_t end;
+    char padding[64];
+};
+
+static struct {
+    pthread_once_t once;
+    int threads;
+    struct toyc_omp_range ranges[TOYC_OMP_MAX_THREADS];
+
+    /* Workers sleep on start until generation changes; the caller waits on done until running drops to 0 */
+    pthread_mutex_t lock;
+    pthread_cond_t start;
+    pthread_cond_t done;
+    unsigned generation;
+    int running;
+
+    /* The loop being run */
+    toyc_omp_body body;
+    void *context;
+    int schedule;
+    int64_t chunk;
+    int64_t count;
+} pool = {.once = PTHREAD_ONCE_INIT,
+          .threads = 1,
+          .lock = PTHREAD_MUTEX_INITIALIZER,
+          .start = PTHREAD_COND_INITIALIZER,
+          .done = PTHREAD_COND_INITIALIZER};
+
+static pthread_mutex_t launch_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t reduction_lock = PTHREAD_MUTEX_INITIALIZER;
+static __thread int in_parallel;
+
+/* Claims up to chunk iterations from the front of a range */
+static int take(struct toyc_omp_range *range, int64_t chunk, int64_t *lower, int64_t *upper) {
+    int found = 0;
+    pthread_mutex_lock(&range->lock);
+    if (range->next < range->end) {
+        *lower = range->next;
+        *upper = range->end - range->next > chunk ? range->next + chunk : range->end;
+        range->next = *upper;
+        found = 1;
+    }
+    pthread_mutex_unlock(&range->lock);
+    return found;
+}
+
+/* Moves the back half of the next non-empty range after the thief's into the thief's own, now empty, range */
+static int steal(int thief) {
+    for (int offset = 1; offset < pool.threads; ++offset) {
+        struct toyc_omp_range *victim = &pool.ranges[(thief + offset) % pool.threads];
+        int64_t lower = 0;
+        int64_t upper = 0;
+        pthread_mutex_lock(&victim->lock);
+        int64_t remaining = victim->end - victim->next;
+        if (remaining > 0) {
+            upper = victim->end;
+            lower = victim->end - (remaining + 1) / 2;
+            victim->end = lower;
+        }
+        pthread_mutex_unlock(&victim->lock);
+
+        if (lower < upper) {
+            struct toyc_omp_range *own = &pool.ranges[thief];
+            pthread_mutex_lock(&own->lock);
+            own->next = lower;
+            own->end = upper;
+            pthread_mutex_unlock(&own->lock);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void run_share(int id) {
+    int64_t lower = 0;
+    int64_t upper = 0;
+    if (TOYC_OMP_STATIC == pool.schedule && pool.chunk > 0) {
+        int64_t stride = pool.chunk * pool.threads;
+        for (lower = pool.chunk * id; lower < pool.count; lower += stride) {
+            upper = pool.count - lower > pool.chunk ? lower + pool.chunk : pool.count;
+            pool.body(lower, upper, pool.context);
+        }
+        return;
+    }
+
+    struct toyc_omp_range *own = &pool.ranges[id];
+    if (TOYC_OMP_STATIC == pool.schedule) {
+        if (take(own, INT64_MAX, &lower, &upper)) {
+            pool.body(lower, upper, pool.context);
+        }
+        return;
+    }
+    int64_t chunk = pool.chunk > 0 ? pool.chunk : 1;
+    for (;;) {
+        while (take(own, chunk, &lower, &upper)) {
+            pool.body(lower, upper, pool.context);
+        }
+        if (0 == steal(id)) {
+            return;
+        }
+    }
+}
+
+static void *worker(void *argument) {
+    int id = (int)(intptr_t)argument;
+    unsigned seen = 0;
+    in_parallel = 1;
+
+    pthread_mutex_lock(&pool.lock);
+    for (;;) {
+        while (seen == pool.generation) {
+            pthread_cond_wait(&pool.start, &pool.lock);
+        }
+        seen = pool.generation;
+        pthread_mutex_unlock(&pool.lock);
+
+        run_share(id);
+
+        pthread_mutex_lock(&pool.lock);
+        if (0 == --pool.running) {
+            pthread_cond_signal(&pool.done);
+        }
+    }
+    return NULL;
+}
+
+static int requested_threads(void) {
+    const char *names[] = {"TOYC_NUM_THREADS", "OMP_NUM_THREADS"};
+    for (int i = 0; i < 2; ++i) {
+        const char *value = getenv(names[i]);
+        if (NULL != value && atoi(value) > 0) {
+            return atoi(value);
+        }
+    }
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    return online > 0 ? (int)online : 1;
+}
+
+static void start_pool(void) {
+    int threads = requested_threads();
+    pool.threads = threads > TOYC_OMP_MAX_THREADS ? TOYC_OMP_MAX_THREADS : threads;
+    for (int id = 0; id < pool.threads; ++id) {
+        pthread_mutex_init(&pool.ranges[id].lock, NULL);
+    }
+    for (int id = 1; id < pool.threads; ++id) {
+        pthread_t thread;
+        if (0 != pthread_create(&thread, NULL, worker, (void *)(intptr_t)id)) {
+            pool.threads = id; /* run with the workers that did start */
+            break;
+        }
+        pthread_detach(thread);
+    }
+}
+
+void __toyc_omp_parallel_for(int64_t count, int32_t schedule, int64_t chunk, toyc_omp_body body, void *context) {
+    if (count <= 0) {
+        return;
+    }
+    pthread_once(&pool.once, start_pool);
+    if (1 == pool.threads || in_parallel || 0 != pthread_mutex_trylock(&launch_lock)) {
+        body(0, count, context);
+        return;
+    }
+
+    /* Contiguous blocks, the first count % threads of them one iteration longer */
+    int64_t block = count / pool.threads;
+    int64_t extra = count % pool.threads;
+    for (int id = 0; id < pool.threads; ++id) {
+        pool.ranges[id].next = block * id + (id < extra ? id : extra);
+        pool.ranges[id].end = pool.ranges[id].next + block + (id < extra ? 1 : 0);
+    }
+
+    pthread_mutex_lock(&pool.lock);
+    pool.body = body;
+    pool.context = context;
+    pool.schedule = schedule;
+    pool.chunk = chunk;
+    pool.count = count;
+    pool.running = pool.threads - 1;
+    ++pool.generation;
+    pthread_cond_broadcast(&pool.start);
+    pthread_mutex_unlock(&pool.lock);
+
+    in_parallel = 1;
+    run_share(0);
+    in_parallel = 0;
+
+    pthread_mutex_lock(&pool.lock);
+    while (pool.running > 0) {
+        pthread_cond_wait(&pool.done, &pool.lock);
+    }
+    pthread_mutex_unlock(&pool.lock);
+    pthread_mutex_unlock(&launch_lock);
+}
+
+/* Brackets the merge of one thread's reduction copies into the shared variables */
+void __toyc_omp_reduce_begin(void) { pthread_mutex_lock(&reduction_lock); }
+
+void __toyc_omp_reduce_end(void) { pthread_mutex_unlock(&reduction_lock); }
@@ -0,0 +1,614 @@
+#include "ast/builtin.hpp"
+
+#include <llvm/IR/Intrinsics.h>
+
+#include <vector>
+
+namespace toyc::ast {
+
+namespace {
+
+// Generate every argument of a builtin call after checking the argument count
+CodegenResult<void> codegenArguments(ASTContext &context, const std::string &name, NArguments *args, size_t minCount,
+                                     size_t maxCount, std::vector<ExprCodegenResult> &operands) {
+    for (NArguments *arg = args; nullptr != arg; arg = arg->next.get()) {
+        ExprCodegenResult argResult = arg->codegen(context);
+        if (false == argResult.isSuccess()) {
+            return CodegenResult<void>("Argument code generation failed for builtin: " + name) << argResult;
+        }
+        operands.push_back(argResult);
+    }
+    if (operands.size() < minCount || operands.size() > maxCount) {
+        return CodegenResult<void>("Wrong number of arguments to builtin: " + name);
+    }
+    return CodegenResult<void>();
+}
+
+// Convert a builtin argument to one of the builtin's parameter types
+llvm::Value *castOperand(ASTContext &context, const ExprCodegenResult &operand, VarType varType) {
+    TypeIdx targetIdx = context.typeManager->getPrimitiveIdx(varType);
+    ExprCodegenResult castResult =
+        context.typeManager->typeCast(operand.getValue(), operand.getType(), targetIdx, context.builder);
+    return castResult.isSuccess() ? castResult.getValue() : nullptr;
+}
+
+// A builtin argument the caller must spell as an integer constant expression
+llvm::ConstantInt *constantOperand(ASTContext &context, const ExprCodegenResult &operand) {
+    return llvm::dyn_cast_or_null<llvm::ConstantInt>(castOperand(context, operand, VAR_TYPE_INT));
+}
+
+TypeIdx voidPointerIdx(ASTContext &context) {
+    return context.typeManager->getPointerIdx(context.typeManager->getPrimitiveIdx(VAR_TYPE_VOID), 1);
+}
+
+// long __builtin_expect(long exp, long c): the value of exp, which is most likely c. The llvm.expect call is
+// folded into !prof branch weights on the branch or switch that tests it once the function is complete.
+ExprCodegenResult lowerExpect(ASTContext &context, const std::string &name, NArguments *args) {
+    std::vector<ExprCodegenResult> operands;
+    CodegenResult<void> argsResult = codegenArguments(context, name, args, 2, 2, operands);
+    if (false == argsResult.isSuccess()) {
+        return ExprCodegenResult("Invalid call to builtin: " + name) << argsResult;
+    }
+    llvm::Value *value = castOperand(context, operands[0], VAR_TYPE_LONG);
+    llvm::Value *expected = castOperand(context, operands[1], VAR_TYPE_LONG);
+    if (nullptr == value || nullptr == expected) {
+        return ExprCodegenResult("Type cast failed for argument to builtin: " + name);
+    }
+    TypeIdx longIdx = context.typeManager->getPrimitiveIdx(VAR_TYPE_LONG);
+    // Like GCC, a run-time expectation is accepted but carries no hint
+    if (false == llvm::isa<llvm::ConstantInt>(expected)) {
+        return ExprCodegenResult(value, longIdx);
+    }
+    llvm::Function *expect =
+        llvm::Intrinsic::getDeclaration(&context.module, llvm::Intrinsic::expect, {value->getType()});
+    return ExprCodegenResult(context.builder.CreateCall(expect, {value, expected}, "expect"), longIdx);
+}
+
+// void __builtin_unreachable(void): control never gets here
+ExprCodegenResult lowerUnreachable(ASTContext &context, const std::string &name, NArguments *args) {
+    std::vector<ExprCodegenResult> operands;
+    CodegenResult<void> argsResult = codegenArguments(context, name, args, 0, 0, operands);
+    if (false == argsResult.isSuccess()) {
+        return ExprCodegenResult("Invalid call to builtin: " + name) << argsResult;
+    }
+    llvm::UnreachableInst *unreachable = context.builder.CreateUnreachable();
+    // Statements that follow the call are dead, but still need a block to be emitted into
+    llvm::BasicBlock *deadBlock = llvm::BasicBlock::Create(context.llvmContext, "after_unreachable",
+                                                           context.builder.GetInsertBlock()->getParent());
+    context.builder.SetInsertPoint(deadBlock);
+    return ExprCodegenResult(unreachable, context.typeManager->getPrimitiveIdx(VAR_TYPE_VOID));
+}
+
+// void *__builtin_assume_aligned(const void *p, size_t align, ...): p, which the caller promises is aligned
+// to align bytes (after subtracting the optional misalignment offset)
+ExprCodegenResult lowerAssumeAligned(ASTContext &context, const std::string &name, NArguments *args) {
+    std::vector<ExprCodegenResult> operands;
+    CodegenResult<void> argsResult = codegenArguments(context, name, args, 2, 3, operands);
+    if (false == argsResult.isSuccess()) {
+        return ExprCodegenResult("Invalid call to builtin: " + name) << argsResult;
+    }
+    llvm::Value *pointer = operands[0].getValue();
+    if (false == pointer->getType()->isPointerTy()) {
+        return ExprCodegenResult("First argument to " + name + " must be a pointer");
+    }
+    llvm::ConstantInt *alignment = constantOperand(context, operands[1]);
+    if (nullptr == alignment || false == alignment->getValue().isPowerOf2()) {
+        return ExprCodegenResult("Second argument to " + name + " must be a constant power of two");
+    }
+    llvm::Value *offset = nullptr;
+    if (3 == operands.size()) {
+        offset = castOperand(context, operands[2], VAR_TYPE_LONG);
+        if (nullptr == offset) {
+            return ExprCodegenResult("Type cast failed for argument to builtin: " + name);
+        }
+    }
+    context.builder.CreateAlignmentAssumption(context.module.getDataLayout(), pointer,
+                                              static_cast<unsigned>(alignment->getZExtValue()), offset);
+    return ExprCodegenResult(pointer, voidPointerIdx(context));
+}
+
+// void __builtin_prefetch(const void *addr, int rw = 0, int locality = 3): fetch addr into the cache ahead of
+// a read (rw 0) or write (rw 1), keeping it from no temporal locality (0) to as close as possible (3)
+ExprCodegenResult lowerPrefetch(ASTContext &context, const std::string &name, NArguments *args) {
+    std::vector<ExprCodegenResult> operands;
+    CodegenResult<void> argsResult = codegenArguments(context, name, args, 1, 3, operands);
+    if (false == argsResult.isSuccess()) {
+        return ExprCodegenResult("Invalid call to builtin: " + name) << argsResult;
+    }
+    llvm::Value *address = operands[0].getValue();
+    if (false == address->getType()->isPointerTy()) {
+        return ExprCodegenResult("First argument to " + name + " must be a pointer");
+    }
+    llvm::ConstantInt *rw = context.builder.getInt32(0);
+    llvm::ConstantInt *locality = context.builder.getInt32(3);
+    if (operands.size() > 1) {
+        rw = constantOperand(context, operands[1]);
+        if (nullptr == rw || rw->getZExtValue() > 1) {
+            return ExprCodegenResult("Second argument to " + name + " must be the constant 0 or 1");
+        }
+    }
+    if (operands.size() > 2) {
+        locality = constantOperand(context, operands[2]);
+        if (nullptr == locality || locality->getZExtValue() > 3) {
+            return ExprCodegenResult("Third argument to " + name + " must be a constant between 0 and 3");
+        }
+    }
+    llvm::Function *prefetch =
+        llvm::Intrinsic::getDeclaration(&context.module, llvm::Intrinsic::prefetch, {address->getType()});
+    llvm::Value *dataCache = context.builder.getInt32(1);
+    llvm::CallInst *call = context.builder.CreateCall(prefetch, {address, rw, locality, dataCache});
+    return ExprCodegenResult(call, context.typeManager->getPrimitiveIdx(VAR_TYPE_VOID));
+}
+
+// void *memcpy(void *dst, const void *src, size_t n) and memmove: dst. A fixed-size llvm.memcpy is
+// expanded inline by the optimizer and the backend instead of calling the library.
+BuiltinRegistry::Lowering makeMemoryTransfer(bool mayOverlap) {
+    return [mayOverlap](ASTContext &context, const std::string &name, NArguments *args) {
+        std::vector<ExprCodegenResult> operands;
+        CodegenResult<void> argsResult = codegenArguments(context, name, args, 3, 3, operands);
+        if (false == argsResult.isSuccess()) {
+            return ExprCodegenResult("Invalid call to builtin: " + name) << argsResult;
+        }
+        llvm::Value *destination = operands[0].getValue();
+        llvm::Value *source = operands[1].getValue();
+        llvm::Value *size = castOperand(context, operands[2], VAR_TYPE_ULONG);
+        if (false == destination->getType()->isPointerTy() || false == source->getType()->isPointerTy() ||
+            nullptr == size) {
+            return ExprCodegenResult("Invalid arguments to builtin: " + name);
+        }
+        if (true == mayOverlap) {
+            context.builder.CreateMemMove(destination, llvm::MaybeAlign(), source, llvm::MaybeAlign(), size);
+        } else {
+            context.builder.CreateMemCpy(destination, llvm::MaybeAlign(), source, llvm::MaybeAlign(), size);
+        }
+        return ExprCodegenResult(destination, voidPointerIdx(context));
+    };
+}
+
+// void *memset(void *dst, int c, size_t n): dst
+ExprCodegenResult lowerMemset(ASTContext &context, const std::string &name, NArguments *args) {
+    std::vector<ExprCodegenResult> operands;
+    CodegenResult<void> argsResult = codegenArguments(context, name, args, 3, 3, operands);
+    if (false == argsResult.isSuccess()) {
+        return ExprCodegenResult("Invalid call to builtin: " + name) << argsResult;
+    }
+    llvm::Value *destination = operands[0].getValue();
+    llvm::Value *value = castOperand(context, operands[1], VAR_TYPE_CHAR);
+    llvm::Value *size = castOperand(context, operands[2], VAR_TYPE_ULONG);
+    if (false == destination->getType()->isPointerTy() || nullptr == value || nullptr == size) {
+        return ExprCodegenResult("Invalid arguments to builtin: " + name);
+    }
+    context.builder.CreateMemSet(destination, value, size, llvm::MaybeAlign());
+    return ExprCodegenResult(destination, voidPointerIdx(context));
+}
+
+// A libm function of floating-point arguments that has an exact llvm.* counterpart, e.g. fmin to minnum.
+// llvm.sqrt does not set errno, so sqrt is only lowered like this under -fno-math-errno.
+BuiltinRegistry::Lowering makeMathIntrinsic(llvm::Intrinsic::ID intrinsic, VarType varType, size_t arity) {
+    return [intrinsic, varType, arity](ASTContext &context, const std::string &name, NArguments *args) {
+        std::vector<ExprCodegenResult> operands;
+        CodegenResult<void> argsResult = codegenArguments(context, name, args, arity, arity, operands);
+        if (false == argsResult.isSuccess()) {
+            return ExprCodegenResult("Invalid call to builtin: " + name) << argsResult;
+        }
+        std::vector<llvm::Value *> values;
+        for (const ExprCodegenResult &operand : operands) {
+            llvm::Value *value = castOperand(context, operand, varType);
+            if (nullptr == value) {
+                return ExprCodegenResult("Type cast failed for argument to builtin: " + name);
+            }
+            values.push_back(value);
+        }
+        llvm::Function *function =
+            llvm::Intrinsic::getDeclaration(&context.module, intrinsic, {values[0]->getType()});
+        return ExprCodegenResult(context.builder.CreateCall(function, values, name),
+                                 context.typeManager->getPrimitiveIdx(varType));
+    };
+}
+
+// Memory order argument of an __atomic builtin, __ATOMIC_RELAXED (0) to __ATOMIC_SEQ_CST (5). As in GCC, an
+// order that is not a constant or not in that range is treated as seq_cst, and so is consume as acquire.
+llvm::AtomicOrdering memoryOrder(ASTContext &context, const ExprCodegenResult &operand) {
+    llvm::ConstantInt *order = constantOperand(context, operand);
+    switch (nullptr == order ? 5 : order->getZExtValue()) {
+        case 0:
+            return llvm::AtomicOrdering::Monotonic;
+        case 1:
+        case 2:
+            return llvm::AtomicOrdering::Acquire;
+        case 3:
+            return llvm::AtomicOrdering::Release;
+        case 4:
+            return llvm::AtomicOrdering::AcquireRelease;
+        default:
+            return llvm::AtomicOrdering::SequentiallyConsistent;
+    }
+}
+
+// The object an __atomic/__sync builtin operates on, which its first argument points to: an integer at least a
+// byte wide or, when allowPointer, a pointer. Returns the object's unqualified type, InvalidTypeIdx otherwise.
+TypeIdx atomicObjectType(ASTContext &context, const ExprCodegenResult &pointer, bool allowPointer) {
+    TypeIdx pointerIdx = context.typeManager->unqualify(pointer.getType());
+    auto *pointerTc = dynamic_cast<const PointerTypeCodegen *>(context.typeManager->get(pointerIdx));
+    if (nullptr == pointerTc) {
+        return InvalidTypeIdx;
+    }
+    TypeIdx objectIdx = context.typeManager->unqualify(pointerTc->getPointeeIdx());
+    llvm::Type *objectType = context.typeManager->realize(objectIdx);
+    if ((objectType->isIntegerTy() && objectType->getIntegerBitWidth() >= 8) ||
+        (true == allowPointer && objectType->isPointerTy())) {
+        return objectIdx;
+    }
+    return InvalidTypeIdx;
+}
+
+// Convert a builtin argument to the type of the atomic object
+llvm::Value *convertOperand(ASTContext &context, const ExprCodegenResult &operand, TypeIdx objectIdx) {
+    ExprCodegenResult castResult =
+        context.typeManager->typeCast(operand.getValue(), operand.getType(), objectIdx, context.builder);
+    return castResult.isSuccess() ? castResult.getValue() : nullptr;
+}
+
+// T __atomic_load_n(T *p, int order). Release orders are not valid on a load and fall back to seq_cst.
+ExprCodegenResult lowerAtomicLoad(ASTContext &context, const std::string &name, NArguments *args) {
+    std::vector<ExprCodegenResult> operands;
+    CodegenResult<void> argsResult = codegenArguments(context, name, args, 2, 2, operands);
+    if (false == argsResult.isSuccess()) {
+        return ExprCodegenResult("Invalid call to builtin: " + name) << argsResult;
+    }
+    TypeIdx objectIdx = atomicObjectType(context, operands[0], true);
+    if (InvalidTypeIdx == objectIdx) {
+        return ExprCodegenResult("First argument to " + name + " must point to an integer or pointer");
+    }
+    llvm::AtomicOrdering order = memoryOrder(context, operands[1]);
+    if (llvm::AtomicOrdering::Release == order || llvm::AtomicOrdering::AcquireRelease == order) {
+        order = llvm::AtomicOrdering::SequentiallyConsistent;
+    }
+    llvm::LoadInst *load =
+        context.builder.CreateLoad(context.typeManager->realize(objectIdx), operands[0].getValue(), "atomic_load");
+    load->setAtomic(order);
+    return ExprCodegenResult(load, objectIdx);
+}
+
+// void __atomic_store_n(T *p, T value, int order). Acquire orders are not valid on a store and fall back to
+// seq_cst.
+ExprCodegenResult lowerAtomicStore(ASTContext &context, const std::string &name, NArguments *args) {
+    std::vector<ExprCodegenResult> operands;
+    CodegenResult<void> argsResult = codegenArguments(context, name, args, 3, 3, operands);
+    if (false == argsResult.isSuccess()) {
+        return ExprCodegenResult("Invalid call to builtin: " + name) << argsResult;
+    }
+    TypeIdx objectIdx = atomicObjectType(context, operands[0], true);
+    if (InvalidTypeIdx == objectIdx) {
+        return ExprCodegenResult("First argument to " + name + " must point to an integer or pointer");
+    }
+    llvm::Value *value = convertOperand(context, operands[1], objectIdx);
+    if (nullptr == value) {
+        return ExprCodegenResult("Type cast failed for argument to builtin: " + name);
+    }
+    llvm::AtomicOrdering order = memoryOrder(context, operands[2]);
+    if (llvm::AtomicOrdering::Acquire == order || llvm::AtomicOrdering::AcquireRelease == order) {
+        order = llvm::AtomicOrdering::SequentiallyConsistent;
+    }
+    llvm::StoreInst *store = context.builder.CreateStore(value, operands[0].getValue());
+    store->setAtomic(order);
+    return ExprCodegenResult(store, context.typeManager->getPrimitiveIdx(VAR_TYPE_VOID));
+}
+
+// One atomicrmw on *p: the __atomic_exchange_n, __atomic_fetch_op/__atomic_op_fetch and __sync_fetch_and_op/
+// __sync_op_and_fetch families. The __atomic forms take a trailing memory order, the __sync ones are seq_cst.
+// returnNew gives the value stored, recomputed from the old one, instead of the old value.
+BuiltinRegistry::Lowering makeAtomicRMW(llvm::AtomicRMWInst::BinOp operation, bool returnNew, bool takesOrder) {
+    return [operation, returnNew, takesOrder](ASTContext &context, const std::string &name, NArguments *args) {
+        std::vector<ExprCodegenResult> operands;
+        size_t count = true == takesOrder ? 3 : 2;
+        CodegenResult<void> argsResult = codegenArguments(context, name, args, count, count, operands);
+        if (false == argsResult.isSuccess()) {
+            return ExprCodegenResult("Invalid call to builtin: " + name) << argsResult;
+        }
+        TypeIdx objectIdx = atomicObjectType(context, operands[0], false);
+        if (InvalidTypeIdx == objectIdx) {
+            return ExprCodegenResult("First argument to " + name + " must point to an integer");
+        }
+        llvm::Value *value = convertOperand(context, operands[1], objectIdx);
+        if (nullptr == value) {
+            return ExprCodegenResult("Type cast failed for argument to builtin: " + name);
+        }
+        llvm::AtomicOrdering order = true == takesOrder ? memoryOrder(context, operands[2])
+                                                        : llvm::AtomicOrdering::SequentiallyConsistent;
+        // __sync_lock_test_and_set is only an acquire barrier
+        if (false == takesOrder && llvm::AtomicRMWInst::Xchg == operation) {
+            order = llvm::AtomicOrdering::Acquire;
+        }
+        llvm::Value *old =
+            context.builder.CreateAtomicRMW(operation, operands[0].getValue(), value, llvm::MaybeAlign(), order);
+        if (false == returnNew) {
+            return ExprCodegenResult(old, objectIdx);
+        }
+        llvm::Value *result = nullptr;
+        switch (operation) {
+            case llvm::AtomicRMWInst::Add:
+                result = context.builder.CreateAdd(old, value);
+                break;
+            case llvm::AtomicRMWInst::Sub:
+                result = context.builder.CreateSub(old, value);
+                break;
+            case llvm::AtomicRMWInst::And:
+                result = context.builder.CreateAnd(old, value);
+                break;
+            case llvm::AtomicRMWInst::Or:
+                result = context.builder.CreateOr(old, value);
+                break;
+            case llvm::AtomicRMWInst::Xor:
+                result = context.builder.CreateXor(old, value);
+                break;
+            default:
+                result = context.builder.CreateNot(context.builder.CreateAnd(old, value));
+                break;
+        }
+        return ExprCodegenResult(result, objectIdx);
+    };
+}
+
+// bool __atomic_compare_exchange_n(T *p, T *expected, T desired, bool weak, int success, int failure): stores
+// desired into *p if it holds *expected, and otherwise copies *p into *expected. The failure order cannot
+// release, so release weakens to relaxed and acq_rel to acquire.
+ExprCodegenResult lowerAtomicCompareExchange(ASTContext &context, const std::string &name, NArguments *args) {
+    std::vector<ExprCodegenResult> operands;
+    CodegenResult<void> argsResult = codegenArguments(context, name, args, 6, 6, operands);
+    if (false == argsResult.isSuccess()) {
+        return ExprCodegenResult("Invalid call to builtin: " + name) << argsResult;
+    }
+    TypeIdx objectIdx = atomicObjectType(context, operands[0], true);
+    if (InvalidTypeIdx == objectIdx || InvalidTypeIdx == atomicObjectType(context, operands[1], true)) {
+        return ExprCodegenResult("First two arguments to " + name + " must point to an integer or pointer");
+    }
+    llvm::Value *desired = convertOperand(context, operands[2], objectIdx);
+    llvm::ConstantInt *weak = constantOperand(context, operands[3]);
+    if (nullptr == desired) {
+        return ExprCodegenResult("Type cast failed for argument to builtin: " + name);
+    }
+    llvm::AtomicOrdering successOrder = memoryOrder(context, operands[4]);
+    llvm::AtomicOrdering failureOrder = memoryOrder(context, operands[5]);
+    if (llvm::AtomicOrdering::Release == failureOrder) {
+        failureOrder = llvm::AtomicOrdering::Monotonic;
+    } else if (llvm::AtomicOrdering::AcquireRelease == failureOrder) {
+        failureOrder = llvm::AtomicOrdering::Acquire;
+    }
+
+    llvm::Type *objectType = context.typeManager->realize(objectIdx);
+    llvm::Value *expectedPointer = operands[1].getValue();
+    llvm::Value *expected = context.builder.CreateLoad(objectType, expectedPointer, "expected");
+    llvm::AtomicCmpXchgInst *exchange = context.builder.CreateAtomicCmpXchg(
+        operands[0].getValue(), expected, desired, llvm::MaybeAlign(), successOrder, failureOrder);
+    // A weak exchange may fail spuriously, which lets LL/SC targets skip the retry loop
+    exchange->setWeak(nullptr != weak && false == weak->isZero());
+    llvm::Value *success = context.builder.CreateExtractValue(exchange, 1, "success");
+
+    llvm::Function *function = context.builder.GetInsertBlock()->getParent();
+    llvm::BasicBlock *failedBlock = llvm::BasicBlock::Create(context.llvmContext, "cmpxchg_failed", function);
+    llvm::BasicBlock *doneBlock = llvm::BasicBlock::Create(context.llvmContext, "cmpxchg_done", function);
+    context.builder.CreateCondBr(success, doneBlock, failedBlock);
+    context.builder.SetInsertPoint(failedBlock);
+    context.builder.CreateStore(context.builder.CreateExtractValue(exchange, 0), expectedPointer);
+    context.builder.CreateBr(doneBlock);
+    context.builder.SetInsertPoint(doneBlock);
+    return ExprCodegenResult(success, context.typeManager->getPrimitiveIdx(VAR_TYPE_BOOL));
+}
+
+// bool __sync_bool_compare_and_swap(T *p, T old, T new) and T __sync_val_compare_and_swap(T *p, T old, T new):
+// a seq_cst exchange of new for old, returning whether it happened or the value *p held
+BuiltinRegistry::Lowering makeSyncCompareAndSwap(bool returnValue) {
+    return [returnValue](ASTContext &context, const std::string &name, NArguments *args) {
+        std::vector<ExprCodegenResult> operands;
+        CodegenResult<void> argsResult = codegenArguments(context, name, args, 3, 3, operands);
+        if (false == argsResult.isSuccess()) {
+            return ExprCodegenResult("Invalid call to builtin: " + name) << argsResult;
+        }
+        TypeIdx objectIdx = atomicObjectType(context, operands[0], true);
+        if (InvalidTypeIdx == objectIdx) {
+            return ExprCodegenResult("First argument to " + name + " must point to an integer or pointer");
+        }
+        llvm::Value *expected = convertOperand(context, operands[1], objectIdx);
+        llvm::Value *desired = convertOperand(context, operands[2], objectIdx);
+        if (nullptr == expected || nullptr == desired) {
+            return ExprCodegenResult("Type cast failed for argument to builtin: " + name);
+        }
+        llvm::AtomicCmpXchgInst *exchange = context.builder.CreateAtomicCmpXchg(
+            operands[0].getValue(), expected, desired, llvm::MaybeAlign(),
+            llvm::AtomicOrdering::SequentiallyConsistent, llvm::AtomicOrdering::SequentiallyConsistent);
+        if (true == returnValue) {
+            return ExprCodegenResult(context.builder.CreateExtractValue(exchange, 0), objectIdx);
+        }
+        return ExprCodegenResult(context.builder.CreateExtractValue(exchange, 1),
+                                 context.typeManager->getPrimitiveIdx(VAR_TYPE_BOOL));
+    };
+}
+
+// void __sync_lock_release(T *p): stores 0 into *p with release semantics, undoing __sync_lock_test_and_set
+ExprCodegenResult lowerSyncLockRelease(ASTContext &context, const std::string &name, NArguments *args) {
+    std::vector<ExprCodegenResult> operands;
+    CodegenResult<void> argsResult = codegenArguments(context, name, args, 1, 1, operands);
+    if (false == argsResult.isSuccess()) {
+        return ExprCodegenResult("Invalid call to builtin: " + name) << argsResult;
+    }
+    TypeIdx objectIdx = atomicObjectType(context, operands[0], false);
+    if (InvalidTypeIdx == objectIdx) {
+        return ExprCodegenResult("First argument to " + name + " must point to an integer");
+    }
+    llvm::StoreInst *store = context.builder.CreateStore(
+        llvm::ConstantInt::get(context.typeManager->realize(objectIdx), 0), operands[0].getValue());
+    store->setAtomic(llvm::AtomicOrdering::Release);
+    return ExprCodegenResult(store, context.typeManager->getPrimitiveIdx(VAR_TYPE_VOID));
+}
+
+// void __atomic_thread_fence(int order), __atomic_signal_fence(int order) and __sync_synchronize(void). A
+// signal fence only orders against a handler running on the same thread, and a relaxed fence is a no-op.
+BuiltinRegistry::Lowering makeFence(bool signalOnly, bool takesOrder) {
+    return [signalOnly, takesOrder](ASTContext &context, const std::string &name, NArguments *args) {
+        std::vector<ExprCodegenResult> operands;
+        size_t count = true == takesOrder ? 1 : 0;
+        CodegenResult<void> argsResult = codegenArguments(context, name, args, count, count, operands);
+        if (false == argsResult.isSuccess()) {
+            return ExprCodegenResult("Invalid call to builtin: " + name) << argsResult;
+        }
+        TypeIdx voidIdx = context.typeManager->getPrimitiveIdx(VAR_TYPE_VOID);
+        llvm::AtomicOrdering order = true == takesOrder ? memoryOrder(context, operands[0])
+                                                        : llvm::AtomicOrdering::SequentiallyConsistent;
+        // Nothing to emit; the order argument stands in as the value of the void call
+        if (llvm::AtomicOrdering::Monotonic == order) {
+            return ExprCodegenResult(operands[0].getValue(), voidIdx);
+        }
+        llvm::FenceInst *fence = context.builder.CreateFence(
+            order, true == signalOnly ? llvm::SyncScope::SingleThread : llvm::SyncScope::System);
+        return ExprCodegenResult(fence, voidIdx);
+    };
+}
+
+// void __builtin_cpu_init(void): detect the running CPU; only needed before constructors have run
+ExprCodegenResult lowerCpuInit(ASTContext &context, const std::string &name, NArguments *args) {
+    if (nullptr != args) {
+        return ExprCodegenResult("Wrong number of arguments to builtin: " + name);
+    }
+    return ExprCodegenResult(emitCpuInit(context), context.typeManager->getPrimitiveIdx(VAR_TYPE_VOID));
+}
+
+// int __builtin_cpu_supports(const char *feature): nonzero when the running CPU has the feature, which must be
+// a string literal
+ExprCodegenResult lowerCpuSupports(ASTContext &context, const std::string &name, NArguments *args) {
+    if (nullptr == args || nullptr != args->next) {
+        return ExprCodegenResult("Wrong number of arguments to builtin: " + name);
+    }
+    auto *literal = dynamic_cast<NString *>(args->expr.get());
+    if (nullptr == literal) {
+        return ExprCodegenResult("Argument to " + name + " must be a string literal");
+    }
+    const CpuFeature *feature = findCpuFeature(literal->getValue());
+    if (nullptr == feature) {
+        return ExprCodegenResult("Unknown CPU feature in " + name + ": " + literal->getValue());
+    }
+    llvm::Value *supported = emitCpuSupports(context, *feature);
+    return ExprCodegenResult(context.builder.CreateZExt(supported, context.builder.getInt32Ty(), "cpu_supports"),
+                             context.typeManager->getPrimitiveIdx(VAR_TYPE_INT));
+}
+
+}  // namespace
+
+BuiltinRegistry::BuiltinRegistry() {
+    builtins["__builtin_expect"] = lowerExpect;
+    builtins["__builtin_unreachable"] = lowerUnreachable;
+    builtins["__builtin_assume_aligned"] = lowerAssumeAligned;
+    builtins["__builtin_prefetch"] = lowerPrefetch;
+    builtins["__builtin_cpu_init"] = lowerCpuInit;
+    builtins["__builtin_cpu_supports"] = lowerCpuSupports;
+
+    builtins["__atomic_load_n"] = lowerAtomicLoad;
+    builtins["__atomic_store_n"] = lowerAtomicStore;
+    builtins["__atomic_exchange_n"] = makeAtomicRMW(llvm::AtomicRMWInst::Xchg, false, true);
+    builtins["__atomic_compare_exchange_n"] = lowerAtomicCompareExchange;
+    builtins["__atomic_thread_fence"] = makeFence(false, true);
+    builtins["__atomic_signal_fence"] = makeFence(true, true);
+    builtins["__sync_synchronize"] = makeFence(false, false);
+    builtins["__sync_bool_compare_and_swap"] = makeSyncCompareAndSwap(false);
+    builtins["__sync_val_compare_and_swap"] = makeSyncCompareAndSwap(true);
+    builtins["__sync_lock_test_and_set"] = makeAtomicRMW(llvm::AtomicRMWInst::Xchg, false, false);
+    builtins["__sync_lock_release"] = lowerSyncLockRelease;
+    const std::pair<const char *, llvm::AtomicRMWInst::BinOp> fetchOperations[] = {
+        {"add", llvm::AtomicRMWInst::Add}, {"sub", llvm::AtomicRMWInst::Sub}, {"and", llvm::AtomicRMWInst::And},
+        {"or", llvm::AtomicRMWInst::Or},   {"xor", llvm::AtomicRMWInst::Xor}, {"nand", llvm::AtomicRMWInst::Nand}};
+    for (const auto &[operation, binOp] : fetchOperations) {
+        std::string suffix = operation;
+        builtins["__atomic_fetch_" + suffix] = makeAtomicRMW(binOp, false, true);
+        builtins["__atomic_" + suffix + "_fetch"] = makeAtomicRMW(binOp, true, true);
+        builtins["__sync_fetch_and_" + suffix] = makeAtomicRMW(binOp, false, false);
+        builtins["__sync_" + suffix + "_and_fetch"] = makeAtomicRMW(binOp, true, false);
+    }
+
+    addLibraryFunction("memcpy", makeMemoryTransfer(false));
+    addLibraryFunction("memmove", makeMemoryTransfer(true));
+    addLibraryFunction("memset", lowerMemset);
+    addLibraryFunction("sqrt", makeMathIntrinsic(llvm::Intrinsic::sqrt, VAR_TYPE_DOUBLE, 1), true);
+    addLibraryFunction("sqrtf", makeMathIntrinsic(llvm::Intrinsic::sqrt, VAR_TYPE_FLOAT, 1), true);
+    addLibraryFunction("fabs", makeMathIntrinsic(llvm::Intrinsic::fabs, VAR_TYPE_DOUBLE, 1));
+    addLibraryFunction("fabsf", makeMathIntrinsic(llvm::Intrinsic::fabs, VAR_TYPE_FLOAT, 1));
+    addLibraryFunction("floor", makeMathIntrinsic(llvm::Intrinsic::floor, VAR_TYPE_DOUBLE, 1));
+    addLibraryFunction("floorf", makeMathIntrinsic(llvm::Intrinsic::floor, VAR_TYPE_FLOAT, 1));
+    addLibraryFunction("fmin", makeMathIntrinsic(llvm::Intrinsic::minnum, VAR_TYPE_DOUBLE, 2));
+    addLibraryFunction("fminf", makeMathIntrinsic(llvm::Intrinsic::minnum, VAR_TYPE_FLOAT, 2));
+    addLibraryFunction("fmax", makeMathIntrinsic(llvm::Intrinsic::maxnum, VAR_TYPE_DOUBLE, 2));
+    addLibraryFunction("fmaxf", makeMathIntrinsic(llvm::Intrinsic::maxnum, VAR_TYPE_FLOAT, 2));
+}
+
+void BuiltinRegistry::addLibraryFunction(const std::string &name, const Lowering &lowering, bool setsErrno) {
+    builtins["__builtin_" + name] = lowering;
+    libraryFunctions[name] = lowering;
+    if (true == setsErrno) {
+        errnoFunctions.insert(name);
+    }
+}
+
+const CpuFeature *findCpuFeature(const std::string &name) {
+    // Bits follow libgcc's enum processor_features; priorities follow the order GCC dispatches clones in
+    static const CpuFeature features[] = {
+        {"cmov", 0, 1},         {"mmx", 1, 2},          {"sse", 3, 3},          {"sse2", 4, 4},
+        {"sse3", 5, 5},         {"ssse3", 6, 6},        {"sse4a", 11, 7},       {"sse4.1", 7, 8},
+        {"sse4.2", 8, 9},       {"popcnt", 2, 10},      {"aes", 18, 11},        {"pclmul", 19, 12},
+        {"avx", 9, 13},         {"bmi", 16, 14},        {"fma4", 12, 15},       {"xop", 13, 16},
+        {"fma", 14, 17},        {"bmi2", 17, 18},       {"avx2", 10, 19},       {"avx512f", 15, 20},
+        {"avx512cd", 23, 21},   {"avx512er", 24, 22},   {"avx512pf", 25, 23},   {"avx512vl", 20, 24},
+        {"avx512bw", 21, 25},   {"avx512dq", 22, 26},   {"avx512ifma", 27, 27}, {"avx512vbmi", 26, 28},
+        {"avx5124vnniw", 28, 29}, {"avx5124fmaps", 29, 30}, {"avx512vpopcntdq", 30, 31}, {"avx512vbmi2", 31, 32}};
+    for (const CpuFeature &feature : features) {
+        if (name == feature.name) {
+            return &feature;
+        }
+    }
+    return nullptr;
+}
+
+llvm::CallInst *emitCpuInit(ASTContext &context) {
+    llvm::FunctionCallee init =
+        context.module.getOrInsertFunction("__cpu_indicator_init", context.builder.getVoidTy());
+    return context.builder.CreateCall(init);
+}
+
+llvm::Value *emitCpuSupports(ASTContext &context, const CpuFeature &feature) {
+    // struct __processor_model { unsigned vendor, type, subtype; unsigned features[1]; } __cpu_model;
+    llvm::Type *int32Type = context.builder.getInt32Ty();
+    llvm::Type *featuresType = llvm::ArrayType::get(int32Type, 1);
+    llvm::StructType *modelType =
+        llvm::StructType::get(context.llvmContext, {int32Type, int32Type, int32Type, featuresType});
+    llvm::GlobalVariable *model = context.module.getNamedGlobal("__cpu_model");
+    if (nullptr == model) {
+        model = new llvm::GlobalVariable(context.module, modelType, false, llvm::GlobalValue::ExternalLinkage, nullptr,
+                                         "__cpu_model");
+    }
+    llvm::Value *address = context.builder.CreateInBoundsGEP(
+        modelType, model, {context.builder.getInt32(0), context.builder.getInt32(3), context.builder.getInt32(0)});
+    llvm::Value *features = context.builder.CreateAlignedLoad(int32Type, address, llvm::Align(4), "cpu_features");
+    llvm::Value *bit = context.builder.CreateAnd(features, context.builder.getInt32(1u << feature.bit));
+    return context.builder.CreateICmpNE(bit, context.builder.getInt32(0), "has_" + std::string(feature.name));
+}
+
+const BuiltinRegistry &BuiltinRegistry::instance() {
+    static const BuiltinRegistry registry;
+    return registry;
+}
+
+const BuiltinRegistry::Lowering *BuiltinRegistry::find(const std::string &name,
+                                                       const CodegenOptions &options) const {
+    auto it = builtins.find(name);
+    if (builtins.end() != it) {
+        return &it->second;
+    }
+    if (false == options.libraryBuiltins || 0 != options.noBuiltinFunctions.count(name)) {
+        return nullptr;
+    }
+    if (true == options.mathErrno && 0 != errnoFunctions.count(name)) {
+        return nullptr;
+    }
+    it = libraryFunctions.find(name);
+    return (libraryFunctions.end() == it) ? nullptr : &it->second;
+}
+
+}  // namespace toyc::ast
@@ -3,10 +3,233 @@
 #include <iostream>
 #include <map>
 
+#include "ast/builtin.hpp"
 #include "ast/external_definition.hpp"
 
 using namespace toyc::ast;
 
+// The fmul behind `value` if it was just computed for this expression and nothing else uses it
+static llvm::BinaryOperator *contractibleProduct(llvm::Value *value) {
+    auto *product = llvm::dyn_cast<llvm::BinaryOperator>(value);
+    if (nullptr == product || llvm::Instruction::FMul != product->getOpcode() || false == product->use_empty()) {
+        return nullptr;
+    }
+    return product;
+}
+
+// -ffp-contract=on: `a * b + c` and `a * b - c` (either way round) become llvm.fmuladd, which the backend
+// computes with one rounding where the target has an FMA instruction. Only a product from the same expression
+// is fused, as C allows; nullptr when neither operand is one.
+static llvm::Value *createMultiplyAdd(ASTContext &context, BineryOperator op, llvm::Value *lhs, llvm::Value *rhs) {
+    llvm::BinaryOperator *product = contractibleProduct(lhs);
+    llvm::Value *addend = rhs;
+    bool negateProduct = false;
+    if (nullptr == product) {
+        product = contractibleProduct(rhs);
+        addend = lhs;
+        negateProduct = (SUB == op);
+    } else if (SUB == op) {
+        addend = context.builder.CreateFNeg(rhs, "neg");
+    }
+    if (nullptr == product) {
+        return nullptr;
+    }
+    llvm::Value *factor = product->getOperand(0);
+    if (true == negateProduct) {
+        factor = context.builder.CreateFNeg(factor, "neg");
+    }
+    llvm::Function *fmuladd =
+        llvm::Intrinsic::getDeclaration(&context.module, llvm::Intrinsic::fmuladd, {product->getType()});
+    llvm::Value *result = context.builder.CreateCall(fmuladd, {factor, product->getOperand(1), addend}, "fmuladd");
+    product->eraseFromParent();
+    return result;
+}
+
+// Arithmetic on two operands already converted to typeIdx. Signed integer overflow is undefined in C, so
+// signed add/sub/mul carry nsw, which lets LLVM widen induction variables and compute loop trip counts.
+// Vector operands are computed lane-wise by the same instructions.
+static llvm::Value *createArithmetic(ASTContext &context, BineryOperator op, llvm::Value *lhs, llvm::Value *rhs,
+                                     TypeIdx typeIdx) {
+    TypeIdx laneIdx = context.typeManager->getScalarTypeIdx(typeIdx);
+    bool isFloat = context.typeManager->isFloatingPointType(laneIdx);
+    bool isSigned = context.typeManager->isSignedIntegerType(laneIdx);
+    bool isUnsigned = context.typeManager->isUnsignedType(laneIdx);
+    if (true == isFloat && (MOD == op || LEFT == op || RIGHT == op || BIT_AND == op || BIT_OR == op || XOR == op)) {
+        return nullptr;
+    }
+    if (true == isFloat && (ADD == op || SUB == op) && FP_CONTRACT_ON == context.options.fpContract) {
+        if (llvm::Value *fused = createMultiplyAdd(context, op, lhs, rhs)) {
+            return fused;
+        }
+    }
+    switch (op) {
+        case ADD:
+            return isFloat ? context.builder.CreateFAdd(lhs, rhs, "add")
+                           : context.builder.CreateAdd(lhs, rhs, "add", false, isSigned);
+        case SUB:
+            return isFloat ? context.builder.CreateFSub(lhs, rhs, "sub")
+                           : context.builder.CreateSub(lhs, rhs, "sub", false, isSigned);
+        case MUL:
+            return isFloat ? context.builder.CreateFMul(lhs, rhs, "mul")
+                           : context.builder.CreateMul(lhs, rhs, "mul", false, isSigned);
+        case DIV:
+            if (isFloat)
+                return context.builder.CreateFDiv(lhs, rhs, "div");
+            return isUnsigned ? context.builder.CreateUDiv(lhs, rhs, "div")
+                              : context.builder.CreateSDiv(lhs, rhs, "div");
+        case MOD:
+            return isUnsigned ? context.builder.CreateURem(lhs, rhs, "mod")
+                              : context.builder.CreateSRem(lhs, rhs, "mod");
+        case LEFT:
+            return context.builder.CreateShl(lhs, rhs, "left");
+        case RIGHT:
+            return isSigned ? context.builder.CreateAShr(lhs, rhs, "right")
+                            : context.builder.CreateLShr(lhs, rhs, "right");
+        case BIT_AND:
+            return context.builder.CreateAnd(lhs, rhs, "bit_and");
+        case BIT_OR:
+            return context.builder.CreateOr(lhs, rhs, "bit_or");
+        case XOR:
+            return context.builder.CreateXor(lhs, rhs, "xor");
+        default:
+            return nullptr;
+    }
+}
+
+static bool isComparison(BineryOperator op) {
+    return op == EQ || op == NE || op == LE || op == GE || op == LT || op == GT;
+}
+
+// Comparison of two operands already converted to typeIdx; vectors compare lane-wise into an i1 vector
+static llvm::Value *createComparison(ASTContext &context, BineryOperator op, llvm::Value *lhs, llvm::Value *rhs,
+                                     TypeIdx typeIdx) {
+    // Pointers and unsigned integers order as unsigned values
+    TypeIdx laneIdx = context.typeManager->getScalarTypeIdx(typeIdx);
+    bool isFloat = context.typeManager->isFloatingPointType(laneIdx);
+    bool isUnsigned = false == context.typeManager->isSignedIntegerType(laneIdx);
+    switch (op) {
+        case EQ:
+            return isFloat ? context.builder.CreateFCmpOEQ(lhs, rhs, "eq")
+                           : context.builder.CreateICmpEQ(lhs, rhs, "eq");
+        case NE:
+            return isFloat ? context.builder.CreateFCmpONE(lhs, rhs, "ne")
+                           : context.builder.CreateICmpNE(lhs, rhs, "ne");
+        case LE:
+            return isFloat      ? context.builder.CreateFCmpOLE(lhs, rhs, "le")
+                   : isUnsigned ? context.builder.CreateICmpULE(lhs, rhs, "le")
+                                : context.builder.CreateICmpSLE(lhs, rhs, "le");
+        case GE:
+            return isFloat      ? context.builder.CreateFCmpOGE(lhs, rhs, "ge")
+                   : isUnsigned ? context.builder.CreateICmpUGE(lhs, rhs, "ge")
+                                : context.builder.CreateICmpSGE(lhs, rhs, "ge");
+        case LT:
+            return isFloat      ? context.builder.CreateFCmpOLT(lhs, rhs, "lt")
+                   : isUnsigned ? context.builder.CreateICmpULT(lhs, rhs, "lt")
+                                : context.builder.CreateICmpSLT(lhs, rhs, "lt");
+        case GT:
+            return isFloat      ? context.builder.CreateFCmpOGT(lhs, rhs, "gt")
+                   : isUnsigned ? context.builder.CreateICmpUGT(lhs, rhs, "gt")
+                                : context.builder.CreateICmpSGT(lhs, rhs, "gt");
+        default:
+            return nullptr;
+    }
+}
+
+// GCC vector extension semantics: both operands have the same vector type, or the scalar one is converted to
+// the lane type and splatted. Comparisons yield -1 (true) or 0 per lane, as a signed integer vector with lanes
+// as wide as the operands'.
+static ExprCodegenResult createVectorOperation(ASTContext &context, BineryOperator op, llvm::Value *lhs,
+                                               TypeIdx lhsTypeIdx, llvm::Value *rhs, TypeIdx rhsTypeIdx) {
+    TypeManager &typeManager = *context.typeManager;
+    bool lhsIsVector = typeManager.isVectorType(lhsTypeIdx);
+    TypeIdx vectorIdx = typeManager.unqualify(true == lhsIsVector ? lhsTypeIdx : rhsTypeIdx);
+    if (true == lhsIsVector && true == typeManager.isVectorType(rhsTypeIdx) &&
+        vectorIdx != typeManager.unqualify(rhsTypeIdx)) {
+        return ExprCodegenResult("Vector operands of a binary operator must have the same type");
+    }
+    auto *vectorTc = static_cast<const VectorTypeCodegen *>(typeManager.get(vectorIdx));
+    TypeIdx laneIdx = vectorTc->getElementIdx();
+
+    llvm::Value **scalar = (true == lhsIsVector) ? &rhs : &lhs;
+    TypeIdx scalarTypeIdx = (true == lhsIsVector) ? rhsTypeIdx : lhsTypeIdx;
+    if (false == typeManager.isVectorType(scalarTypeIdx)) {
+        ExprCodegenResult castResult = typeManager.typeCast(*scalar, scalarTypeIdx, laneIdx, context.builder);
+        if (false == castResult.isSuccess()) {
+            return ExprCodegenResult("Scalar operand cannot be converted to the vector lane type") << castResult;
+        }
+        *scalar = context.builder.CreateVectorSplat(vectorTc->getLaneCount(), castResult.getValue(), "splat");
+    }
+
+    if (false == isComparison(op)) {
+        llvm::Value *result = createArithmetic(context, op, lhs, rhs, vectorIdx);
+        if (nullptr == result) {
+            return ExprCodegenResult("Invalid operands to vector binary operator");
+        }
+        return ExprCodegenResult(result, vectorIdx);
+    }
+
+    static const std::map<unsigned, VarType> signedLaneTypes = {
+        {8, VAR_TYPE_CHAR}, {16, VAR_TYPE_SHORT}, {32, VAR_TYPE_INT}, {64, VAR_TYPE_LONG}};
+    unsigned laneBits = typeManager.realize(laneIdx)->getPrimitiveSizeInBits();
+    TypeIdx maskIdx =
+        typeManager.getVectorIdx(typeManager.getPrimitiveIdx(signedLaneTypes.at(laneBits)), vectorTc->getLaneCount());
+    llvm::Value *lanes = createComparison(context, op, lhs, rhs, vectorIdx);
+    return ExprCodegenResult(context.builder.CreateSExt(lanes, typeManager.realize(maskIdx), "mask"), maskIdx);
+}
+
+// Copies a struct or union with llvm.memcpy rather than through a first-class aggregate load and store
+static ExprCodegenResult assignRecord(ASTContext &context, const AllocCodegenResult &lhsResult, NExpression *rhs) {
+    TypeIdx lhsTypeIdx = lhsResult.getType();
+    if (context.typeManager->isConstQualified(lhsTypeIdx)) {
+        return ExprCodegenResult("Assignment to const-qualified variable");
+    }
+    AllocCodegenResult rhsResult = rhs->aggregategen(context);
+    if (false == rhsResult.isSuccess()) {
+        return ExprCodegenResult("Assignment failed due to null values") << rhsResult;
+    }
+    if (context.typeManager->unqualify(rhsResult.getType()) != context.typeManager->unqualify(lhsTypeIdx)) {
+        return ExprCodegenResult("Incompatible types in struct assignment");
+    }
+
+    context.copyAggregate(lhsResult.getAllocaInst(), rhsResult.getAllocaInst(), lhsTypeIdx);
+    llvm::Type *recordType = context.typeManager->realize(lhsTypeIdx);
+    llvm::Align alignment(context.typeManager->getAlignment(lhsTypeIdx));
+    return ExprCodegenResult(
+        context.builder.CreateAlignedLoad(recordType, lhsResult.getAllocaInst(), alignment, "assigned_value"),
+        lhsTypeIdx);
+}
+
+// Stores rhs, converted to the lvalue's type, into the lvalue computed beforehand
+static ExprCodegenResult assignTo(ASTContext &context, const AllocCodegenResult &lhsResult, NExpression *rhs) {
+    llvm::Value *lhsAlloca = lhsResult.getAllocaInst();
+    TypeIdx lhsTypeIdx = lhsResult.getType();
+    if (true == lhsResult.isSuccess() && true == context.typeManager->isRecordType(lhsTypeIdx)) {
+        return assignRecord(context, lhsResult, rhs);
+    }
+    CodegenResult rhsResult = rhs->codegen(context);
+    llvm::Value *rhsValue = rhsResult.getValue();
+    TypeIdx rhsTypeIdx = rhsResult.getType();
+    if (false == rhsResult.isSuccess() || false == lhsResult.isSuccess()) {
+        return ExprCodegenResult("Assignment failed due to null values") << lhsResult << rhsResult;
+    }
+
+    if (context.typeManager->isConstQualified(lhsTypeIdx)) {
+        return ExprCodegenResult("Assignment to const-qualified variable");
+    }
+
+    CodegenResult castResult = context.typeManager->typeCast(rhsValue, rhsTypeIdx, lhsTypeIdx, context.builder);
+    if (false == castResult.isSuccess()) {
+        return ExprCodegenResult("Type cast failed during assignment") << castResult;
+    }
+    rhsValue = castResult.getValue();
+    if (0 != lhsResult.getBitField().width) {
+        return ExprCodegenResult(context.storeBitField(lhsResult, rhsValue), lhsTypeIdx);
+    }
+    bool isVolatile = context.typeManager->isVolatileQualified(lhsTypeIdx);
+    context.annotateAccess(context.builder.CreateStore(rhsValue, lhsAlloca, isVolatile), lhsTypeIdx);
+    return ExprCodegenResult(rhsValue, lhsTypeIdx);
+}
+
 ExprCodegenResult NLogicalOperator::codegen(ASTContext &context) {
     ExprCodegenResult lhsResult = lhs->codegen(context);
     llvm::Value *lhsValue = lhsResult.getValue();
@@ -77,10 +300,15 @@ ExprCodegenResult NBinaryOperator::codegen(ASTContext &context) {
     llvm::Value *rhsValue = rhsResult.getValue();
     TypeIdx rhsTypeIdx = rhsResult.getType();
 
+    if (true == context.typeManager->isVectorType(lhsTypeIdx) ||
+        true == context.typeManager->isVectorType(rhsTypeIdx)) {
+        return createVectorOperation(context, op, lhsValue, lhsTypeIdx, rhsValue, rhsTypeIdx);
+    }
+
     TypeIdx targetTypeIdx = context.typeManager->getCommonTypeIdx(lhsTypeIdx, rhsTypeIdx);
 
     TypeIdx resultTypeIdx;
-    if (op == EQ || op == NE || op == LE || op == GE || op == LT || op == GT) {
+    if (true == isComparison(op)) {
         resultTypeIdx = context.typeManager->getPrimitiveIdx(VAR_TYPE_BOOL);
     } else {
         resultTypeIdx = targetTypeIdx;
@@ -98,90 +326,35 @@ ExprCodegenResult NBinaryOperator::codegen(ASTContext &context) {
     }
     rhsValue = castRhsResult.getValue();
 
-    switch (op) {
-        case ADD:
-            if (context.typeManager->isFloatingPointType(targetTypeIdx))
-                result = context.builder.CreateFAdd(lhsValue, rhsValue, "add");
-            else
-                result = context.builder.CreateAdd(lhsValue, rhsValue, "add");
-            break;
-        case SUB:
-            if (context.typeManager->isFloatingPointType(targetTypeIdx))
-                result = context.builder.CreateFSub(lhsValue, rhsValue, "sub");
-            else
-                result = context.builder.CreateSub(lhsValue, rhsValue, "sub");
-            break;
-        case MUL:
-            if (context.typeManager->isFloatingPointType(targetTypeIdx))
-                result = context.builder.CreateFMul(lhsValue, rhsValue, "mul");
-            else
-                result = context.builder.CreateMul(lhsValue, rhsValue, "mul");
-            break;
-        case DIV:
-            if (context.typeManager->isFloatingPointType(targetTypeIdx))
-                result = context.builder.CreateFDiv(lhsValue, rhsValue, "div");
-            else
-                result = context.builder.CreateSDiv(lhsValue, rhsValue, "div");
-            break;
-        case MOD:
-            result = context.builder.CreateSRem(lhsValue, rhsValue, "mod");
-            break;
-        case LEFT:
-            result = context.builder.CreateShl(lhsValue, rhsValue, "left");
-            break;
-        case RIGHT:
-            result = context.builder.CreateLShr(lhsValue, rhsValue, "right");
-            break;
-        case EQ:
-            result = context.typeManager->isFloatingPointType(targetTypeIdx)
-                         ? context.builder.CreateFCmpOEQ(lhsValue, rhsValue, "eq")
-                         : context.builder.CreateICmpEQ(lhsValue, rhsValue, "eq");
-            break;
-        case NE:
-            result = context.typeManager->isFloatingPointType(targetTypeIdx)
-                         ? context.builder.CreateFCmpONE(lhsValue, rhsValue, "ne")
-                         : context.builder.CreateICmpNE(lhsValue, rhsValue, "ne");
-            break;
-        case LE:
-            result = context.typeManager->isFloatingPointType(targetTypeIdx)
-                         ? context.builder.CreateFCmpOLE(lhsValue, rhsValue, "le")
-                         : context.builder.CreateICmpSLE(lhsValue, rhsValue, "le");
-            break;
-        case GE:
-            result = context.typeManager->isFloatingPointType(targetTypeIdx)
-                         ? context.builder.CreateFCmpOGE(lhsValue, rhsValue, "ge")
-                         : context.builder.CreateICmpSGE(lhsValue, rhsValue, "ge");
-            break;
-        case LT:
-            result = context.typeManager->isFloatingPointType(targetTypeIdx)
-                         ? context.builder.CreateFCmpOLT(lhsValue, rhsValue, "lt")
-                         : context.builder.CreateICmpSLT(lhsValue, rhsValue, "lt");
-            break;
-        case GT:
-            result = context.typeManager->isFloatingPointType(targetTypeIdx)
-                         ? context.builder.CreateFCmpOGT(lhsValue, rhsValue, "gt")
-                         : context.builder.CreateICmpSGT(lhsValue, rhsValue, "gt");
-            break;
-        case BIT_AND:
-            result = context.builder.CreateAnd(lhsValue, rhsValue, "bit_and");
-            break;
-        case BIT_OR:
-            result = context.builder.CreateOr(lhsValue, rhsValue, "bit_or");
-            break;
-        case XOR:
-            result = context.builder.CreateXor(lhsValue, rhsValue, "xor");
-            break;
-        default:
+    if (true == isComparison(op)) {
+        result = createComparison(context, op, lhsValue, rhsValue, targetTypeIdx);
+    } else {
+        result = createArithmetic(context, op, lhsValue, rhsValue, targetTypeIdx);
+        if (nullptr == result) {
             return ExprCodegenResult("Unknown binary operator");
+        }
     }
 
     return ExprCodegenResult(result, resultTypeIdx);
 }
 
 ExprCodegenResult NUnaryExpression::codegen(ASTContext &context) {
+    // Taking an address only needs the operand's storage. Loading it first would also break constant
+    // initializers at file scope, where there is no block to emit the load into.
+    if (op == ADDR) {
+        AllocCodegenResult allocResult = expr->allocgen(context);
+        if (false == allocResult.isSuccess()) {
+            return ExprCodegenResult("Failed to get lvalue for address-of operator") << allocResult;
+        }
+        if (0 != allocResult.getBitField().width) {
+            return ExprCodegenResult("Cannot take the address of a bit-field");
+        }
+        return ExprCodegenResult(allocResult.getAllocaInst(),
+                                 context.typeManager->getPointerIdx(allocResult.getType(), 1));
+    }
+
     CodegenResult exprResult = expr->codegen(context);
-    llvm::AllocaInst *allocaInst = nullptr;
-    llvm::Value *one = context.builder.getInt32(1);
+    llvm::Value *allocaInst = nullptr;
     llvm::Value *value = exprResult.getValue();
     TypeIdx typeIdx = exprResult.getType();
 
@@ -189,36 +362,67 @@ ExprCodegenResult NUnaryExpression::codegen(ASTContext &context) {
         return ExprCodegenResult("Failed to generate code for unary expression operand") << exprResult;
     }
 
-    if (op == L_INC || op == R_INC || op == L_DEC || op == R_DEC || op == ADDR || op == DEREF) {
-        CodegenResult allocResult = expr->allocgen(context);
-        if (false == allocResult.isSuccess()) {
-            return ExprCodegenResult("Failed to get lvalue for unary increment/decrement") << allocResult;
+    llvm::Value *one = value->getType()->isIntOrIntVectorTy() ? llvm::ConstantInt::get(value->getType(), 1)
+                                                        : context.builder.getInt32(1);
+    // Only int and wider are computed at their own width in C; narrower operands wrap when stored back
+    bool noSignedWrap = context.typeManager->isSignedIntegerType(typeIdx) &&
+                        context.typeManager->promoteInteger(typeIdx) == context.typeManager->unqualify(typeIdx);
+
+    AllocCodegenResult lvalue;
+    if (op == L_INC || op == R_INC || op == L_DEC || op == R_DEC) {
+        lvalue = expr->allocgen(context);
+        if (false == lvalue.isSuccess()) {
+            return ExprCodegenResult("Failed to get lvalue for unary increment/decrement") << lvalue;
         }
-        allocaInst = static_cast<llvm::AllocaInst *>(allocResult.getAllocaInst());
+        allocaInst = lvalue.getAllocaInst();
     }
 
     if ((op == L_INC || op == R_INC || op == L_DEC || op == R_DEC) && context.typeManager->isConstQualified(typeIdx)) {
         return ExprCodegenResult("Increment/decrement of const-qualified variable");
     }
 
+    // ++ and -- on an _Atomic integer are one atomicrmw, which makes the operand's plain load dead
+    bool isIncDec = op == L_INC || op == R_INC || op == L_DEC || op == R_DEC;
+    if (true == isIncDec && true == context.typeManager->isAtomicQualified(typeIdx)) {
+        if (false == value->getType()->isIntegerTy()) {
+            return ExprCodegenResult("Increment/decrement of an _Atomic object requires an integer type");
+        }
+        if (auto *load = llvm::dyn_cast<llvm::LoadInst>(value); nullptr != load && load->use_empty()) {
+            load->eraseFromParent();
+        }
+        bool isIncrement = op == L_INC || op == R_INC;
+        llvm::Value *old = context.builder.CreateAtomicRMW(
+            isIncrement ? llvm::AtomicRMWInst::Add : llvm::AtomicRMWInst::Sub, allocaInst, one, llvm::MaybeAlign(),
+            llvm::AtomicOrdering::SequentiallyConsistent);
+        if (op == R_INC || op == R_DEC) {
+            return ExprCodegenResult(old, typeIdx);
+        }
+        return ExprCodegenResult(isIncrement ? context.builder.CreateAdd(old, one, "inc")
+                                             : context.builder.CreateSub(old, one, "dec"),
+                                 typeIdx);
+    }
+
     bool isVolatile = context.typeManager->isVolatileQualified(typeIdx);
-    llvm::Value *tmp = nullptr;
+    // Writes the updated value back; a bit-field keeps only its low bits, which is then the prefix result
+    auto storeBack = [&](llvm::Value *updated) -> llvm::Value * {
+        if (0 != lvalue.getBitField().width) {
+            return context.storeBitField(lvalue, updated);
+        }
+        context.annotateAccess(context.builder.CreateStore(updated, allocaInst, isVolatile), typeIdx);
+        return updated;
+    };
     switch (op) {
         case L_INC:
-            value = context.builder.CreateAdd(value, one, "inc");
-            context.builder.CreateStore(value, allocaInst, isVolatile);
+            value = storeBack(context.builder.CreateAdd(value, one, "inc", false, noSignedWrap));
             break;
         case R_INC:
-            tmp = context.builder.CreateAdd(value, one, "inc");
-            context.builder.CreateStore(tmp, allocaInst, isVolatile);
+            storeBack(context.builder.CreateAdd(value, one, "inc", false, noSignedWrap));
             break;
         case L_DEC:
-            value = context.builder.CreateSub(value, one, "dec");
-            context.builder.CreateStore(value, allocaInst, isVolatile);
+            value = storeBack(context.builder.CreateSub(value, one, "dec", false, noSignedWrap));
             break;
         case R_DEC:
-            tmp = context.builder.CreateSub(value, one, "dec");
-            context.builder.CreateStore(tmp, allocaInst, isVolatile);
+            storeBack(context.builder.CreateSub(value, one, "dec", false, noSignedWrap));
             break;
         case ADDR:
             value = allocaInst;
@@ -232,15 +436,19 @@ ExprCodegenResult NUnaryExpression::codegen(ASTContext &context) {
             TypeIdx pointeeIdx = ptrTc->getPointeeIdx();
             bool pointeeIsVolatile = context.typeManager->isVolatileQualified(pointeeIdx);
             llvm::Type *pointeeType = context.typeManager->realize(pointeeIdx);
-            value = context.builder.CreateLoad(pointeeType, value, pointeeIsVolatile, "deref");
+            llvm::LoadInst *load = context.builder.CreateLoad(pointeeType, value, pointeeIsVolatile, "deref");
+            context.annotateAccess(load, pointeeIdx);
+            value = load;
         } break;
         case PLUS:
             break;
         case MINUS:
-            value = context.builder.CreateNeg(value, "neg");
+            value = context.typeManager->isFloatingPointType(context.typeManager->getScalarTypeIdx(typeIdx))
+                        ? context.builder.CreateFNeg(value, "neg")
+                        : context.builder.CreateNeg(value, "neg", false, noSignedWrap);
             break;
         case BIT_NOT:
-            value = context.builder.CreateXor(value, context.builder.getInt32(-1), "bit_not");
+            value = context.builder.CreateNot(value, "bit_not");
             break;
         case LOG_NOT: {
             TypeIdx boolIdx = context.typeManager->getPrimitiveIdx(VAR_TYPE_BOOL);
@@ -270,6 +478,24 @@ ExprCodegenResult NUnaryExpression::codegen(ASTContext &context) {
     return ExprCodegenResult(value, resultTypeIdx);
 }
 
+AllocCodegenResult NUnaryExpression::allocgen(ASTContext &context) {
+    if (op != DEREF) {
+        return expr->allocgen(context);
+    }
+
+    // The object designated by `*p` lives at the address held in p, not in p's own storage
+    ExprCodegenResult ptrResult = expr->codegen(context);
+    if (false == ptrResult.isSuccess()) {
+        return AllocCodegenResult("Failed to generate pointer for dereference") << ptrResult;
+    }
+    TypeIdx unqualifiedIdx = context.typeManager->unqualify(ptrResult.getType());
+    auto *ptrTc = dynamic_cast<const PointerTypeCodegen *>(context.typeManager->get(unqualifiedIdx));
+    if (!ptrTc) {
+        return AllocCodegenResult("Cannot dereference non-pointer type");
+    }
+    return AllocCodegenResult(ptrResult.getValue(), ptrTc->getPointeeIdx());
+}
+
 ExprCodegenResult NConditionalExpression::codegen(ASTContext &context) {
     CodegenResult condResult = condition->codegen(context);
     llvm::Value *condValue = condResult.getValue();
@@ -315,20 +541,23 @@ ExprCodegenResult NConditionalExpression::codegen(ASTContext &context) {
 
 ExprCodegenResult NIdentifier::codegen(ASTContext &context) {
     auto [isFound, variablePair] = context.variableTable->lookup(name);
-    auto [allocaInst, typeIdx] = variablePair;
+    auto [storage, typeIdx] = variablePair;
     llvm::Value *value = nullptr;
-    if (false == isFound || nullptr == allocaInst) {
+    if (false == isFound || nullptr == storage) {
         return ExprCodegenResult("Variable not found: " + name);
     }
 
     llvm::Type *type = context.typeManager->realize(typeIdx);
+    if (nullptr == type) {
+        return ExprCodegenResult("Failed to realize type of variable: " + name);
+    }
 
-    if (nullptr != type && true == type->isArrayTy()) {
+    if (true == type->isArrayTy()) {
         std::vector<llvm::Value *> indices(2);
         indices[0] = llvm::ConstantInt::get(context.llvmContext, llvm::APInt(32, 0));
         indices[1] = llvm::ConstantInt::get(context.llvmContext, llvm::APInt(32, 0));
 
-        value = context.builder.CreateGEP(allocaInst->getAllocatedType(), allocaInst, indices, name + "_decay");
+        value = context.builder.CreateGEP(type, storage, indices, name + "_decay");
 
         auto *arrTc = dynamic_cast<const ArrayTypeCodegen *>(context.typeManager->get(typeIdx));
         TypeIdx elementIdx = arrTc ? arrTc->getElementIdx() : InvalidTypeIdx;
@@ -336,48 +565,52 @@ ExprCodegenResult NIdentifier::codegen(ASTContext &context) {
     }
 
     bool isVolatile = context.typeManager->isVolatileQualified(typeIdx);
-    value = context.builder.CreateLoad(allocaInst->getAllocatedType(), allocaInst, isVolatile, name);
-    if (nullptr == value) {
+    llvm::LoadInst *load = context.builder.CreateLoad(type, storage, isVolatile, name);
+    if (nullptr == load) {
         return ExprCodegenResult("Load failed for variable: " + name);
     }
+    context.annotateAccess(load, typeIdx);
+    value = load;
 
     return ExprCodegenResult(value, typeIdx);
 }
 
 AllocCodegenResult NIdentifier::allocgen(ASTContext &context) {
     auto [isFound, variablePair] = context.variableTable->lookup(name);
-    auto [allocaInst, typeIdx] = variablePair;
+    auto [storage, typeIdx] = variablePair;
 
-    if (false == isFound || nullptr == allocaInst) {
+    if (false == isFound || nullptr == storage) {
         return AllocCodegenResult("Variable not found: " + name);
     }
 
-    return AllocCodegenResult(allocaInst, typeIdx);
+    return AllocCodegenResult(storage, typeIdx);
 }
 
 ExprCodegenResult NAssignment::codegen(ASTContext &context) {
-    AllocCodegenResult lhsResult = lhs->allocgen(context);
-    llvm::AllocaInst *lhsAlloca = static_cast<llvm::AllocaInst *>(lhsResult.getAllocaInst());
-    TypeIdx lhsTypeIdx = lhsResult.getType();
-    CodegenResult rhsResult = rhs->codegen(context);
-    llvm::Value *rhsValue = rhsResult.getValue();
-    TypeIdx rhsTypeIdx = rhsResult.getType();
-    if (false == rhsResult.isSuccess() || false == lhsResult.isSuccess()) {
-        return ExprCodegenResult("Assignment failed due to null values") << lhsResult << rhsResult;
+    if (auto *subscript = dynamic_cast<NArraySubscript *>(lhs.get())) {
+        return subscript->assign(context, rhs.get());
     }
+    return assignTo(context, lhs->allocgen(context), rhs.get());
+}
 
-    if (context.typeManager->isConstQualified(lhsTypeIdx)) {
-        return ExprCodegenResult("Assignment to const-qualified variable");
+AllocCodegenResult NExpression::aggregategen(ASTContext &context) {
+    auto *unary = dynamic_cast<NUnaryExpression *>(this);
+    bool designatesObject =
+        nullptr != dynamic_cast<NIdentifier *>(this) || nullptr != dynamic_cast<NMemberAccess *>(this) ||
+        nullptr != dynamic_cast<NArraySubscript *>(this) || nullptr != dynamic_cast<NFunctionCall *>(this) ||
+        (nullptr != unary && DEREF == unary->getOperator());
+    if (true == designatesObject) {
+        return allocgen(context);
     }
 
-    CodegenResult castResult = context.typeManager->typeCast(rhsValue, rhsTypeIdx, lhsTypeIdx, context.builder);
-    if (false == castResult.isSuccess()) {
-        return ExprCodegenResult("Type cast failed during assignment") << castResult;
+    ExprCodegenResult valueResult = codegen(context);
+    if (false == valueResult.isSuccess() || nullptr == valueResult.getValue()) {
+        return AllocCodegenResult("Failed to evaluate struct value") << valueResult;
     }
-    rhsValue = castResult.getValue();
-    bool isVolatile = context.typeManager->isVolatileQualified(lhsTypeIdx);
-    context.builder.CreateStore(rhsValue, lhsAlloca, isVolatile);
-    return ExprCodegenResult(rhsValue, lhsTypeIdx);
+    llvm::AllocaInst *temporary = context.createEntryAlloca(valueResult.getValue()->getType(), "agg_tmp");
+    temporary->setAlignment(llvm::Align(context.typeManager->getAlignment(valueResult.getType())));
+    context.builder.CreateStore(valueResult.getValue(), temporary);
+    return AllocCodegenResult(temporary, valueResult.getType());
 }
 
 ExprCodegenResult NArguments::codegen(ASTContext &context) {
@@ -385,17 +618,101 @@ ExprCodegenResult NArguments::codegen(ASTContext &context) {
 }
 
 ExprCodegenResult NFunctionCall::codegen(ASTContext &context) {
-    std::vector<llvm::Value *> args;
     NFunctionDefinition *function = context.functionDefinitions[name];
-    llvm::Value *res = nullptr;
+    bool isDefinedHere = nullptr != function && false == function->getFunction()->isDeclaration();
+    const BuiltinRegistry::Lowering *builtin = BuiltinRegistry::instance().find(name, context.options);
+    if (nullptr != builtin && false == isDefinedHere) {
+        return (*builtin)(context, name, argNodes.get());
+    }
+
     if (nullptr == function) {
         return ExprCodegenResult("Function not found: " + name);
     }
+    TypeIdx returnTypeIdx = function->getReturnTypeIdx();
+    if (false == context.typeManager->isRecordType(returnTypeIdx)) {
+        return emitCall(context, function, nullptr);
+    }
+
+    // The few users of a record rvalue that do not take its address get the whole object
+    AllocCodegenResult slotResult = allocgen(context);
+    if (false == slotResult.isSuccess()) {
+        return ExprCodegenResult("Function call failed: " + name) << slotResult;
+    }
+    llvm::Align alignment(context.typeManager->getAlignment(returnTypeIdx));
+    llvm::LoadInst *value = context.builder.CreateAlignedLoad(context.typeManager->realize(returnTypeIdx),
+                                                              slotResult.getAllocaInst(), alignment, "call_value");
+    return ExprCodegenResult(value, returnTypeIdx);
+}
+
+AllocCodegenResult NFunctionCall::allocgen(ASTContext &context) {
+    NFunctionDefinition *function = context.functionDefinitions[name];
+    if (nullptr == function || false == context.typeManager->isRecordType(function->getReturnTypeIdx())) {
+        return AllocCodegenResult("Allocation not supported for " + getType());
+    }
+
+    TypeIdx returnTypeIdx = function->getReturnTypeIdx();
+    llvm::AllocaInst *resultSlot =
+        context.createEntryAlloca(context.typeManager->realize(returnTypeIdx), name + "_result");
+    resultSlot->setAlignment(llvm::Align(context.typeManager->getAlignment(returnTypeIdx)));
+    ExprCodegenResult callResult = emitCall(context, function, resultSlot);
+    if (false == callResult.isSuccess()) {
+        return AllocCodegenResult("Function call failed: " + name) << callResult;
+    }
+    return AllocCodegenResult(resultSlot, returnTypeIdx);
+}
+
+ExprCodegenResult NFunctionCall::emitCall(ASTContext &context, NFunctionDefinition *function,
+                                          llvm::Value *resultSlot) {
+    TypeManager &typeManager = *context.typeManager;
+    TypeIdx returnTypeIdx = function->getReturnTypeIdx();
+    const ArgumentPassing &returnPassing = function->getReturnPassing();
+    std::vector<llvm::Value *> args;
+    std::vector<std::pair<unsigned, llvm::Attribute>> argAttributes;  // byval and sret, by LLVM argument index
+    ArgumentRegisters registers;
+    if (ArgumentPassing::Indirect == returnPassing.kind) {
+        argAttributes.emplace_back(
+            0, llvm::Attribute::getWithStructRetType(context.llvmContext, typeManager.realize(returnTypeIdx)));
+        args.push_back(resultSlot);
+        registers.integer--;
+    }
+
+    // A record argument is passed from its address: split into register pieces or copied by the callee (byval).
+    // The caller's classification walks the same registers the callee's did, so both agree.
+    auto passRecord = [&](llvm::Value *address, TypeIdx typeIdx) {
+        ArgumentPassing passing = typeManager.classifyArgument(typeIdx, registers);
+        if (ArgumentPassing::Coerced == passing.kind) {
+            for (llvm::Value *piece : context.loadPieces(address, typeIdx, passing)) {
+                args.push_back(piece);
+            }
+        } else if (ArgumentPassing::Indirect == passing.kind) {
+            unsigned index = static_cast<unsigned>(args.size());
+            argAttributes.emplace_back(
+                index, llvm::Attribute::getWithByValType(context.llvmContext, typeManager.realize(typeIdx)));
+            llvm::Align alignment(std::max<uint64_t>(8, typeManager.getAlignment(typeIdx)));
+            argAttributes.emplace_back(index, llvm::Attribute::getWithAlignment(context.llvmContext, alignment));
+            args.push_back(address);
+        }
+    };
 
     NParameter *paramIt = function->getParams();
     NArguments *argNode = argNodes.get();
 
     for (; argNode != nullptr; argNode = argNode->next.get()) {
+        bool isNamed = paramIt != nullptr && false == paramIt->isVariadic;
+        if (true == isNamed && true == typeManager.isRecordType(paramIt->getTypeIdx())) {
+            AllocCodegenResult addressResult = argNode->expr->aggregategen(context);
+            if (false == addressResult.isSuccess()) {
+                return ExprCodegenResult("Argument code generation failed for function call: " + name)
+                       << addressResult;
+            }
+            if (typeManager.unqualify(addressResult.getType()) != typeManager.unqualify(paramIt->getTypeIdx())) {
+                return ExprCodegenResult("Incompatible struct argument in function call: " + name);
+            }
+            passRecord(addressResult.getAllocaInst(), paramIt->getTypeIdx());
+            paramIt = paramIt->next.get();
+            continue;
+        }
+
         CodegenResult argResult = argNode->codegen(context);
         llvm::Value *argValue = argResult.getValue();
         TypeIdx argTypeIdx = argResult.getType();
@@ -403,14 +720,34 @@ ExprCodegenResult NFunctionCall::codegen(ASTContext &context) {
             return ExprCodegenResult("Argument code generation failed for function call: " + name) << argResult;
         }
 
-        if (paramIt != nullptr && false == paramIt->isVariadic) {
-            CodegenResult castResult =
-                context.typeManager->typeCast(argValue, argTypeIdx, paramIt->getTypeIdx(), context.builder);
+        TypeIdx passedTypeIdx = argTypeIdx;
+        if (true == isNamed) {
+            passedTypeIdx = paramIt->getTypeIdx();
+            CodegenResult castResult = typeManager.typeCast(argValue, argTypeIdx, passedTypeIdx, context.builder);
             if (false == castResult.isSuccess()) {
                 return ExprCodegenResult("Type cast failed for argument in function call: " + name) << castResult;
             }
             argValue = castResult.getValue();
+        } else if (true == typeManager.isRecordType(argTypeIdx)) {
+            // A struct matched by `...` is passed like a named one, from a copy of its value
+            llvm::AllocaInst *temporary = context.createEntryAlloca(argValue->getType(), "vararg_tmp");
+            temporary->setAlignment(llvm::Align(typeManager.getAlignment(argTypeIdx)));
+            context.builder.CreateStore(argValue, temporary);
+            passRecord(temporary, argTypeIdx);
+            paramIt = (paramIt != nullptr) ? paramIt->next.get() : nullptr;
+            continue;
+        } else {
+            // Arguments matched by `...` undergo the default argument promotions
+            passedTypeIdx = typeManager.isFloatingPointType(argTypeIdx) ? typeManager.getPrimitiveIdx(VAR_TYPE_DOUBLE)
+                                                                        : typeManager.promoteInteger(argTypeIdx);
+            CodegenResult castResult = typeManager.typeCast(argValue, argTypeIdx, passedTypeIdx, context.builder);
+            if (false == castResult.isSuccess()) {
+                return ExprCodegenResult("Type cast failed for variadic argument in function call: " + name)
+                       << castResult;
+            }
+            argValue = castResult.getValue();
         }
+        typeManager.classifyArgument(passedTypeIdx, registers);
 
         if (paramIt != nullptr) {
             paramIt = paramIt->next.get();
@@ -419,9 +756,19 @@ ExprCodegenResult NFunctionCall::codegen(ASTContext &context) {
         args.push_back(argValue);
     }
 
-    res = context.builder.CreateCall(function->getFunction(), args);
+    llvm::CallInst *call = context.builder.CreateCall(function->getCallee(), args);
+    for (const auto &[index, attribute] : argAttributes) {
+        call->addParamAttr(index, attribute);
+    }
 
-    return ExprCodegenResult(res, function->getReturnTypeIdx());
+    if (ArgumentPassing::Coerced == returnPassing.kind) {
+        std::vector<llvm::Value *> pieces;
+        for (unsigned i = 0; i < returnPassing.pieces.size(); i++) {
+            pieces.push_back(1 == returnPassing.pieces.size() ? call : context.builder.CreateExtractValue(call, i));
+        }
+        context.storePieces(resultSlot, returnTypeIdx, pieces);
+    }
+    return ExprCodegenResult(call, returnTypeIdx);
 }
 
 ExprCodegenResult NMemberAccess::codegen(ASTContext &context) {
@@ -432,8 +779,12 @@ ExprCodegenResult NMemberAccess::codegen(ASTContext &context) {
 
     llvm::Value *memberPtr = allocResult.getAllocaInst();
     TypeIdx memberTypeIdx = allocResult.getType();
+    if (0 != allocResult.getBitField().width) {
+        return ExprCodegenResult(context.loadBitField(allocResult), memberTypeIdx);
+    }
     llvm::Type *memberType = context.typeManager->realize(memberTypeIdx);
-    llvm::Value *memberValue = context.builder.CreateLoad(memberType, memberPtr, "member_value");
+    llvm::LoadInst *memberValue = context.builder.CreateLoad(memberType, memberPtr, "member_value");
+    context.annotateAccess(memberValue, memberTypeIdx);
 
     return ExprCodegenResult(memberValue, memberTypeIdx);
 }
@@ -449,15 +800,19 @@ AllocCodegenResult NMemberAccess::allocgen(ASTContext &context) {
     }
 
     if (true == isPointerAccess) {
-        auto *ptrTc = dynamic_cast<const PointerTypeCodegen *>(context.typeManager->get(baseTypeIdx));
+        // `p->m` addresses the struct p points to, so load p itself and index from its value
+        TypeIdx ptrTypeIdx = context.typeManager->unqualify(baseTypeIdx);
+        auto *ptrTc = dynamic_cast<const PointerTypeCodegen *>(context.typeManager->get(ptrTypeIdx));
         if (!ptrTc) {
             return AllocCodegenResult("Failed to get pointee type for dereferencing in member access");
         }
-        TypeIdx derefTypeIdx = ptrTc->getPointeeIdx();
-        llvm::Type *derefType = context.typeManager->realize(derefTypeIdx);
-        baseValue = context.builder.CreateLoad(derefType, baseValue, "deref_base");
-        baseTypeIdx = derefTypeIdx;
+        llvm::Type *ptrType = context.typeManager->realize(baseTypeIdx);
+        llvm::LoadInst *ptrValue = context.builder.CreateLoad(ptrType, baseValue, "deref_base");
+        context.annotateAccess(ptrValue, baseTypeIdx);
+        baseValue = ptrValue;
+        baseTypeIdx = ptrTc->getPointeeIdx();
     }
+    baseTypeIdx = context.typeManager->unqualify(baseTypeIdx);
 
     auto *structTc = dynamic_cast<const StructTypeCodegen *>(context.typeManager->get(baseTypeIdx));
     if (!structTc) {
@@ -471,28 +826,41 @@ AllocCodegenResult NMemberAccess::allocgen(ASTContext &context) {
 
     TypeIdx memberTypeIdx = structTc->getMemberTypeIdx(memberIndex);
 
+    llvm::Type *structType = context.typeManager->realize(baseTypeIdx);
     std::vector<llvm::Value *> indices;
     indices.push_back(context.builder.getInt32(0));
-    indices.push_back(context.builder.getInt32(memberIndex));
+    indices.push_back(context.builder.getInt32(structTc->getElementIndex(memberIndex)));
+
+    // A bit-field has no address of its own; its lvalue is the storage unit holding it, inside the bit-field
+    // run's byte array (a union's bit-fields all start at the union itself)
+    if (true == structTc->isBitField(memberIndex)) {
+        const StructTypeCodegen::BitFieldStorage &storage = structTc->getBitFieldStorage(memberIndex);
+        if (false == structTc->isUnion()) {
+            indices.push_back(context.builder.getInt32(storage.byteOffset));
+        }
+        llvm::Value *unitPtr = context.builder.CreateGEP(structType, baseValue, indices, "bitfield_ptr");
+        return AllocCodegenResult(unitPtr, memberTypeIdx, storage.slot);
+    }
 
-    llvm::Type *structType = context.typeManager->realize(baseTypeIdx);
     llvm::Value *memberPtr = context.builder.CreateGEP(structType, baseValue, indices, "member_ptr");
 
     return AllocCodegenResult(memberPtr, memberTypeIdx);
 }
 
 ExprCodegenResult NInteger::codegen(ASTContext &context) {
-    return ExprCodegenResult(context.builder.getInt32(value), context.typeManager->getPrimitiveIdx(VAR_TYPE_INT));
+    TypeIdx typeIdx = context.typeManager->getPrimitiveIdx(varType);
+    llvm::Type *type = context.typeManager->realize(typeIdx);
+    return ExprCodegenResult(llvm::ConstantInt::get(type, static_cast<uint64_t>(value)), typeIdx);
 }
 
 ExprCodegenResult NFloat::codegen(ASTContext &context) {
-    return ExprCodegenResult(llvm::ConstantFP::get(llvm::Type::getDoubleTy(context.llvmContext), value),
-                             context.typeManager->getPrimitiveIdx(VAR_TYPE_DOUBLE));
+    TypeIdx typeIdx = context.typeManager->getPrimitiveIdx(varType);
+    return ExprCodegenResult(llvm::ConstantFP::get(context.typeManager->realize(typeIdx), value), typeIdx);
 }
 
 ExprCodegenResult NString::codegen(ASTContext &context) {
     TypeIdx charIdx = context.typeManager->getPrimitiveIdx(VAR_TYPE_CHAR);
-    return ExprCodegenResult(context.builder.CreateGlobalStringPtr(value, "string_literal"),
+    return ExprCodegenResult(context.getStringLiteral(value),
                              context.typeManager->getPointerIdx(charIdx, 1));
 }
 
@@ -519,20 +887,88 @@ CodegenResult<llvm::Value *> NDeclarator::getArraySizeValue(ASTContext &context)
 }
 
 ExprCodegenResult NArraySubscript::codegen(ASTContext &context) {
-    CodegenResult ptrResult = allocgen(context);
+    ExprCodegenResult indexResult;
+    AllocCodegenResult baseResult = basegen(context, indexResult);
+    if (false == baseResult.isSuccess()) {
+        return ExprCodegenResult("Failed to generate pointer for array subscript") << baseResult;
+    }
+
+    // A vector lane is read out of the whole vector
+    TypeIdx baseTypeIdx = context.typeManager->unqualify(baseResult.getType());
+    if (auto *vectorTc = dynamic_cast<const VectorTypeCodegen *>(context.typeManager->get(baseTypeIdx))) {
+        llvm::LoadInst *vector =
+            context.builder.CreateLoad(context.typeManager->realize(baseTypeIdx), baseResult.getAllocaInst(),
+                                       context.typeManager->isVolatileQualified(baseResult.getType()), "vector");
+        context.annotateAccess(vector, baseTypeIdx);
+        llvm::Value *lane = context.builder.CreateExtractElement(vector, indexResult.getValue(), "lane");
+        return ExprCodegenResult(lane, vectorTc->getElementIdx());
+    }
+
+    CodegenResult ptrResult = elementgen(context, baseResult, indexResult.getValue());
     if (false == ptrResult.isSuccess()) {
         return ExprCodegenResult("Failed to generate pointer for array subscript") << ptrResult;
     }
 
     TypeIdx elemTypeIdx = ptrResult.getType();
     llvm::Type *elemType = context.typeManager->realize(elemTypeIdx);
-    llvm::Value *value = context.builder.CreateLoad(elemType, ptrResult.getAllocaInst(), "arrayelem");
+    llvm::LoadInst *value = context.builder.CreateLoad(elemType, ptrResult.getAllocaInst(), "arrayelem");
+    context.annotateAccess(value, elemTypeIdx);
 
     return ExprCodegenResult(value, elemTypeIdx);
 }
 
+ExprCodegenResult NArraySubscript::assign(ASTContext &context, NExpression *value) {
+    ExprCodegenResult indexResult;
+    AllocCodegenResult baseResult = basegen(context, indexResult);
+    if (false == baseResult.isSuccess()) {
+        return ExprCodegenResult("Failed to generate lvalue for array subscript") << baseResult;
+    }
+
+    TypeIdx baseTypeIdx = context.typeManager->unqualify(baseResult.getType());
+    auto *vectorTc = dynamic_cast<const VectorTypeCodegen *>(context.typeManager->get(baseTypeIdx));
+    if (nullptr == vectorTc) {
+        AllocCodegenResult elementResult = elementgen(context, baseResult, indexResult.getValue());
+        if (false == elementResult.isSuccess()) {
+            return ExprCodegenResult("Failed to generate lvalue for array subscript") << elementResult;
+        }
+        return assignTo(context, elementResult, value);
+    }
+
+    // A vector lane is written by inserting it into the whole vector
+    if (context.typeManager->isConstQualified(baseResult.getType())) {
+        return ExprCodegenResult("Assignment to const-qualified variable");
+    }
+    ExprCodegenResult valueResult = value->codegen(context);
+    if (false == valueResult.isSuccess()) {
+        return ExprCodegenResult("Assignment failed due to null values") << valueResult;
+    }
+    TypeIdx laneIdx = vectorTc->getElementIdx();
+    ExprCodegenResult castResult =
+        context.typeManager->typeCast(valueResult.getValue(), valueResult.getType(), laneIdx, context.builder);
+    if (false == castResult.isSuccess()) {
+        return ExprCodegenResult("Type cast failed during assignment") << castResult;
+    }
+    bool isVolatile = context.typeManager->isVolatileQualified(baseResult.getType());
+    llvm::LoadInst *vector = context.builder.CreateLoad(context.typeManager->realize(baseTypeIdx),
+                                                        baseResult.getAllocaInst(), isVolatile, "vector");
+    context.annotateAccess(vector, baseTypeIdx);
+    llvm::Value *updated =
+        context.builder.CreateInsertElement(vector, castResult.getValue(), indexResult.getValue(), "insert_lane");
+    context.annotateAccess(context.builder.CreateStore(updated, baseResult.getAllocaInst(), isVolatile), baseTypeIdx);
+    return ExprCodegenResult(castResult.getValue(), laneIdx);
+}
+
 AllocCodegenResult NArraySubscript::allocgen(ASTContext &context) {
-    CodegenResult indexResult = index->codegen(context);
+    ExprCodegenResult indexResult;
+    AllocCodegenResult baseResult = basegen(context, indexResult);
+    if (false == baseResult.isSuccess()) {
+        return baseResult;
+    }
+    return elementgen(context, baseResult, indexResult.getValue());
+}
+
+AllocCodegenResult NArraySubscript::basegen(ASTContext &context, ExprCodegenResult &indexResult) {
+    indexResult = index->codegen(context);
     if (false == indexResult.isSuccess()) {
         return AllocCodegenResult("Failed to generate code for array index expression") << indexResult;
     }
@@ -541,16 +977,20 @@ AllocCodegenResult NArraySubscript::allocgen(ASTContext &context) {
     if (false == arrayResult.isSuccess()) {
         return AllocCodegenResult("Failed to generate lvalue for array in subscript operation") << arrayResult;
     }
+    return arrayResult;
+}
 
-    llvm::Value *basePtr = arrayResult.getAllocaInst();
-    TypeIdx arrayTypeIdx = arrayResult.getType();
+AllocCodegenResult NArraySubscript::elementgen(ASTContext &context, const AllocCodegenResult &baseResult,
+                                               llvm::Value *indexValue) {
+    llvm::Value *basePtr = baseResult.getAllocaInst();
+    TypeIdx arrayTypeIdx = context.typeManager->unqualify(baseResult.getType());
     llvm::Type *arrayType = context.typeManager->realize(arrayTypeIdx);
 
     if (auto *arrTc = dynamic_cast<const ArrayTypeCodegen *>(context.typeManager->get(arrayTypeIdx))) {
         TypeIdx elementTypeIdx = arrTc->getElementIdx();
         std::vector<llvm::Value *> indices(2);
         indices[0] = context.builder.getInt32(0);
-        indices[1] = indexResult.getValue();
+        indices[1] = indexValue;
 
         llvm::Value *elementPtr = context.builder.CreateGEP(arrayType, basePtr, indices, "arrayidx");
 
@@ -559,10 +999,17 @@ AllocCodegenResult NArraySubscript::allocgen(ASTContext &context) {
         TypeIdx elementTypeIdx = ptrTc->getPointeeIdx();
         llvm::Type *elementType = context.typeManager->realize(elementTypeIdx);
 
-        llvm::Value *ptrValue = context.builder.CreateLoad(arrayType, basePtr, "load_ptr");
-        llvm::Value *elementPtr = context.builder.CreateGEP(elementType, ptrValue, indexResult.getValue(), "ptridx");
+        llvm::LoadInst *ptrValue = context.builder.CreateLoad(arrayType, basePtr, "load_ptr");
+        context.annotateAccess(ptrValue, arrayTypeIdx);
+        llvm::Value *elementPtr = context.builder.CreateGEP(elementType, ptrValue, indexValue, "ptridx");
 
         return AllocCodegenResult(elementPtr, elementTypeIdx);
+    } else if (auto *vectorTc = dynamic_cast<const VectorTypeCodegen *>(context.typeManager->get(arrayTypeIdx))) {
+        // Only for lane updates that need an address (compound assignment, ++, &); plain reads and stores
+        // extract and insert the lane instead
+        llvm::Value *lanePtr = context.builder.CreateGEP(arrayType, basePtr, {context.builder.getInt32(0), indexValue},
+                                                         "laneidx");
+        return AllocCodegenResult(lanePtr, vectorTc->getElementIdx());
     }
 
     std::string typeName = context.typeManager->getTypeName(arrayType);
@@ -630,26 +1077,97 @@ ExprCodegenResult NCompoundAssignment::codegen(ASTContext &context) {
     if (false == lhsAllocResult.isSuccess()) {
         return ExprCodegenResult("Failed to get lvalue for compound assignment") << lhsAllocResult;
     }
-    llvm::AllocaInst *lhsAlloca = static_cast<llvm::AllocaInst *>(lhsAllocResult.getAllocaInst());
+    llvm::Value *lhsAlloca = lhsAllocResult.getAllocaInst();
     TypeIdx lhsTypeIdx = lhsAllocResult.getType();
 
     if (context.typeManager->isConstQualified(lhsTypeIdx)) {
         return ExprCodegenResult("Compound assignment to const-qualified variable");
     }
 
+    // On an _Atomic object the whole compound assignment is one atomic read-modify-write. +=, -=, &=, |= and ^=
+    // of an integer rhs map onto atomicrmw directly; everything else, such as `x += 0.5` which is computed in
+    // double, retries a cmpxchg of the recomputed value. The rhs is evaluated first to tell the two apart.
+    bool isAtomic = context.typeManager->isAtomicQualified(lhsTypeIdx);
+    llvm::Type *lhsType = context.typeManager->realize(lhsTypeIdx);
+    static const std::map<BineryOperator, std::pair<llvm::AtomicRMWInst::BinOp, llvm::Instruction::BinaryOps>>
+        atomicOperations = {{ADD, {llvm::AtomicRMWInst::Add, llvm::Instruction::Add}},
+                            {SUB, {llvm::AtomicRMWInst::Sub, llvm::Instruction::Sub}},
+                            {BIT_AND, {llvm::AtomicRMWInst::And, llvm::Instruction::And}},
+                            {BIT_OR, {llvm::AtomicRMWInst::Or, llvm::Instruction::Or}},
+                            {XOR, {llvm::AtomicRMWInst::Xor, llvm::Instruction::Xor}}};
+    auto atomicOperation = atomicOperations.find(op);
+    ExprCodegenResult rhsResult;
+    if (true == isAtomic) {
+        rhsResult = rhs->codegen(context);
+        if (false == rhsResult.isSuccess()) {
+            return ExprCodegenResult("Failed to evaluate rhs of compound assignment") << rhsResult;
+        }
+    }
+    if (true == isAtomic && lhsType->isIntegerTy() && true == context.typeManager->isIntegerType(rhsResult.getType()) &&
+        atomicOperations.end() != atomicOperation) {
+        TypeIdx valueTypeIdx = context.typeManager->unqualify(lhsTypeIdx);
+        CodegenResult castResult =
+            context.typeManager->typeCast(rhsResult.getValue(), rhsResult.getType(), valueTypeIdx, context.builder);
+        if (false == castResult.isSuccess()) {
+            return ExprCodegenResult("Type cast failed for rhs in compound assignment") << castResult;
+        }
+        llvm::Value *old =
+            context.builder.CreateAtomicRMW(atomicOperation->second.first, lhsAlloca, castResult.getValue(),
+                                            llvm::MaybeAlign(), llvm::AtomicOrdering::SequentiallyConsistent);
+        return ExprCodegenResult(
+            context.builder.CreateBinOp(atomicOperation->second.second, old, castResult.getValue()), lhsTypeIdx);
+    }
+
     // Load current value of lhs
     bool isVolatile = context.typeManager->isVolatileQualified(lhsTypeIdx);
-    llvm::Type *lhsType = context.typeManager->realize(lhsTypeIdx);
-    llvm::Value *lhsValue = context.builder.CreateLoad(lhsType, lhsAlloca, isVolatile, "compound_lhs");
+    bool isBitField = 0 != lhsAllocResult.getBitField().width;
+    llvm::LoadInst *lhsLoad = nullptr;
+    llvm::Value *lhsValue = nullptr;
+    if (true == isBitField) {
+        lhsValue = context.loadBitField(lhsAllocResult);
+    } else {
+        lhsLoad = context.builder.CreateLoad(lhsType, lhsAlloca, isVolatile, "compound_lhs");
+        context.annotateAccess(lhsLoad, lhsTypeIdx);
+        lhsValue = lhsLoad;
+    }
 
     // Evaluate rhs
-    ExprCodegenResult rhsResult = rhs->codegen(context);
-    if (false == rhsResult.isSuccess()) {
-        return ExprCodegenResult("Failed to evaluate rhs of compound assignment") << rhsResult;
+    if (false == isAtomic) {
+        rhsResult = rhs->codegen(context);
+        if (false == rhsResult.isSuccess()) {
+            return ExprCodegenResult("Failed to evaluate rhs of compound assignment") << rhsResult;
+        }
     }
     llvm::Value *rhsValue = rhsResult.getValue();
     TypeIdx rhsTypeIdx = rhsResult.getType();
 
+    // The cmpxchg loop recomputes from the value it last observed in memory
+    llvm::PHINode *observed = nullptr;
+    if (true == isAtomic) {
+        llvm::BasicBlock *loadBlock = context.builder.GetInsertBlock();
+        llvm::BasicBlock *retryBlock =
+            llvm::BasicBlock::Create(context.llvmContext, "atomic_retry", loadBlock->getParent());
+        context.builder.CreateBr(retryBlock);
+        context.builder.SetInsertPoint(retryBlock);
+        observed = context.builder.CreatePHI(lhsType, 2, "atomic_observed");
+        observed->addIncoming(lhsLoad, loadBlock);
+        lhsValue = observed;
+    }
+
+    if (true == context.typeManager->isVectorType(lhsTypeIdx) ||
+        true == context.typeManager->isVectorType(rhsTypeIdx)) {
+        ExprCodegenResult vectorResult =
+            createVectorOperation(context, op, lhsValue, lhsTypeIdx, rhsValue, rhsTypeIdx);
+        if (false == vectorResult.isSuccess()) {
+            return ExprCodegenResult("Vector operation failed in compound assignment") << vectorResult;
+        }
+        if (vectorResult.getType() != context.typeManager->unqualify(lhsTypeIdx)) {
+            return ExprCodegenResult("Cannot compound-assign a vector result to a scalar");
+        }
+        context.annotateAccess(context.builder.CreateStore(vectorResult.getValue(), lhsAlloca, isVolatile), lhsTypeIdx);
+        return vectorResult;
+    }
+
     // Promote both to common type for the operation
     TypeIdx commonTypeIdx = context.typeManager->getCommonTypeIdx(lhsTypeIdx, rhsTypeIdx);
 
@@ -666,52 +1184,9 @@ ExprCodegenResult NCompoundAssignment::codegen(ASTContext &context) {
     rhsValue = castRhsResult.getValue();
 
     // Apply binary operation
-    llvm::Value *result = nullptr;
-    switch (op) {
-        case ADD:
-            if (context.typeManager->isFloatingPointType(commonTypeIdx))
-                result = context.builder.CreateFAdd(lhsValue, rhsValue, "add");
-            else
-                result = context.builder.CreateAdd(lhsValue, rhsValue, "add");
-            break;
-        case SUB:
-            if (context.typeManager->isFloatingPointType(commonTypeIdx))
-                result = context.builder.CreateFSub(lhsValue, rhsValue, "sub");
-            else
-                result = context.builder.CreateSub(lhsValue, rhsValue, "sub");
-            break;
-        case MUL:
-            if (context.typeManager->isFloatingPointType(commonTypeIdx))
-                result = context.builder.CreateFMul(lhsValue, rhsValue, "mul");
-            else
-                result = context.builder.CreateMul(lhsValue, rhsValue, "mul");
-            break;
-        case DIV:
-            if (context.typeManager->isFloatingPointType(commonTypeIdx))
-                result = context.builder.CreateFDiv(lhsValue, rhsValue, "div");
-            else
-                result = context.builder.CreateSDiv(lhsValue, rhsValue, "div");
-            break;
-        case MOD:
-            result = context.builder.CreateSRem(lhsValue, rhsValue, "mod");
-            break;
-        case LEFT:
-            result = context.builder.CreateShl(lhsValue, rhsValue, "left");
-            break;
-        case RIGHT:
-            result = context.builder.CreateLShr(lhsValue, rhsValue, "right");
-            break;
-        case BIT_AND:
-            result = context.builder.CreateAnd(lhsValue, rhsValue, "bit_and");
-            break;
-        case BIT_OR:
-            result = context.builder.CreateOr(lhsValue, rhsValue, "bit_or");
-            break;
-        case XOR:
-            result = context.builder.CreateXor(lhsValue, rhsValue, "xor");
-            break;
-        default:
-            return ExprCodegenResult("Unknown operator in compound assignment");
+    llvm::Value *result = createArithmetic(context, op, lhsValue, rhsValue, commonTypeIdx);
+    if (nullptr == result) {
+        return ExprCodegenResult("Unknown operator in compound assignment");
     }
 
     // Cast result back to lhs type and store
@@ -721,7 +1196,29 @@ ExprCodegenResult NCompoundAssignment::codegen(ASTContext &context) {
     }
     result = castBackResult.getValue();
 
-    context.builder.CreateStore(result, lhsAlloca, isVolatile);
+    if (true == isAtomic) {
+        // cmpxchg compares bits, so floating-point values travel as same-sized integers
+        llvm::Type *bitsType = lhsType->isFloatingPointTy()
+                                   ? llvm::Type::getIntNTy(context.llvmContext, lhsType->getPrimitiveSizeInBits())
+                                   : lhsType;
+        llvm::Value *exchange = context.builder.CreateAtomicCmpXchg(
+            lhsAlloca, context.builder.CreateBitCast(observed, bitsType),
+            context.builder.CreateBitCast(result, bitsType), llvm::MaybeAlign(),
+            llvm::AtomicOrdering::SequentiallyConsistent, llvm::AtomicOrdering::SequentiallyConsistent);
+        llvm::Value *current = context.builder.CreateBitCast(context.builder.CreateExtractValue(exchange, 0), lhsType);
+        observed->addIncoming(current, context.builder.GetInsertBlock());
+        llvm::BasicBlock *doneBlock = llvm::BasicBlock::Create(context.llvmContext, "atomic_done",
+                                                               context.builder.GetInsertBlock()->getParent());
+        context.builder.CreateCondBr(context.builder.CreateExtractValue(exchange, 1), doneBlock,
+                                     observed->getParent());
+        context.builder.SetInsertPoint(doneBlock);
+        return ExprCodegenResult(result, lhsTypeIdx);
+    }
+
+    if (true == isBitField) {
+        return ExprCodegenResult(context.storeBitField(lhsAllocResult, result), lhsTypeIdx);
+    }
+    context.annotateAccess(context.builder.CreateStore(result, lhsAlloca, isVolatile), lhsTypeIdx);
     return ExprCodegenResult(result, lhsTypeIdx);
 }
 
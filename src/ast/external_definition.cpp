@@ -1,8 +1,18 @@
 #include "ast/external_definition.hpp"
 
+#include <llvm/ADT/DepthFirstIterator.h>
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/GlobalIFunc.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/IntrinsicInst.h>
+#include <llvm/IR/PassManager.h>
 #include <llvm/IR/Verifier.h>
+#include <llvm/Transforms/Scalar/LowerExpectIntrinsic.h>
+#include <llvm/Transforms/Utils/Cloning.h>
 
+#include <algorithm>
 #include <iostream>
+#include <sstream>
 
 #include "utility/raii_guard.hpp"
 
@@ -10,7 +20,67 @@ using namespace toyc::ast;
 
 NFunctionDefinition::~NFunctionDefinition() = default;
 
+// Splits a comma-separated `target`/`target_clones` argument into its trimmed entries
+static std::vector<std::string> splitTargetList(const std::string &list) {
+    std::vector<std::string> entries;
+    std::stringstream stream(list);
+    std::string entry;
+    while (std::getline(stream, entry, ',')) {
+        size_t first = entry.find_first_not_of(" \t");
+        size_t last = entry.find_last_not_of(" \t");
+        entries.push_back(std::string::npos == first ? "" : entry.substr(first, last - first + 1));
+    }
+    return entries;
+}
+
+// Adds a GCC target string ("avx2,fma", "no-avx", "arch=haswell") to the function's target-cpu, tune-cpu and
+// target-features attributes, so the backend may use those instructions in this function alone
+static StmtCodegenResult addTargetFeatures(llvm::Function *function, const std::string &target) {
+    std::string features = function->getFnAttribute("target-features").getValueAsString().str();
+    for (std::string entry : splitTargetList(target)) {
+        if (0 == entry.compare(0, 5, "arch=")) {
+            function->addFnAttr("target-cpu", entry.substr(5));
+            continue;
+        }
+        if (0 == entry.compare(0, 5, "tune=")) {
+            function->addFnAttr("tune-cpu", entry.substr(5));
+            continue;
+        }
+        bool enable = 0 != entry.compare(0, 3, "no-");
+        if (false == enable) {
+            entry = entry.substr(3);
+        }
+        if (entry.empty() || std::string::npos != entry.find_first_not_of("abcdefghijklmnopqrstuvwxyz0123456789.-_")) {
+            return StmtCodegenResult("Invalid target option '" + target + "'");
+        }
+        // GCC's sse4 is SSE4.1 plus SSE4.2
+        if ("sse4" == entry) {
+            entry = true == enable ? "sse4.2" : "sse4.1";
+        }
+        features += (features.empty() ? "" : ",") + std::string(true == enable ? "+" : "-") + entry;
+    }
+    if (false == features.empty()) {
+        function->addFnAttr("target-features", features);
+    }
+    return StmtCodegenResult();
+}
+
+llvm::FunctionCallee NFunctionDefinition::getCallee() const {
+    if (nullptr != dispatcher) {
+        return llvm::FunctionCallee(llvmFunction->getFunctionType(), dispatcher);
+    }
+    return llvmFunction;
+}
+
 StmtCodegenResult NFunctionDefinition::codegen(ASTContext &context) {
+    // Once a target_clones definition has given its name to an ifunc, later prototypes keep calling through that
+    if (nullptr != context.module.getNamedIFunc(name)) {
+        if (nullptr != body) {
+            return StmtCodegenResult("Redefinition of function " + name);
+        }
+        return StmtCodegenResult();
+    }
+
     returnType = context.typeManager->realize(returnTypeIdx);
     if (!returnType) {
         return StmtCodegenResult("Failed to realize return type");
@@ -21,6 +91,24 @@ StmtCodegenResult NFunctionDefinition::codegen(ASTContext &context) {
     llvm::FunctionType *functionType = nullptr;
     bool isVariadic = false;
 
+    // Structs and unions are lowered to what the System V ABI passes, so calls link against gcc-built code
+    ArgumentRegisters registers;
+    llvm::Type *llvmReturnType = returnType;
+    llvm::Type *pointerType = context.builder.getPtrTy();
+    returnPassing = context.typeManager->classifyReturn(returnTypeIdx);
+    paramPassing.clear();
+    if (ArgumentPassing::Indirect == returnPassing.kind) {
+        paramTypes.push_back(pointerType);
+        registers.integer--;
+        llvmReturnType = llvm::Type::getVoidTy(context.llvmContext);
+    } else if (ArgumentPassing::Coerced == returnPassing.kind) {
+        llvmReturnType = (1 == returnPassing.pieces.size())
+                             ? returnPassing.pieces.front()
+                             : llvm::StructType::get(context.llvmContext, returnPassing.pieces);
+    } else if (ArgumentPassing::Ignored == returnPassing.kind) {
+        llvmReturnType = llvm::Type::getVoidTy(context.llvmContext);
+    }
+
     for (NParameter *paramIt = params.get(); paramIt != nullptr; paramIt = paramIt->next.get()) {
         if (true == paramIt->isVariadic) {
             isVariadic = true;
@@ -32,28 +120,72 @@ StmtCodegenResult NFunctionDefinition::codegen(ASTContext &context) {
             return StmtCodegenResult("Failed to realize parameter type");
         }
 
-        paramTypes.push_back(paramType);
+        ArgumentPassing passing = context.typeManager->classifyArgument(paramIt->getTypeIdx(), registers);
+        if (ArgumentPassing::Direct == passing.kind) {
+            paramTypes.push_back(paramType);
+        } else if (ArgumentPassing::Coerced == passing.kind) {
+            paramTypes.insert(paramTypes.end(), passing.pieces.begin(), passing.pieces.end());
+        } else if (ArgumentPassing::Indirect == passing.kind) {
+            paramTypes.push_back(pointerType);
+        }
+        paramPassing.push_back(std::move(passing));
         paramNames.push_back(paramIt->getName());
     }
 
-    functionType = llvm::FunctionType::get(returnType, paramTypes, isVariadic);
+    functionType = llvm::FunctionType::get(llvmReturnType, paramTypes, isVariadic);
     llvmFunction = static_cast<llvm::Function *>(context.module.getOrInsertFunction(name, functionType).getCallee());
     if (nullptr == llvmFunction) {
         return StmtCodegenResult("Function creation failed for " + name);
     }
-
-    NParameter *paramIt = params.get();
-    for (auto it = llvmFunction->arg_begin(); it != llvmFunction->arg_end() && paramIt != nullptr; ++it) {
-        it->setName(paramIt->getName());
-        paramIt = paramIt->next.get();
-    }
+    applyPassingAttributes(context);
 
     context.functionDefinitions[name] = this;
 
+    StmtCodegenResult attributeResult = applyAttributes();
+    if (false == attributeResult.isSuccess()) {
+        return StmtCodegenResult("Invalid attributes on function " + name) << attributeResult;
+    }
+
     if (nullptr == body) {
         return StmtCodegenResult();
     }
 
+    // A static function is invisible outside this module, so unused copies can be dropped once inlined.
+    // Plain `inline` only hints the inliner; the definition is still emitted with external linkage.
+    if (STORAGE_STATIC == storageClass) {
+        llvmFunction->setLinkage(llvm::GlobalValue::InternalLinkage);
+    }
+    if (true == isInline) {
+        llvmFunction->addFnAttr(llvm::Attribute::InlineHint);
+    }
+    // Tell TargetLibraryInfo not to synthesize library calls (e.g. a copy loop into memcpy) that were switched off
+    if (false == context.options.libraryBuiltins) {
+        llvmFunction->addFnAttr("no-builtins");
+    }
+    for (const std::string &builtin : context.options.noBuiltinFunctions) {
+        llvmFunction->addFnAttr("no-builtin-" + builtin);
+    }
+    // Every floating-point instruction in the body carries the fast-math flags; the backend reads the same
+    // relaxations from these attributes, e.g. to lower a division by a constant to a multiplication
+    const llvm::FastMathFlags &fastMath = context.options.fastMath;
+    context.builder.setFastMathFlags(fastMath);
+    if (true == fastMath.noNaNs()) {
+        llvmFunction->addFnAttr("no-nans-fp-math", "true");
+    }
+    if (true == fastMath.noInfs()) {
+        llvmFunction->addFnAttr("no-infs-fp-math", "true");
+    }
+    if (true == fastMath.noSignedZeros()) {
+        llvmFunction->addFnAttr("no-signed-zeros-fp-math", "true");
+    }
+    if (true == fastMath.approxFunc()) {
+        llvmFunction->addFnAttr("approx-func-fp-math", "true");
+    }
+    if (true == fastMath.allowReassoc() && true == fastMath.allowReciprocal() && true == fastMath.noSignedZeros() &&
+        true == fastMath.approxFunc()) {
+        llvmFunction->addFnAttr("unsafe-fp-math", "true");
+    }
+
     context.currentFunction = this;
     context.isInitializingFunction = true;
     body->setName("entry");
@@ -64,6 +196,64 @@ StmtCodegenResult NFunctionDefinition::codegen(ASTContext &context) {
     }
     context.currentFunction = nullptr;
     context.isInitializingFunction = false;
+    StmtCodegenResult finalizeResult = finalizeBody(context);
+    if (true == finalizeResult.isSuccess() && false == cloneFeatures.empty()) {
+        emitTargetClones(context);
+    }
+    return finalizeResult;
+}
+
+void NFunctionDefinition::applyPassingAttributes(ASTContext &context) {
+    TypeManager &typeManager = *context.typeManager;
+    auto argument = llvmFunction->arg_begin();
+    if (ArgumentPassing::Indirect == returnPassing.kind) {
+        argument->setName("result_slot");
+        argument->addAttr(llvm::Attribute::getWithStructRetType(context.llvmContext, returnType));
+        argument->addAttr(llvm::Attribute::NoAlias);
+        ++argument;
+    }
+
+    NParameter *paramIt = params.get();
+    for (const ArgumentPassing &passing : paramPassing) {
+        TypeIdx paramTypeIdx = paramIt->getTypeIdx();
+        if (ArgumentPassing::Coerced == passing.kind) {
+            for (size_t i = 0; i < passing.pieces.size(); i++, ++argument) {
+                argument->setName(paramIt->getName() + ".coerce" + std::to_string(i));
+            }
+        } else if (ArgumentPassing::Indirect == passing.kind) {
+            // The caller copies the object onto the stack; the callee works on that copy in place
+            argument->setName(paramIt->getName());
+            argument->addAttr(
+                llvm::Attribute::getWithByValType(context.llvmContext, typeManager.realize(paramTypeIdx)));
+            argument->addAttr(llvm::Attribute::getWithAlignment(
+                context.llvmContext, llvm::Align(std::max<uint64_t>(8, typeManager.getAlignment(paramTypeIdx)))));
+            ++argument;
+        } else if (ArgumentPassing::Direct == passing.kind) {
+            argument->setName(paramIt->getName());
+            // A restrict pointer parameter is the only way the callee reaches the object it points to
+            if (true == typeManager.isRestrictQualified(paramTypeIdx)) {
+                argument->addAttr(llvm::Attribute::NoAlias);
+            }
+            ++argument;
+        }
+        paramIt = paramIt->next.get();
+    }
+}
+
+StmtCodegenResult NFunctionDefinition::finalizeBody(ASTContext &context) {
+    // Code after a return or __builtin_unreachable lands in blocks control never reaches
+    llvm::df_iterator_default_set<llvm::BasicBlock *> reachable;
+    for (llvm::BasicBlock *block : llvm::depth_first_ext(&llvmFunction->getEntryBlock(), reachable)) {
+        (void)block;
+    }
+    for (llvm::BasicBlock &block : *llvmFunction) {
+        if (nullptr == block.getTerminator() && 0 == reachable.count(&block)) {
+            context.builder.SetInsertPoint(&block);
+            context.builder.CreateUnreachable();
+        }
+    }
+    context.alignPackedAccesses(llvmFunction);
+    flattenCalls();
 
     // Resolve pending goto statements
     if (!context.pendingGotos.empty()) {
@@ -76,5 +266,150 @@ StmtCodegenResult NFunctionDefinition::codegen(ASTContext &context) {
         return StmtCodegenResult(ErrorOS.str());
     }
 
+    // Fold __builtin_expect into !prof branch weights while the branches still test it directly
+    llvm::FunctionAnalysisManager analysisManager;
+    llvm::LowerExpectIntrinsicPass().run(*llvmFunction, analysisManager);
+
+    return StmtCodegenResult();
+}
+
+StmtCodegenResult NFunctionDefinition::applyAttributes() {
+    for (const GnuAttribute &attribute : attributes) {
+        if ("hot" == attribute.name) {
+            llvmFunction->addFnAttr(llvm::Attribute::Hot);
+        } else if ("cold" == attribute.name) {
+            llvmFunction->addFnAttr(llvm::Attribute::Cold);
+        } else if ("noinline" == attribute.name) {
+            llvmFunction->addFnAttr(llvm::Attribute::NoInline);
+        } else if ("always_inline" == attribute.name) {
+            llvmFunction->addFnAttr(llvm::Attribute::AlwaysInline);
+        } else if ("pure" == attribute.name) {
+            // No side effects; the result depends on the arguments and on memory it may read
+            llvmFunction->setOnlyReadsMemory();
+            llvmFunction->setDoesNotThrow();
+        } else if ("const" == attribute.name) {
+            // The result depends on the arguments alone
+            llvmFunction->setDoesNotAccessMemory();
+            llvmFunction->setDoesNotThrow();
+        } else if ("flatten" == attribute.name) {
+            // Handled per call site once the body exists
+        } else if ("target" == attribute.name) {
+            for (const std::string &argument : attribute.arguments) {
+                StmtCodegenResult targetResult = addTargetFeatures(llvmFunction, argument);
+                if (false == targetResult.isSuccess()) {
+                    return targetResult;
+                }
+            }
+        } else if ("target_clones" == attribute.name) {
+            // Versions are cloned once the body exists
+        } else {
+            std::cerr << "Warning: unsupported attribute '" << attribute.name << "' on function " << name
+                      << " ignored" << std::endl;
+        }
+    }
+
+    if (llvmFunction->hasFnAttribute(llvm::Attribute::Hot) && llvmFunction->hasFnAttribute(llvm::Attribute::Cold)) {
+        return StmtCodegenResult("'hot' and 'cold' attributes are mutually exclusive");
+    }
+    if (llvmFunction->hasFnAttribute(llvm::Attribute::NoInline) &&
+        llvmFunction->hasFnAttribute(llvm::Attribute::AlwaysInline)) {
+        return StmtCodegenResult("'noinline' and 'always_inline' attributes are mutually exclusive");
+    }
+    return parseTargetClones();
+}
+
+StmtCodegenResult NFunctionDefinition::parseTargetClones() {
+    cloneFeatures.clear();
+    bool hasClones = false;
+    bool hasDefault = false;
+    bool hasTarget = false;
+    for (const GnuAttribute &attribute : attributes) {
+        hasTarget = hasTarget || "target" == attribute.name;
+        if ("target_clones" != attribute.name) {
+            continue;
+        }
+        hasClones = true;
+        for (const std::string &argument : attribute.arguments) {
+            for (const std::string &option : splitTargetList(argument)) {
+                if ("default" == option) {
+                    hasDefault = true;
+                    continue;
+                }
+                // The resolver picks a version with __builtin_cpu_supports, so each option must be one it can test
+                const CpuFeature *feature = findCpuFeature(option);
+                if (nullptr == feature) {
+                    return StmtCodegenResult("target_clones option '" + option +
+                                             "' is not a CPU feature that can be detected at run time");
+                }
+                if (cloneFeatures.end() != std::find(cloneFeatures.begin(), cloneFeatures.end(), feature)) {
+                    return StmtCodegenResult("Duplicate target_clones option '" + option + "'");
+                }
+                cloneFeatures.push_back(feature);
+            }
+        }
+    }
+    if (true == hasClones && false == hasDefault) {
+        return StmtCodegenResult("target_clones needs a 'default' version");
+    }
+    if (true == hasClones && true == hasTarget) {
+        return StmtCodegenResult("'target' and 'target_clones' attributes are mutually exclusive");
+    }
+    std::sort(cloneFeatures.begin(), cloneFeatures.end(),
+              [](const CpuFeature *a, const CpuFeature *b) { return a->priority < b->priority; });
     return StmtCodegenResult();
 }
+
+// Copies the finished body once per target_clones feature and renames the original `name.default`. The name
+// itself becomes an ifunc, whose resolver runs when the dynamic linker binds it and returns the most preferred
+// version the CPU supports.
+void NFunctionDefinition::emitTargetClones(ASTContext &context) {
+    llvm::GlobalValue::LinkageTypes linkage = llvmFunction->getLinkage();
+    std::vector<llvm::Function *> versions;
+    for (const CpuFeature *feature : cloneFeatures) {
+        llvm::ValueToValueMapTy valueMap;
+        llvm::Function *version = llvm::CloneFunction(llvmFunction, valueMap);
+        version->setName(name + "." + feature->name);
+        version->setLinkage(llvm::GlobalValue::InternalLinkage);
+        addTargetFeatures(version, feature->name);
+        versions.push_back(version);
+    }
+    llvmFunction->setName(name + ".default");
+    llvmFunction->setLinkage(llvm::GlobalValue::InternalLinkage);
+
+    llvm::FunctionType *resolverType = llvm::FunctionType::get(context.builder.getPtrTy(), false);
+    llvm::Function *resolver = llvm::Function::Create(resolverType, llvm::GlobalValue::InternalLinkage,
+                                                      name + ".resolver", context.module);
+    resolver->addFnAttr(llvm::Attribute::NoUnwind);
+    dispatcher =
+        llvm::GlobalIFunc::create(llvmFunction->getFunctionType(), 0, linkage, name, resolver, &context.module);
+    // Calls emitted so far, including recursive calls inside the versions, go through the ifunc as well
+    llvmFunction->replaceAllUsesWith(dispatcher);
+
+    llvm::IRBuilderBase::InsertPointGuard guard(context.builder);
+    context.builder.SetInsertPoint(llvm::BasicBlock::Create(context.llvmContext, "entry", resolver));
+    emitCpuInit(context);
+    llvm::Value *chosen = llvmFunction;
+    for (size_t i = 0; i < versions.size(); i++) {
+        chosen = context.builder.CreateSelect(emitCpuSupports(context, *cloneFeatures[i]), versions[i], chosen,
+                                              "version");
+    }
+    context.builder.CreateRet(chosen);
+}
+
+void NFunctionDefinition::flattenCalls() {
+    bool isFlatten = std::any_of(attributes.begin(), attributes.end(),
+                                 [](const GnuAttribute &attribute) { return "flatten" == attribute.name; });
+    if (false == isFlatten) {
+        return;
+    }
+    // flatten inlines every call made from this body, but leaves the callees themselves alone
+    for (llvm::Instruction &inst : llvm::instructions(*llvmFunction)) {
+        auto *call = llvm::dyn_cast<llvm::CallInst>(&inst);
+        if (nullptr == call || llvm::isa<llvm::IntrinsicInst>(call) || nullptr == call->getCalledFunction()) {
+            continue;
+        }
+        if (false == call->getCalledFunction()->hasFnAttribute(llvm::Attribute::NoInline)) {
+            call->addFnAttr(llvm::Attribute::AlwaysInline);
+        }
+    }
+}
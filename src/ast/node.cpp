@@ -1,7 +1,157 @@
 #include "ast/node.hpp"
 
+#include <llvm/Analysis/CaptureTracking.h>
+#include <llvm/Analysis/ValueTracking.h>
+#include <llvm/IR/GetElementPtrTypeIterator.h>
+#include <llvm/IR/InstIterator.h>
+#include <llvm/IR/IntrinsicInst.h>
+
+#include "ast/external_definition.hpp"
+
 namespace toyc::ast {
 
+namespace {
+
+enum class MemoryEffect { None, Read, Unknown };
+
+// The callee's byval copy of an argument is as private to the call as its allocas
+bool isLocalAddress(llvm::Value* address) {
+    llvm::Value* object = llvm::getUnderlyingObject(address);
+    auto* argument = llvm::dyn_cast<llvm::Argument>(object);
+    return llvm::isa<llvm::AllocaInst>(object) || (nullptr != argument && argument->hasByValAttr());
+}
+
+// What a function does to memory its caller can observe. Traffic through its own allocas is private to
+// the call; any other plain load is a read, and any other store, volatile or atomic access or opaque call is
+// unknown. An atomic load synchronizes with other threads, so two calls that make one cannot be merged.
+MemoryEffect summarizeMemoryEffect(llvm::Function& function) {
+    MemoryEffect effect = MemoryEffect::None;
+    for (llvm::Instruction& inst : llvm::instructions(function)) {
+        if (auto* load = llvm::dyn_cast<llvm::LoadInst>(&inst)) {
+            if (false == load->isUnordered()) {
+                return MemoryEffect::Unknown;
+            }
+            if (false == isLocalAddress(load->getPointerOperand())) {
+                effect = MemoryEffect::Read;
+            }
+        } else if (auto* store = llvm::dyn_cast<llvm::StoreInst>(&inst)) {
+            if (true == store->isVolatile() || false == isLocalAddress(store->getPointerOperand())) {
+                return MemoryEffect::Unknown;
+            }
+        } else if (auto* call = llvm::dyn_cast<llvm::CallBase>(&inst)) {
+            auto* intrinsic = llvm::dyn_cast<llvm::IntrinsicInst>(call);
+            if ((nullptr != intrinsic && intrinsic->isLifetimeStartOrEnd()) || call->doesNotAccessMemory()) {
+                continue;
+            }
+            if (false == call->onlyReadsMemory()) {
+                return MemoryEffect::Unknown;
+            }
+            effect = MemoryEffect::Read;
+        } else if (true == inst.mayReadOrWriteMemory()) {
+            return MemoryEffect::Unknown;
+        }
+    }
+    return effect;
+}
+
+// Follows a pointer parameter and every reload of its home slot. Storing a copy back into the home slot
+// (as `p++` does) keeps it inside the call; any other capturing use lets the pointer outlive the call.
+class ParameterCaptureTracker : public llvm::CaptureTracker {
+public:
+    explicit ParameterCaptureTracker(const llvm::Value* home) : home(home) {}
+    void tooManyUses() override { isCaptured = true; }
+    bool captured(const llvm::Use* use) override {
+        auto* store = llvm::dyn_cast<llvm::StoreInst>(use->getUser());
+        if (nullptr != store && home == store->getPointerOperand() && false == store->isVolatile()) {
+            return false;
+        }
+        isCaptured = true;
+        return true;
+    }
+
+    bool isCaptured = false;
+
+private:
+    const llvm::Value* home;
+};
+
+// Every parameter is spilled to an entry alloca and reloaded on use, so a parameter is nocapture only if its
+// home slot is used for nothing but plain loads and stores and neither the argument nor a reload escapes.
+bool isParameterCaptured(llvm::Argument& argument) {
+    if (false == argument.hasOneUse()) {
+        return false == argument.use_empty();
+    }
+    auto* spill = llvm::dyn_cast<llvm::StoreInst>(argument.user_back());
+    if (nullptr == spill || &argument != spill->getValueOperand()) {
+        return true;
+    }
+    auto* home = llvm::dyn_cast<llvm::AllocaInst>(spill->getPointerOperand());
+    if (nullptr == home) {
+        return true;
+    }
+
+    ParameterCaptureTracker tracker(home);
+    for (llvm::User* user : home->users()) {
+        if (auto* intrinsic = llvm::dyn_cast<llvm::IntrinsicInst>(user)) {
+            if (false == intrinsic->isLifetimeStartOrEnd()) {
+                return true;
+            }
+        } else if (auto* load = llvm::dyn_cast<llvm::LoadInst>(user)) {
+            llvm::PointerMayBeCaptured(load, &tracker);
+        } else if (auto* store = llvm::dyn_cast<llvm::StoreInst>(user)) {
+            if (home == store->getValueOperand()) {
+                return true;
+            }
+        } else {
+            return true;
+        }
+        if (true == tracker.isCaptured) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// A call may be marked `tail` only if it cannot reach the caller's stack: no alloca escapes the function
+// and no argument points into one.
+void markTailCalls(llvm::Function& function) {
+    for (llvm::Instruction& inst : llvm::instructions(function)) {
+        if (auto* allocaInst = llvm::dyn_cast<llvm::AllocaInst>(&inst)) {
+            if (true == llvm::PointerMayBeCaptured(allocaInst, true, true)) {
+                return;
+            }
+        }
+    }
+
+    for (llvm::BasicBlock& block : function) {
+        auto* ret = llvm::dyn_cast<llvm::ReturnInst>(block.getTerminator());
+        if (nullptr == ret) {
+            continue;
+        }
+        llvm::Instruction* previous = ret->getPrevNode();
+        while (nullptr != previous && llvm::isa<llvm::IntrinsicInst>(previous) &&
+               llvm::cast<llvm::IntrinsicInst>(previous)->isLifetimeStartOrEnd()) {
+            previous = previous->getPrevNode();
+        }
+        auto* call = llvm::dyn_cast_or_null<llvm::CallInst>(previous);
+        if (nullptr == call || llvm::isa<llvm::IntrinsicInst>(call) || true == call->isInlineAsm()) {
+            continue;
+        }
+        if (nullptr != ret->getReturnValue() && call != ret->getReturnValue()) {
+            continue;
+        }
+        bool passesLocal = false;
+        for (llvm::Value* arg : call->args()) {
+            passesLocal = passesLocal || (arg->getType()->isPointerTy() && isLocalAddress(arg));
+        }
+        if (false == passesLocal) {
+            call->setTailCall();
+        }
+    }
+}
+
+}  // namespace
+
 ASTContext::ASTContext()
     : module("toyc", llvmContext),
       builder(llvmContext),
@@ -16,6 +166,7 @@ ASTContext::~ASTContext() {
 }
 
 void ASTContext::pushJumpContext(std::shared_ptr<NJumpContext> ctx) {
+    ctx->setScopeDepth(scopeStack.size());
     jumpContextStack.push(ctx);
 }
 
@@ -40,19 +191,353 @@ llvm::BasicBlock* ASTContext::getLabel(const std::string& name) {
 
 void ASTContext::clearLabels() {
     labels.clear();
+    labelScopes.clear();
     pendingGotos.clear();
 }
 
 void ASTContext::pushScope() {
-    variableTable = new ScopeTable<std::pair<llvm::AllocaInst*, TypeIdx>>(variableTable);
+    variableTable = new ScopeTable<std::pair<llvm::Value*, TypeIdx>>(variableTable);
+    ScopeStackState scope;
+    scope.id = nextScopeId++;
+    scopeStack.push_back(scope);
 }
 
 void ASTContext::popScope() {
     if (variableTable) {
-        ScopeTable<std::pair<llvm::AllocaInst*, TypeIdx>>* parent = variableTable->parent;
+        ScopeTable<std::pair<llvm::Value*, TypeIdx>>* parent = variableTable->parent;
         delete variableTable;
         variableTable = parent;
     }
+    if (!scopeStack.empty()) {
+        scopeStack.pop_back();
+    }
+}
+
+llvm::Constant* ASTContext::getStringLiteral(const std::string& value) {
+    std::string key(value.rbegin(), value.rend());
+    auto tailPointer = [this](llvm::GlobalVariable* global, size_t offset) -> llvm::Constant* {
+        if (0 == offset) {
+            return global;
+        }
+        llvm::Constant* indices[] = {builder.getInt32(0), builder.getInt32(offset)};
+        return llvm::ConstantExpr::getInBoundsGetElementPtr(global->getValueType(), global, indices);
+    };
+
+    // Identical literal, or a suffix of a pooled one
+    auto it = stringPool.lower_bound(key);
+    if (stringPool.end() != it && 0 == it->first.compare(0, key.size(), key)) {
+        return tailPointer(it->second, it->first.size() - key.size());
+    }
+
+    llvm::Constant* data = llvm::ConstantDataArray::getString(llvmContext, value);
+    auto* global = new llvm::GlobalVariable(module, data->getType(), true, llvm::GlobalValue::PrivateLinkage, data,
+                                            "string_literal");
+    global->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+    global->setAlignment(llvm::Align(1));
+
+    // Pooled literals that are suffixes of the new one now point into its tail
+    for (size_t length = 0; length < key.size(); ++length) {
+        auto suffix = stringPool.find(key.substr(0, length));
+        if (stringPool.end() == suffix) {
+            continue;
+        }
+        // Tail pointers into the old literal become GEPs of this one, which the constant folder flattens
+        suffix->second->replaceAllUsesWith(tailPointer(global, key.size() - length));
+        suffix->second->eraseFromParent();
+        stringPool.erase(suffix);
+    }
+    stringPool[key] = global;
+    return global;
+}
+
+// Fixed-size locals are allocated in the entry block so they stay static allocas no matter
+// how deeply nested the declaration is; only VLAs allocate at the point of declaration.
+llvm::AllocaInst* ASTContext::createEntryAlloca(llvm::Type* type, const std::string& name) {
+    if (nullptr == currentFunction) {
+        return builder.CreateAlloca(type, nullptr, name);
+    }
+    llvm::BasicBlock& entry = currentFunction->getFunction()->getEntryBlock();
+    llvm::BasicBlock::iterator insertPoint = entry.begin();
+    while (insertPoint != entry.end() && llvm::isa<llvm::AllocaInst>(*insertPoint)) {
+        ++insertPoint;
+    }
+    llvm::IRBuilder<> entryBuilder(&entry, insertPoint);
+    return entryBuilder.CreateAlloca(type, nullptr, name);
+}
+
+void ASTContext::beginLifetime(llvm::AllocaInst* allocaInst) {
+    if (nullptr == currentFunction || scopeStack.empty()) {
+        return;
+    }
+    builder.CreateLifetimeStart(allocaInst);
+    scopeStack.back().lifetimes.push_back(allocaInst);
+}
+
+void ASTContext::saveStackForVLA() {
+    if (scopeStack.empty() || nullptr != scopeStack.back().stackSave) {
+        return;
+    }
+    scopeStack.back().stackSave = builder.CreateStackSave("vla.stack");
+}
+
+// Emits lifetime ends and the stack restore for every scope in `from` that is not also part of
+// `to`. Both chains are ordered outermost first, so once a scope id matches, all outer ones do too.
+void ASTContext::emitScopeExit(const ScopeChain& from, const ScopeChain& to) {
+    llvm::Value* restore = nullptr;
+    for (size_t i = from.size(); i-- > 0;) {
+        const ScopeStackState& scope = from[i];
+        const ScopeStackState* kept = (i < to.size() && to[i].id == scope.id) ? &to[i] : nullptr;
+        for (auto it = scope.lifetimes.rbegin(); it != scope.lifetimes.rend(); ++it) {
+            if (nullptr == kept || kept->lifetimes.end() == std::find(kept->lifetimes.begin(),
+                                                                      kept->lifetimes.end(), *it)) {
+                builder.CreateLifetimeEnd(*it);
+            }
+        }
+        if (nullptr != scope.stackSave && (nullptr == kept || kept->stackSave != scope.stackSave)) {
+            restore = scope.stackSave;
+        }
+        if (nullptr != kept) {
+            break;
+        }
+    }
+    if (nullptr != restore) {
+        builder.CreateStackRestore(restore);
+    }
+}
+
+// A jump from `from` into `to` that skips declarations leaves those locals without a
+// lifetime.start on that path, so their markers are dropped entirely.
+void ASTContext::dropBypassedLifetimes(const ScopeChain& from, const ScopeChain& to) {
+    for (size_t i = 0; i < to.size(); ++i) {
+        const ScopeStackState* kept = (i < from.size() && from[i].id == to[i].id) ? &from[i] : nullptr;
+        for (llvm::AllocaInst* allocaInst : to[i].lifetimes) {
+            if (nullptr != kept && kept->lifetimes.end() != std::find(kept->lifetimes.begin(),
+                                                                      kept->lifetimes.end(), allocaInst)) {
+                continue;
+            }
+            eraseLifetimeMarkers(allocaInst);
+        }
+    }
+}
+
+void ASTContext::alignPackedAccesses(llvm::Function* function) {
+    // Loads and stores are emitted with the natural alignment of the accessed type, which a field of a packed
+    // struct does not have. Walk the address back through its GEPs and bound the alignment by what the
+    // enclosing packed struct guarantees at that offset; a variable offset guarantees nothing.
+    const llvm::DataLayout& dataLayout = module.getDataLayout();
+    for (llvm::Instruction& inst : llvm::instructions(function)) {
+        llvm::Value* address = llvm::getLoadStorePointerOperand(&inst);
+        if (nullptr == address) {
+            continue;
+        }
+        llvm::Align bound = llvm::getLoadStoreAlignment(&inst);
+        uint64_t offset = 0;
+        bool constantOffset = true;
+        while (auto* gep = llvm::dyn_cast<llvm::GEPOperator>(address)) {
+            llvm::APInt gepOffset(dataLayout.getIndexTypeSizeInBits(gep->getType()), 0);
+            if (true == constantOffset && true == gep->accumulateConstantOffset(dataLayout, gepOffset)) {
+                offset += gepOffset.getZExtValue();
+            } else {
+                constantOffset = false;
+            }
+            for (auto it = llvm::gep_type_begin(gep); it != llvm::gep_type_end(gep); ++it) {
+                llvm::StructType* structType = it.getStructTypeOrNull();
+                if (nullptr == structType || false == structType->isPacked()) {
+                    continue;
+                }
+                const StructTypeCodegen* structTc = typeManager->findStruct(structType);
+                llvm::Align structAlign(nullptr != structTc ? structTc->getAlignment() : 1);
+                bound = std::min(bound, constantOffset ? llvm::commonAlignment(structAlign, offset) : llvm::Align(1));
+            }
+            address = gep->getPointerOperand();
+        }
+        if (auto* load = llvm::dyn_cast<llvm::LoadInst>(&inst)) {
+            load->setAlignment(bound);
+        } else {
+            llvm::cast<llvm::StoreInst>(&inst)->setAlignment(bound);
+        }
+    }
+}
+
+void ASTContext::annotateAccess(llvm::Instruction* access, TypeIdx accessTypeIdx) {
+    if (true == typeManager->isAtomicQualified(accessTypeIdx)) {
+        if (auto* load = llvm::dyn_cast<llvm::LoadInst>(access)) {
+            load->setAtomic(llvm::AtomicOrdering::SequentiallyConsistent);
+        } else if (auto* store = llvm::dyn_cast<llvm::StoreInst>(access)) {
+            store->setAtomic(llvm::AtomicOrdering::SequentiallyConsistent);
+        }
+    }
+    if (false == options.strictAliasing) {
+        return;
+    }
+    llvm::MDNode* tag = typeManager->getTBAAAccessTag(accessTypeIdx, llvm::getLoadStorePointerOperand(access));
+    if (nullptr != tag) {
+        access->setMetadata(llvm::LLVMContext::MD_tbaa, tag);
+    }
+}
+
+llvm::Value* ASTContext::loadBitField(const AllocCodegenResult& lvalue) {
+    BitFieldSlot slot = lvalue.getBitField();
+    TypeIdx typeIdx = lvalue.getType();
+    bool isVolatile = typeManager->isVolatileQualified(typeIdx);
+    llvm::LoadInst* unit =
+        builder.CreateLoad(builder.getIntNTy(slot.storageBits), lvalue.getAllocaInst(), isVolatile, "bitfield_unit");
+    // A storage unit overlaps its neighbouring fields, so it aliases like char
+    annotateAccess(unit, typeManager->getPrimitiveIdx(VAR_TYPE_CHAR));
+
+    llvm::Type* type = typeManager->realize(typeIdx);
+    llvm::Value* field = unit;
+    if (true == typeManager->isSignedIntegerType(typeIdx)) {
+        // Shift the field up against the top bit, then arithmetic-shift it back down to sign-extend it
+        unsigned top = slot.storageBits - slot.shift - slot.width;
+        if (0 != top) {
+            field = builder.CreateShl(field, top, "bitfield_top");
+        }
+        if (slot.width != slot.storageBits) {
+            field = builder.CreateAShr(field, slot.storageBits - slot.width, "bitfield");
+        }
+        return builder.CreateSExtOrTrunc(field, type);
+    }
+    if (0 != slot.shift) {
+        field = builder.CreateLShr(field, slot.shift, "bitfield_low");
+    }
+    if (slot.width != slot.storageBits) {
+        field = builder.CreateAnd(field, llvm::APInt::getLowBitsSet(slot.storageBits, slot.width), "bitfield");
+    }
+    return builder.CreateZExtOrTrunc(field, type);
+}
+
+llvm::Value* ASTContext::storeBitField(const AllocCodegenResult& lvalue, llvm::Value* value) {
+    BitFieldSlot slot = lvalue.getBitField();
+    TypeIdx typeIdx = lvalue.getType();
+    bool isVolatile = typeManager->isVolatileQualified(typeIdx);
+    llvm::Type* unitType = builder.getIntNTy(slot.storageBits);
+    llvm::LoadInst* unit = builder.CreateLoad(unitType, lvalue.getAllocaInst(), isVolatile, "bitfield_unit");
+    annotateAccess(unit, typeManager->getPrimitiveIdx(VAR_TYPE_CHAR));
+
+    llvm::Value* bits = builder.CreateZExtOrTrunc(value, unitType);
+    if (slot.width != slot.storageBits) {
+        bits = builder.CreateAnd(bits, llvm::APInt::getLowBitsSet(slot.storageBits, slot.width));
+    }
+    if (0 != slot.shift) {
+        bits = builder.CreateShl(bits, slot.shift);
+    }
+    llvm::APInt fieldMask = llvm::APInt::getBitsSet(slot.storageBits, slot.shift, slot.shift + slot.width);
+    llvm::Value* kept = builder.CreateAnd(unit, ~fieldMask, "bitfield_kept");
+    llvm::StoreInst* store = builder.CreateStore(builder.CreateOr(kept, bits, "bitfield_unit"),
+                                                 lvalue.getAllocaInst(), isVolatile);
+    annotateAccess(store, typeManager->getPrimitiveIdx(VAR_TYPE_CHAR));
+
+    llvm::Type* type = value->getType();
+    llvm::Value* truncated = builder.CreateTrunc(value, builder.getIntNTy(slot.width));
+    return true == typeManager->isSignedIntegerType(typeIdx) ? builder.CreateSExt(truncated, type)
+                                                             : builder.CreateZExt(truncated, type);
+}
+
+void ASTContext::copyAggregate(llvm::Value* destination, llvm::Value* source, TypeIdx typeIdx) {
+    llvm::Align alignment(typeManager->getAlignment(typeIdx));
+    uint64_t size = module.getDataLayout().getTypeAllocSize(typeManager->realize(typeIdx));
+    builder.CreateMemCpy(destination, alignment, source, alignment, size,
+                         typeManager->isVolatileQualified(typeIdx));
+}
+
+// Piece i covers bytes [8i, 8i + its size) of the object; pieces never reach past its end
+std::vector<llvm::Value*> ASTContext::loadPieces(llvm::Value* address, TypeIdx typeIdx,
+                                                 const ArgumentPassing& passing) {
+    llvm::Align alignment(typeManager->getAlignment(typeIdx));
+    std::vector<llvm::Value*> pieces;
+    for (size_t i = 0; i < passing.pieces.size(); i++) {
+        llvm::Value* piecePtr =
+            (0 == i) ? address : builder.CreateConstInBoundsGEP1_64(builder.getInt8Ty(), address, 8 * i, "piece_ptr");
+        pieces.push_back(builder.CreateAlignedLoad(passing.pieces[i], piecePtr,
+                                                   llvm::commonAlignment(alignment, 8 * i), "piece"));
+    }
+    return pieces;
+}
+
+void ASTContext::storePieces(llvm::Value* address, TypeIdx typeIdx, const std::vector<llvm::Value*>& pieces) {
+    llvm::Align alignment(typeManager->getAlignment(typeIdx));
+    for (size_t i = 0; i < pieces.size(); i++) {
+        llvm::Value* piecePtr =
+            (0 == i) ? address : builder.CreateConstInBoundsGEP1_64(builder.getInt8Ty(), address, 8 * i, "piece_ptr");
+        builder.CreateAlignedStore(pieces[i], piecePtr, llvm::commonAlignment(alignment, 8 * i));
+    }
+}
+
+void ASTContext::inferFunctionAttributes() {
+    // C code never unwinds, and nothing toyc emits can throw
+    for (llvm::Function& function : module) {
+        if (false == function.isDeclaration()) {
+            function.setDoesNotThrow();
+        }
+    }
+
+    // Memory effects and nocapture feed each other through call sites, so iterate until nothing improves.
+    // Each step only strengthens an attribute, which bounds the loop; recursive cycles stay unannotated.
+    bool changed = true;
+    while (true == changed) {
+        changed = false;
+        for (llvm::Function& function : module) {
+            if (true == function.isDeclaration()) {
+                continue;
+            }
+            if (false == function.doesNotAccessMemory()) {
+                MemoryEffect effect = summarizeMemoryEffect(function);
+                if (MemoryEffect::None == effect) {
+                    function.setDoesNotAccessMemory();
+                    changed = true;
+                } else if (MemoryEffect::Read == effect && false == function.onlyReadsMemory()) {
+                    function.setOnlyReadsMemory();
+                    changed = true;
+                }
+            }
+            for (llvm::Argument& argument : function.args()) {
+                if (argument.getType()->isPointerTy() && false == argument.hasNoCaptureAttr() &&
+                    false == isParameterCaptured(argument)) {
+                    argument.addAttr(llvm::Attribute::NoCapture);
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    for (llvm::Function& function : module) {
+        if (false == function.isDeclaration()) {
+            markTailCalls(function);
+        }
+    }
+}
+
+void ASTContext::eraseLifetimeMarkers(llvm::AllocaInst* allocaInst) {
+    std::vector<llvm::Instruction*> markers;
+    for (llvm::User* user : allocaInst->users()) {
+        if (auto* intrinsic = llvm::dyn_cast<llvm::IntrinsicInst>(user)) {
+            if (intrinsic->isLifetimeStartOrEnd()) {
+                markers.push_back(intrinsic);
+            }
+        }
+    }
+    for (llvm::Instruction* marker : markers) {
+        marker->eraseFromParent();
+    }
+    for (ScopeStackState& scope : scopeStack) {
+        scope.lifetimes.erase(std::remove(scope.lifetimes.begin(), scope.lifetimes.end(), allocaInst),
+                              scope.lifetimes.end());
+    }
+}
+
+bool parseTlsModel(const std::string& name, llvm::GlobalValue::ThreadLocalMode& mode) {
+    static const std::map<std::string, llvm::GlobalValue::ThreadLocalMode> models = {
+        {"global-dynamic", llvm::GlobalValue::GeneralDynamicTLSModel},
+        {"local-dynamic", llvm::GlobalValue::LocalDynamicTLSModel},
+        {"initial-exec", llvm::GlobalValue::InitialExecTLSModel},
+        {"local-exec", llvm::GlobalValue::LocalExecTLSModel}};
+    auto it = models.find(name);
+    if (models.end() == it) {
+        return false;
+    }
+    mode = it->second;
+    return true;
 }
 
 }  // namespace toyc::ast
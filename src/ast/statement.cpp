@@ -1,5 +1,12 @@
 #include "ast/statement.hpp"
 
+#include <llvm/Analysis/VectorUtils.h>
+#include <llvm/IR/CFG.h>
+#include <llvm/IR/InlineAsm.h>
+#include <llvm/IR/MDBuilder.h>
+
+#include <algorithm>
+#include <cctype>
 #include <iostream>
 
 #include "ast/external_definition.hpp"
@@ -18,6 +25,12 @@ StmtCodegenResult NExpressionStatement::codegen(ASTContext &context) {
         return StmtCodegenResult("Failed to generate code for expression statement") << exprResult;
     }
 
+    // The value of a struct assignment or struct-returning call is a load of the whole object; drop it unused
+    auto *load = llvm::dyn_cast_or_null<llvm::LoadInst>(exprResult.getValue());
+    if (nullptr != load && load->getType()->isAggregateType() && load->use_empty() && false == load->isVolatile()) {
+        load->eraseFromParent();
+    }
+
     return StmtCodegenResult();
 }
 
@@ -28,11 +41,32 @@ StmtCodegenResult NDeclarationStatement::codegen(ASTContext &context) {
         return StmtCodegenResult("Failed to realize type from descriptor");
     }
 
+    // File-scope declarations and static/extern locals live in globals rather than on the stack
+    bool isFileScope = nullptr == context.currentFunction;
+    bool hasStaticStorage = isFileScope || STORAGE_NONE != storageClass;
+
     for (auto *currentDeclarator = declarator.get(); currentDeclarator != nullptr;
          currentDeclarator = currentDeclarator->next.get()) {
-        if (true == context.variableTable->lookup(currentDeclarator->getName(), false).first) {
+        // File-scope redeclarations are merged into the existing global by createGlobalVariable
+        if (false == isFileScope && true == context.variableTable->lookup(currentDeclarator->getName(), false).first) {
             return StmtCodegenResult("Variable already declared in this scope: " + currentDeclarator->getName());
         }
+        if (true == threadLocal && false == hasStaticStorage) {
+            return StmtCodegenResult("Block-scope thread-local variable must be static or extern: " +
+                                     currentDeclarator->getName());
+        }
+
+        if (true == hasStaticStorage) {
+            AllocCodegenResult globalResult = createGlobalVariable(context, typeIdx, currentDeclarator);
+            if (false == globalResult.isSuccess()) {
+                return StmtCodegenResult("Variable declaration codegen failed for variable: " +
+                                         currentDeclarator->getName())
+                       << globalResult;
+            }
+            context.variableTable->insert(currentDeclarator->getName(),
+                                          std::make_pair(globalResult.getAllocaInst(), globalResult.getType()));
+            continue;
+        }
 
         AllocCodegenResult allocResult;
         if (true == currentDeclarator->isArray()) {
@@ -51,6 +85,11 @@ StmtCodegenResult NDeclarationStatement::codegen(ASTContext &context) {
 
         allocaInst = static_cast<llvm::AllocaInst *>(allocResult.getAllocaInst());
         TypeIdx currTypeIdx = allocResult.getType();
+        uint64_t alignment =
+            std::max(context.typeManager->getAlignment(currTypeIdx), currentDeclarator->alignment);
+        if (alignment > allocaInst->getAlign().value()) {
+            allocaInst->setAlignment(llvm::Align(alignment));
+        }
         context.variableTable->insert(currentDeclarator->getName(), std::make_pair(allocaInst, currTypeIdx));
 
         if (true == currentDeclarator->isNonInitialized()) {
@@ -58,15 +97,30 @@ StmtCodegenResult NDeclarationStatement::codegen(ASTContext &context) {
         }
 
         llvm::Type *currType = context.typeManager->realize(currTypeIdx);
-        if (nullptr != currType && true == currType->isArrayTy()) {
-            NInitializerList *initList = dynamic_cast<NInitializerList *>(currentDeclarator->expr.get());
-            StmtCodegenResult initResult = initializeArrayElements(allocaInst, currTypeIdx, initList, context);
+        bool isBraced = nullptr != dynamic_cast<NInitializerList *>(currentDeclarator->expr.get());
+        if ((nullptr != currType && true == currType->isArrayTy()) || true == isBraced) {
+            StmtCodegenResult initResult =
+                initializeAggregate(allocaInst, currTypeIdx, currentDeclarator->expr.get(), context);
             if (false == initResult.isSuccess()) {
                 return initResult;
             }
             continue;
         }
 
+        if (true == context.typeManager->isRecordType(currTypeIdx)) {
+            AllocCodegenResult sourceResult = currentDeclarator->expr->aggregategen(context);
+            if (false == sourceResult.isSuccess()) {
+                return StmtCodegenResult("Initializer codegen failed for variable: " + currentDeclarator->getName())
+                       << sourceResult;
+            }
+            if (context.typeManager->unqualify(sourceResult.getType()) !=
+                context.typeManager->unqualify(currTypeIdx)) {
+                return StmtCodegenResult("Incompatible initializer for variable: " + currentDeclarator->getName());
+            }
+            context.copyAggregate(allocaInst, sourceResult.getAllocaInst(), currTypeIdx);
+            continue;
+        }
+
         ExprCodegenResult codegenResult = currentDeclarator->codegen(context);
         llvm::Value *value = codegenResult.getValue();
         TypeIdx valTypeIdx = codegenResult.getType();
@@ -82,7 +136,8 @@ StmtCodegenResult NDeclarationStatement::codegen(ASTContext &context) {
                        << castResult;
             }
             bool isVolatile = context.typeManager->isVolatileQualified(currTypeIdx);
-            context.builder.CreateStore(castResult.getValue(), allocaInst, isVolatile);
+            context.annotateAccess(context.builder.CreateStore(castResult.getValue(), allocaInst, isVolatile),
+                                   currTypeIdx);
         }
     }
 
@@ -94,7 +149,7 @@ AllocCodegenResult NDeclarationStatement::createArrayAllocation(ASTContext &cont
     if (false == declarator->isVLA) {
         std::vector<int> dimensions;
         for (const auto &sizeExpr : declarator->getArrayDimensions()) {
-            dimensions.push_back(static_cast<NInteger *>(sizeExpr.get())->getValue());
+            dimensions.push_back(static_cast<int>(static_cast<NInteger *>(sizeExpr.get())->getValue()));
         }
         TypeIdx arrayTypeIdx = context.typeManager->getArrayIdx(baseTypeIdx, dimensions);
         llvm::Type *arrayType = context.typeManager->realize(arrayTypeIdx);
@@ -107,6 +162,9 @@ AllocCodegenResult NDeclarationStatement::createArrayAllocation(ASTContext &cont
         return AllocCodegenResult("Failed to generate size value for VLA") << sizeValue;
     }
 
+    // Save the stack pointer before the scope's first VLA so the space is released at scope exit
+    context.saveStackForVLA();
+
     // CreateAlloca with array size returns a pointer to the array
     llvm::Value *vlaArrayPtr =
         context.builder.CreateAlloca(baseType, sizeValue.getData(), declarator->getName() + ".vla");
@@ -114,7 +172,7 @@ AllocCodegenResult NDeclarationStatement::createArrayAllocation(ASTContext &cont
     // Wrap the VLA pointer in an alloca so it can be treated like a regular pointer
     llvm::Type *ptrType = vlaArrayPtr->getType();
     TypeIdx ptrTypeIdx = context.typeManager->getPointerIdx(baseTypeIdx, 1);
-    llvm::AllocaInst *ptrStorage = context.builder.CreateAlloca(ptrType, nullptr, declarator->getName());
+    llvm::AllocaInst *ptrStorage = context.createEntryAlloca(ptrType, declarator->getName());
 
     context.builder.CreateStore(vlaArrayPtr, ptrStorage);
 
@@ -130,44 +188,338 @@ AllocCodegenResult NDeclarationStatement::createPointerAllocation(ASTContext &co
     return createSingleAllocation(context, ptrType, ptrTypeIdx, declarator);
 }
 
+// The address of a thread-local variable differs between threads, so it is not a link-time constant
+static bool referencesThreadLocal(const llvm::Constant *constant) {
+    if (auto *global = llvm::dyn_cast<llvm::GlobalValue>(constant)) {
+        return global->isThreadLocal();
+    }
+    for (const llvm::Use &operand : constant->operands()) {
+        if (true == referencesThreadLocal(llvm::cast<llvm::Constant>(operand.get()))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+AllocCodegenResult NDeclarationStatement::createGlobalVariable(ASTContext &context, TypeIdx baseTypeIdx,
+                                                               NDeclarator *declarator) {
+    const std::string &name = declarator->getName();
+    TypeIdx declTypeIdx = baseTypeIdx;
+    if (true == declarator->isArray()) {
+        if (true == declarator->isVLA) {
+            return AllocCodegenResult("Variable length array cannot have static storage duration: " + name);
+        }
+        std::vector<int> dimensions;
+        for (const auto &sizeExpr : declarator->getArrayDimensions()) {
+            dimensions.push_back(static_cast<int>(static_cast<NInteger *>(sizeExpr.get())->getValue()));
+        }
+        declTypeIdx = context.typeManager->getArrayIdx(baseTypeIdx, dimensions);
+    } else if (true == declarator->isPointer()) {
+        declTypeIdx = context.typeManager->getPointerIdx(baseTypeIdx, declarator->pointerLevel);
+        if (declarator->qualifiers != QUAL_NONE)
+            declTypeIdx = context.typeManager->getQualifiedIdx(declTypeIdx, declarator->qualifiers);
+    }
+    llvm::Type *type = context.typeManager->realize(declTypeIdx);
+    if (nullptr == type) {
+        return AllocCodegenResult("Failed to realize type of variable: " + name);
+    }
+
+    bool isFileScope = nullptr == context.currentFunction;
+    bool isDefinition = STORAGE_EXTERN != storageClass || false == declarator->isNonInitialized();
+
+    // Static storage must be initialized with a constant, folded here into the global's initializer
+    llvm::Constant *initializer = nullptr;
+    if (false == declarator->isNonInitialized()) {
+        if (STORAGE_EXTERN == storageClass && false == isFileScope) {
+            return AllocCodegenResult("Block-scope extern variable cannot have an initializer: " + name);
+        }
+        llvm::IRBuilderBase::InsertPointGuard insertGuard(context.builder);
+        if (true == isFileScope) {
+            context.builder.ClearInsertionPoint();
+        }
+        std::vector<llvm::Value *> indices;
+        std::vector<InitializerLeaf> leaves;
+        bool complete = true;
+        StmtCodegenResult initResult =
+            lowerInitializer(context, declTypeIdx, declarator->expr.get(), indices, leaves, complete, initializer);
+        if (false == initResult.isSuccess()) {
+            return AllocCodegenResult("Initializer codegen failed for variable: " + name) << initResult;
+        }
+        if (nullptr == initializer || true == referencesThreadLocal(initializer)) {
+            return AllocCodegenResult("Initializer element is not a compile-time constant: " + name);
+        }
+    }
+
+    // Static locals get a function-qualified symbol so equally named ones in other functions don't clash. A
+    // block-scope extern names the file-scope object itself.
+    bool isLinked = true == isFileScope || STORAGE_EXTERN == storageClass;
+    std::string globalName = isLinked ? name : context.currentFunction->getFunction()->getName().str() + "." + name;
+    llvm::GlobalVariable *global = isLinked ? context.module.getNamedGlobal(globalName) : nullptr;
+    if (nullptr != global) {
+        if (global->getValueType() != type) {
+            return AllocCodegenResult("Conflicting types for global variable: " + name);
+        }
+        if (global->isThreadLocal() != threadLocal) {
+            return AllocCodegenResult("Conflicting thread-local and non-thread-local declarations of: " + name);
+        }
+        if (nullptr != initializer && 0 != context.initializedGlobals.count(global)) {
+            return AllocCodegenResult("Redefinition of global variable: " + name);
+        }
+    } else {
+        global = new llvm::GlobalVariable(context.module, type, false, llvm::GlobalValue::ExternalLinkage, nullptr,
+                                          globalName);
+    }
+
+    if (STORAGE_STATIC == storageClass) {
+        global->setLinkage(llvm::GlobalValue::InternalLinkage);
+    }
+    // An executable reaches its own TLS block at a fixed offset from the thread pointer; code that may be in a
+    // shared object has to ask __tls_get_addr. tls_model on the variable overrides -ftls-model.
+    if (true == threadLocal) {
+        llvm::GlobalValue::ThreadLocalMode mode = declarator->tlsModel;
+        if (llvm::GlobalValue::NotThreadLocal == mode) {
+            mode = context.options.tlsModel;
+        }
+        if (llvm::GlobalValue::NotThreadLocal == mode) {
+            mode = context.options.positionIndependent ? llvm::GlobalValue::GeneralDynamicTLSModel
+                                                       : llvm::GlobalValue::InitialExecTLSModel;
+        }
+        global->setThreadLocalMode(mode);
+    }
+    uint64_t alignment = std::max(context.typeManager->getAlignment(declTypeIdx), declarator->alignment);
+    if (alignment > global->getAlign().valueOrOne().value()) {
+        global->setAlignment(llvm::Align(alignment));
+    }
+    if (nullptr != initializer) {
+        global->setInitializer(initializer);
+        context.initializedGlobals.insert(global);
+    } else if (true == isDefinition && true == global->isDeclaration()) {
+        global->setInitializer(llvm::Constant::getNullValue(type));
+    }
+
+    // const objects (including arrays of const elements) can be placed in read-only data
+    TypeIdx elementTypeIdx = declTypeIdx;
+    while (auto *arrTc = dynamic_cast<const ArrayTypeCodegen *>(context.typeManager->get(elementTypeIdx))) {
+        elementTypeIdx = arrTc->getElementIdx();
+    }
+    global->setConstant(context.typeManager->isConstQualified(elementTypeIdx));
+
+    return AllocCodegenResult(global, declTypeIdx);
+}
+
 AllocCodegenResult NDeclarationStatement::createSingleAllocation(ASTContext &context, llvm::Type *type, TypeIdx typeIdx,
                                                                  NDeclarator *declarator) {
-    llvm::AllocaInst *allocaInst = context.builder.CreateAlloca(type, nullptr, declarator->getName());
+    llvm::AllocaInst *allocaInst = context.createEntryAlloca(type, declarator->getName());
+    context.beginLifetime(allocaInst);
     return AllocCodegenResult(allocaInst, typeIdx);
 }
 
-StmtCodegenResult NDeclarationStatement::initializeArrayElements(llvm::AllocaInst *allocaInst, TypeIdx arrayTypeIdx,
-                                                                 NInitializerList *initList, ASTContext &context) {
-    if (nullptr == initList) {
+StmtCodegenResult NDeclarationStatement::initializeAggregate(llvm::AllocaInst *allocaInst, TypeIdx aggregateTypeIdx,
+                                                             NExpression *initializer, ASTContext &context) {
+    if (nullptr == dynamic_cast<NInitializerList *>(initializer)) {
         return StmtCodegenResult("Array must be initialized with initializer list");
     }
 
-    llvm::Type *arrayType = context.typeManager->realize(arrayTypeIdx);
-    auto *arrTc = dynamic_cast<const ArrayTypeCodegen *>(context.typeManager->get(arrayTypeIdx));
-    TypeIdx elementTypeIdx = arrTc ? arrTc->getElementIdx() : InvalidTypeIdx;
-    const auto &elements = initList->getElements();
+    std::vector<llvm::Value *> indices{context.builder.getInt32(0)};
+    std::vector<InitializerLeaf> leaves;
+    bool complete = true;
+    llvm::Constant *constant = nullptr;
+    StmtCodegenResult lowerResult =
+        lowerInitializer(context, aggregateTypeIdx, initializer, indices, leaves, complete, constant);
+    if (false == lowerResult.isSuccess()) {
+        return lowerResult;
+    }
 
-    for (size_t i = 0; i < elements.size(); i++) {
-        std::vector<llvm::Value *> indices;
-        indices.push_back(context.builder.getInt32(0));
-        indices.push_back(context.builder.getInt32(i));
+    llvm::Type *aggregateType = allocaInst->getAllocatedType();
+    llvm::MaybeAlign align = allocaInst->getAlign();
+    uint64_t size = context.module.getDataLayout().getTypeAllocSize(aggregateType);
 
-        llvm::Value *elementPtr = context.builder.CreateGEP(arrayType, allocaInst, indices);
+    // A vector fits in registers, so a constant one is stored directly rather than copied from memory
+    if (nullptr != constant && true == aggregateType->isVectorTy()) {
+        context.annotateAccess(context.builder.CreateStore(constant, allocaInst), aggregateTypeIdx);
+        return StmtCodegenResult();
+    }
 
-        ExprCodegenResult elemResult = elements[i]->codegen(context);
-        if (false == elemResult.isSuccess()) {
-            return StmtCodegenResult("Array initializer element " + std::to_string(i) + " codegen failed")
-                   << elemResult;
+    if (nullptr != constant) {
+        if (true == constant->isNullValue()) {
+            context.builder.CreateMemSet(allocaInst, context.builder.getInt8(0), size, align);
+            return StmtCodegenResult();
         }
+        // Fully constant initializers are materialized once as read-only data and copied in
+        std::string functionName = context.currentFunction->getFunction()->getName().str();
+        auto *global = new llvm::GlobalVariable(context.module, aggregateType, true, llvm::GlobalValue::PrivateLinkage,
+                                                constant, "__const." + functionName + "." + allocaInst->getName());
+        global->setUnnamedAddr(llvm::GlobalValue::UnnamedAddr::Global);
+        global->setAlignment(align);
+        context.builder.CreateMemCpy(allocaInst, align, global, align, size);
+        return StmtCodegenResult();
+    }
 
+    // Mixed initializers: zero the object once when elements are left out, then store what was given
+    if (false == complete) {
+        context.builder.CreateMemSet(allocaInst, context.builder.getInt8(0), size, align);
+    }
+    for (const InitializerLeaf &leaf : leaves) {
+        auto *leafConstant = llvm::dyn_cast<llvm::Constant>(leaf.value);
+        if (false == complete && nullptr != leafConstant && true == leafConstant->isNullValue()) {
+            continue;
+        }
+        llvm::Value *elementPtr = context.builder.CreateInBoundsGEP(aggregateType, allocaInst, leaf.indices);
+        if (0 != leaf.bitField.width) {
+            context.storeBitField(AllocCodegenResult(elementPtr, leaf.typeIdx, leaf.bitField), leaf.value);
+            continue;
+        }
+        context.annotateAccess(context.builder.CreateStore(leaf.value, elementPtr), leaf.typeIdx);
+    }
+
+    return StmtCodegenResult();
+}
+
+StmtCodegenResult NDeclarationStatement::lowerInitializer(ASTContext &context, TypeIdx typeIdx,
+                                                          NExpression *initializer,
+                                                          std::vector<llvm::Value *> &indices,
+                                                          std::vector<InitializerLeaf> &leaves, bool &complete,
+                                                          llvm::Constant *&constant) {
+    TypeIdx baseTypeIdx = context.typeManager->unqualify(typeIdx);
+    llvm::Type *type = context.typeManager->realize(baseTypeIdx);
+    auto *initList = dynamic_cast<NInitializerList *>(initializer);
+    auto *arrTc = dynamic_cast<const ArrayTypeCodegen *>(context.typeManager->get(baseTypeIdx));
+    auto *structTc = dynamic_cast<const StructTypeCodegen *>(context.typeManager->get(baseTypeIdx));
+    auto *vectorTc = dynamic_cast<const VectorTypeCodegen *>(context.typeManager->get(baseTypeIdx));
+
+    // A braced vector initializer lists its lanes like an array's elements; an unbraced one is a vector value
+    if (nullptr != vectorTc && nullptr == initList) {
+        vectorTc = nullptr;
+    }
+    if (nullptr == arrTc && nullptr == structTc && nullptr == vectorTc) {
+        // Scalar, optionally wrapped in a single pair of braces
+        if (nullptr != initList) {
+            if (1 != initList->getElements().size()) {
+                return StmtCodegenResult("Scalar initializer must contain exactly one element");
+            }
+            initializer = initList->getElements()[0].get();
+        }
+        ExprCodegenResult elemResult = initializer->codegen(context);
+        if (false == elemResult.isSuccess()) {
+            return StmtCodegenResult("Initializer element codegen failed") << elemResult;
+        }
         ExprCodegenResult castResult =
-            context.typeManager->typeCast(elemResult.getValue(), elemResult.getType(), elementTypeIdx, context.builder);
-        if (false == castResult.isSuccess()) {
-            return StmtCodegenResult("Type cast failed for array initializer element " + std::to_string(i))
-                   << castResult;
+            context.typeManager->typeCast(elemResult.getValue(), elemResult.getType(), typeIdx, context.builder);
+        if (false == castResult.isSuccess() || nullptr == castResult.getValue()) {
+            return StmtCodegenResult("Type cast failed for initializer element") << castResult;
+        }
+        leaves.push_back({indices, castResult.getValue(), typeIdx, BitFieldSlot()});
+        constant = llvm::dyn_cast<llvm::Constant>(castResult.getValue());
+        return StmtCodegenResult();
+    }
+
+    if (nullptr == initList) {
+        return StmtCodegenResult("Aggregate member must be initialized with initializer list");
+    }
+
+    // Unnamed bit-fields take no initializer, and a union's initializer sets its first named member
+    std::vector<int> members;
+    if (nullptr != structTc) {
+        for (size_t i = 0; i < structTc->getMemberCount(); i++) {
+            if (true == structTc->getMember(static_cast<int>(i)).name.empty()) {
+                continue;
+            }
+            members.push_back(static_cast<int>(i));
+            if (true == structTc->isUnion()) {
+                break;
+            }
+        }
+    }
+    size_t elementCount = (nullptr != arrTc)      ? static_cast<size_t>(arrTc->getSize())
+                          : (nullptr != vectorTc) ? static_cast<size_t>(vectorTc->getLaneCount())
+                                                  : members.size();
+    const auto &elements = initList->getElements();
+    if (elements.size() > elementCount) {
+        return StmtCodegenResult("Too many initializers: expected at most " + std::to_string(elementCount) +
+                                 ", got " + std::to_string(elements.size()));
+    }
+    // Bytes beyond a union's first member and the rest of a bit-field's storage unit are not covered by any
+    // element, and a bit-field is written by read-modify-write, so those objects are zeroed first
+    if (elements.size() < elementCount || (nullptr != structTc && members.size() != structTc->getMemberCount())) {
+        complete = false;
+    }
+
+    bool allConstant = true;
+    std::vector<llvm::Constant *> elementConstants;
+    for (size_t i = 0; i < elementCount; i++) {
+        TypeIdx elementTypeIdx = (nullptr != arrTc)      ? arrTc->getElementIdx()
+                                 : (nullptr != vectorTc) ? vectorTc->getElementIdx()
+                                                         : structTc->getMemberTypeIdx(members[i]);
+        if (i >= elements.size()) {
+            elementConstants.push_back(llvm::Constant::getNullValue(context.typeManager->realize(elementTypeIdx)));
+            continue;
         }
 
-        context.builder.CreateStore(castResult.getValue(), elementPtr);
+        llvm::Constant *elementConstant = nullptr;
+        unsigned elementIndex =
+            (nullptr == structTc) ? static_cast<unsigned>(i) : structTc->getElementIndex(members[i]);
+        bool isBitField = nullptr != structTc && true == structTc->isBitField(members[i]);
+        indices.push_back(context.builder.getInt32(elementIndex));
+        if (true == isBitField && false == structTc->isUnion()) {
+            indices.push_back(context.builder.getInt32(structTc->getBitFieldStorage(members[i]).byteOffset));
+        }
+        size_t leafCount = leaves.size();
+        StmtCodegenResult elementResult = lowerInitializer(context, elementTypeIdx, elements[i].get(), indices,
+                                                           leaves, complete, elementConstant);
+        indices.resize(indices.size() - ((true == isBitField && false == structTc->isUnion()) ? 2 : 1));
+        if (true == isBitField && leaves.size() > leafCount) {
+            leaves.back().bitField = structTc->getBitFieldStorage(members[i]).slot;
+            complete = false;
+        }
+        // Bit-fields are folded into their storage bytes below, which takes an integer constant
+        if (true == isBitField && nullptr == llvm::dyn_cast_or_null<llvm::ConstantInt>(elementConstant)) {
+            elementConstant = nullptr;
+        }
+        if (false == elementResult.isSuccess()) {
+            return StmtCodegenResult("Initializer element " + std::to_string(i) + " codegen failed")
+                   << elementResult;
+        }
+        allConstant = allConstant && (nullptr != elementConstant);
+        elementConstants.push_back(elementConstant);
+    }
+
+    constant = nullptr;
+    if (true == allConstant) {
+        if (nullptr != arrTc) {
+            constant = llvm::ConstantArray::get(llvm::cast<llvm::ArrayType>(type), elementConstants);
+        } else if (nullptr != vectorTc) {
+            constant = llvm::ConstantVector::get(elementConstants);
+        } else {
+            // Explicit padding elements of a packed or over-aligned layout are zero
+            auto *structType = llvm::cast<llvm::StructType>(type);
+            std::vector<llvm::Constant *> fields;
+            for (llvm::Type *fieldType : structType->elements()) {
+                fields.push_back(llvm::Constant::getNullValue(fieldType));
+            }
+            // Bit-fields are packed into the bytes of their run element, least significant bit first
+            std::map<unsigned, llvm::APInt> runBits;
+            for (size_t i = 0; i < elementConstants.size(); i++) {
+                unsigned elementIndex = structTc->getElementIndex(members[i]);
+                if (false == structTc->isBitField(members[i])) {
+                    fields[elementIndex] = elementConstants[i];
+                    continue;
+                }
+                const StructTypeCodegen::BitFieldStorage &storage = structTc->getBitFieldStorage(members[i]);
+                uint64_t runBytes = structType->getElementType(elementIndex)->getArrayNumElements();
+                auto run = runBits.try_emplace(elementIndex, static_cast<unsigned>(8 * runBytes), 0).first;
+                llvm::APInt value = llvm::cast<llvm::ConstantInt>(elementConstants[i])->getValue();
+                run->second.insertBits(value.zextOrTrunc(storage.slot.width),
+                                       8 * storage.byteOffset + storage.slot.shift);
+            }
+            for (const auto &[elementIndex, bits] : runBits) {
+                std::vector<uint8_t> bytes;
+                for (unsigned byte = 0; byte < bits.getBitWidth() / 8; byte++) {
+                    bytes.push_back(static_cast<uint8_t>(bits.extractBitsAsZExtValue(8, 8 * byte)));
+                }
+                fields[elementIndex] = llvm::ConstantDataArray::get(context.llvmContext, bytes);
+            }
+            constant = llvm::ConstantStruct::get(structType, fields);
+        }
     }
 
     return StmtCodegenResult();
@@ -177,20 +529,51 @@ StmtCodegenResult NBlock::codegen(ASTContext &context) {
     llvm::Function *parentFunction = context.currentFunction->getFunction();
     block = llvm::BasicBlock::Create(context.llvmContext, name, parentFunction);
 
+    // A bare compound statement has no owner wiring its entry, so fall into it from the current block
+    llvm::BasicBlock *currentBlock = context.builder.GetInsertBlock();
+    if (false == context.isInitializingFunction && nullptr == nextBlock && nullptr != currentBlock &&
+        nullptr == currentBlock->getTerminator()) {
+        context.builder.CreateBr(block);
+    }
     context.builder.SetInsertPoint(block);
 
     auto scopeGuard = toyc::utility::makeScopeGuard([&context]() { context.popScope(); });
     context.pushScope();
 
     if (true == context.isInitializingFunction) {
-        auto *param = context.currentFunction->getParams();
-        for (auto &arg : context.currentFunction->getFunction()->args()) {
-            llvm::AllocaInst *allocaInst = context.builder.CreateAlloca(arg.getType(), nullptr, arg.getName());
-            context.builder.CreateStore(&arg, allocaInst);
-            TypeIdx paramTypeIdx = (param != nullptr) ? param->getTypeIdx() : InvalidTypeIdx;
-            context.variableTable->insert(arg.getName().str(), std::make_pair(allocaInst, paramTypeIdx));
-            if (param != nullptr)
-                param = param->next.get();
+        NFunctionDefinition *function = context.currentFunction;
+        auto arg = function->getFunction()->arg_begin();
+        if (ArgumentPassing::Indirect == function->getReturnPassing().kind) {
+            ++arg;  // the sret pointer, written by return statements
+        }
+        auto *param = function->getParams();
+        for (const ArgumentPassing &passing : function->getParamPassing()) {
+            TypeIdx paramTypeIdx = param->getTypeIdx();
+            llvm::Value *storage = &*arg;
+            if (ArgumentPassing::Indirect == passing.kind) {
+                // The byval copy already is this call's own object
+                ++arg;
+            } else {
+                llvm::Type *paramType = context.typeManager->realize(paramTypeIdx);
+                llvm::AllocaInst *allocaInst = context.builder.CreateAlloca(paramType, nullptr, param->getName());
+                uint64_t alignment = context.typeManager->getAlignment(paramTypeIdx);
+                if (alignment > allocaInst->getAlign().value()) {
+                    allocaInst->setAlignment(llvm::Align(alignment));
+                }
+                if (ArgumentPassing::Direct == passing.kind) {
+                    context.annotateAccess(context.builder.CreateStore(&*arg, allocaInst), paramTypeIdx);
+                    ++arg;
+                } else {
+                    std::vector<llvm::Value *> pieces;
+                    for (size_t i = 0; i < passing.pieces.size(); i++, ++arg) {
+                        pieces.push_back(&*arg);
+                    }
+                    context.storePieces(allocaInst, paramTypeIdx, pieces);
+                }
+                storage = allocaInst;
+            }
+            context.variableTable->insert(param->getName(), std::make_pair(storage, paramTypeIdx));
+            param = param->next.get();
         }
     }
     context.isInitializingFunction = false;
@@ -206,6 +589,12 @@ StmtCodegenResult NBlock::codegen(ASTContext &context) {
         }
     }
 
+    // Falling off the end of the block leaves its scope
+    if (!context.builder.GetInsertBlock()->getTerminator()) {
+        ScopeChain outer(context.scopeStack.begin(), context.scopeStack.end() - 1);
+        context.emitScopeExit(context.scopeStack, outer);
+    }
+
     if (nullptr != nextBlock && !context.builder.GetInsertBlock()->getTerminator()) {
         context.builder.CreateBr(nextBlock);
         context.builder.SetInsertPoint(nextBlock);
@@ -215,6 +604,38 @@ StmtCodegenResult NBlock::codegen(ASTContext &context) {
 }
 
 StmtCodegenResult NReturnStatement::codegen(ASTContext &context) {
+    NFunctionDefinition *function = context.currentFunction;
+    if (nullptr != expression && true == context.typeManager->isRecordType(function->getReturnTypeIdx())) {
+        TypeIdx returnTypeIdx = function->getReturnTypeIdx();
+        AllocCodegenResult addressResult = expression->aggregategen(context);
+        if (false == addressResult.isSuccess()) {
+            return StmtCodegenResult("Failed to generate code for return expression") << addressResult;
+        }
+        if (context.typeManager->unqualify(addressResult.getType()) != context.typeManager->unqualify(returnTypeIdx)) {
+            return StmtCodegenResult("Incompatible type in return statement");
+        }
+
+        const ArgumentPassing &passing = function->getReturnPassing();
+        if (ArgumentPassing::Indirect == passing.kind) {
+            context.copyAggregate(function->getFunction()->getArg(0), addressResult.getAllocaInst(), returnTypeIdx);
+            context.builder.CreateRetVoid();
+        } else if (ArgumentPassing::Coerced == passing.kind) {
+            std::vector<llvm::Value *> pieces =
+                context.loadPieces(addressResult.getAllocaInst(), returnTypeIdx, passing);
+            llvm::Value *value = pieces.front();
+            if (pieces.size() > 1) {
+                value = llvm::UndefValue::get(function->getFunction()->getReturnType());
+                for (unsigned i = 0; i < pieces.size(); i++) {
+                    value = context.builder.CreateInsertValue(value, pieces[i], i);
+                }
+            }
+            context.builder.CreateRet(value);
+        } else {
+            context.builder.CreateRetVoid();
+        }
+        return StmtCodegenResult();
+    }
+
     if (nullptr != expression) {
         ExprCodegenResult exprResult = expression->codegen(context);
         llvm::Value *value = exprResult.getValue();
@@ -223,7 +644,7 @@ StmtCodegenResult NReturnStatement::codegen(ASTContext &context) {
             return StmtCodegenResult("Failed to generate code for return expression") << exprResult;
         }
         ExprCodegenResult castResult =
-            context.typeManager->typeCast(value, typeIdx, context.currentFunction->getReturnTypeIdx(), context.builder);
+            context.typeManager->typeCast(value, typeIdx, function->getReturnTypeIdx(), context.builder);
         if (false == castResult.isSuccess()) {
             return StmtCodegenResult("Type cast failed for return statement") << castResult;
         }
@@ -246,10 +667,16 @@ StmtCodegenResult NIfStatement::codegen(ASTContext &context) {
     context.builder.CreateBr(conditionBlock);
     context.builder.SetInsertPoint(conditionBlock);
     ExprCodegenResult condResult = conditionNode->codegen(context);
-    conditionValue = condResult.getValue();
     if (false == condResult.isSuccess()) {
         return StmtCodegenResult("Condition code generation failed for if statement") << condResult;
     }
+    ExprCodegenResult castResult = context.typeManager->typeCast(
+        condResult.getValue(), condResult.getType(), context.typeManager->getPrimitiveIdx(VAR_TYPE_BOOL),
+        context.builder);
+    if (false == castResult.isSuccess() || nullptr == castResult.getValue()) {
+        return StmtCodegenResult("Type cast failed for if condition") << castResult;
+    }
+    conditionValue = castResult.getValue();
 
     // Get the actual block after condition evaluation (may have changed due to short-circuit)
     llvm::BasicBlock *conditionEndBlock = context.builder.GetInsertBlock();
@@ -280,15 +707,94 @@ StmtCodegenResult NIfStatement::codegen(ASTContext &context) {
     return StmtCodegenResult();
 }
 
+// Loop-ID metadata for the pragmas on a loop, attached to every branch from inside the loop back to header.
+// The loop's blocks are firstBlock and everything created after it except exit. When the pragmas promise
+// independent iterations, every memory access in the loop joins an access group the loop lists as parallel.
+static void attachLoopHints(ASTContext &context, const LoopHints &hints, llvm::BasicBlock *header,
+                            llvm::BasicBlock *preheader, llvm::BasicBlock *firstBlock, llvm::BasicBlock *exit) {
+    llvm::LLVMContext &llvmContext = context.llvmContext;
+    std::vector<llvm::Metadata *> operands{nullptr};  // the loop ID refers to itself
+    auto addFlag = [&](const char *name) {
+        operands.push_back(llvm::MDNode::get(llvmContext, llvm::MDString::get(llvmContext, name)));
+    };
+    auto addValue = [&](const char *name, llvm::Constant *value) {
+        operands.push_back(llvm::MDNode::get(
+            llvmContext, {llvm::MDString::get(llvmContext, name), llvm::ConstantAsMetadata::get(value)}));
+    };
+
+    if (true == hints.vectorizeDisable) {
+        addValue("llvm.loop.vectorize.width", context.builder.getInt32(1));
+    } else {
+        if (0 != hints.vectorizeWidth) {
+            addValue("llvm.loop.vectorize.width", context.builder.getInt32(hints.vectorizeWidth));
+        }
+        if (true == hints.vectorizeEnable || hints.vectorizeWidth > 1) {
+            addValue("llvm.loop.vectorize.enable", context.builder.getTrue());
+        }
+    }
+    if (0 != hints.interleaveCount) {
+        addValue("llvm.loop.interleave.count", context.builder.getInt32(hints.interleaveCount));
+    }
+    if (true == hints.unrollDisable) {
+        addFlag("llvm.loop.unroll.disable");
+    } else if (true == hints.unrollFull) {
+        addFlag("llvm.loop.unroll.full");
+    } else if (0 != hints.unrollCount) {
+        addValue("llvm.loop.unroll.count", context.builder.getInt32(hints.unrollCount));
+    } else if (true == hints.unrollEnable) {
+        addFlag("llvm.loop.unroll.enable");
+    }
+
+    if (true == hints.parallelAccesses) {
+        llvm::MDNode *accessGroup = llvm::MDNode::getDistinct(llvmContext, {});
+        llvm::Function *function = header->getParent();
+        for (auto block = firstBlock->getIterator(); block != function->end(); ++block) {
+            if (&*block == exit) {
+                continue;
+            }
+            for (llvm::Instruction &instruction : *block) {
+                if (false == instruction.mayReadOrWriteMemory()) {
+                    continue;
+                }
+                // Accesses of a nested loop already belong to its own group as well
+                instruction.setMetadata(
+                    llvm::LLVMContext::MD_access_group,
+                    llvm::uniteAccessGroups(instruction.getMetadata(llvm::LLVMContext::MD_access_group), accessGroup));
+            }
+        }
+        operands.push_back(llvm::MDNode::get(
+            llvmContext, {llvm::MDString::get(llvmContext, "llvm.loop.parallel_accesses"), accessGroup}));
+    }
+
+    llvm::MDNode *loopID = llvm::MDNode::getDistinct(llvmContext, operands);
+    loopID->replaceOperandWith(0, loopID);
+    for (llvm::BasicBlock *predecessor : llvm::predecessors(header)) {
+        if (predecessor != preheader && nullptr != predecessor->getTerminator()) {
+            predecessor->getTerminator()->setMetadata(llvm::LLVMContext::MD_loop, loopID);
+        }
+    }
+}
+
 StmtCodegenResult NForStatement::codegen(ASTContext &context) {
+    if (true == loopHints.parallelFor) {
+        return parallelCodegen(context);
+    }
+
     llvm::Function *function = context.currentFunction->getFunction();
     llvm::BasicBlock *afterBlock = llvm::BasicBlock::Create(context.llvmContext, "for_after", function);
     llvm::BasicBlock *loopCondition = llvm::BasicBlock::Create(context.llvmContext, "for_condition", function);
     llvm::BasicBlock *loopIncrement = llvm::BasicBlock::Create(context.llvmContext, "for_increment", function);
     llvm::BasicBlock *loopBody = nullptr;
 
+    // A variable declared in the init clause belongs to the loop, so sequential loops may each declare their own
+    auto scopeGuard = toyc::utility::makeScopeGuard([&context]() { context.popScope(); });
+    context.pushScope();
     initializationNode->setParent(this);
-    initializationNode->codegen(context);
+    StmtCodegenResult initResult = initializationNode->codegen(context);
+    if (false == initResult.isSuccess()) {
+        return StmtCodegenResult("For loop initialization generation failed") << initResult;
+    }
+    llvm::BasicBlock *preheader = context.builder.GetInsertBlock();
     context.builder.CreateBr(loopCondition);
 
     auto jumpGuard = toyc::utility::makeScopeGuard([&context]() { context.popJumpContext(); });
@@ -328,8 +834,388 @@ StmtCodegenResult NForStatement::codegen(ASTContext &context) {
         context.builder.CreateCondBr(conditionValue, loopBody, afterBlock);
     }
 
+    if (false == loopHints.empty()) {
+        attachLoopHints(context, loopHints, loopCondition, preheader, loopCondition, afterBlock);
+    }
     context.builder.SetInsertPoint(afterBlock);
+    ScopeChain outer(context.scopeStack.begin(), context.scopeStack.end() - 1);
+    context.emitScopeExit(context.scopeStack, outer);
+
+    return StmtCodegenResult();
+}
+
+// Pieces of a loop in OpenMP canonical form, `for (i = lb; i < ub; i += step)`
+struct CanonicalLoop {
+    std::string induction;
+    BineryOperator comparison = LT;  // LT, LE, GT or GE, with the induction variable on the left
+    NExpression *bound = nullptr;
+    NExpression *step = nullptr;  // nullptr for ++/--
+    bool isDecrement = false;     // --, -= or i = i - step
+};
+
+static bool matchCanonicalLoop(NStatement *initialization, NExpression *condition, NExpression *increment,
+                               CanonicalLoop &loop) {
+    auto *declaration = dynamic_cast<NDeclarationStatement *>(initialization);
+    auto *initExpression = dynamic_cast<NExpressionStatement *>(initialization);
+    if (nullptr != declaration && nullptr != declaration->getDeclarators()) {
+        NDeclarator *declarator = declaration->getDeclarators();
+        if (nullptr != declarator->next || true == declarator->isNonInitialized()) {
+            return false;
+        }
+        loop.induction = declarator->getName();
+    } else if (nullptr != initExpression) {
+        auto *assignment = dynamic_cast<NAssignment *>(initExpression->getExpression());
+        auto *target = nullptr != assignment ? dynamic_cast<NIdentifier *>(assignment->getLHS()) : nullptr;
+        if (nullptr == target) {
+            return false;
+        }
+        loop.induction = target->getName();
+    } else {
+        return false;
+    }
+
+    auto isInduction = [&loop](NExpression *expression) {
+        auto *identifier = dynamic_cast<NIdentifier *>(expression);
+        return nullptr != identifier && loop.induction == identifier->getName();
+    };
+
+    auto *comparison = dynamic_cast<NBinaryOperator *>(condition);
+    if (nullptr == comparison || nullptr != dynamic_cast<NLogicalOperator *>(condition) ||
+        false == isInduction(comparison->getLHS())) {
+        return false;
+    }
+    loop.comparison = comparison->getOperator();
+    loop.bound = comparison->getRHS();
+    if (LT != loop.comparison && LE != loop.comparison && GT != loop.comparison && GE != loop.comparison) {
+        return false;
+    }
+
+    if (auto *unary = dynamic_cast<NUnaryExpression *>(increment)) {
+        UnaryOperator op = unary->getOperator();
+        if ((L_INC != op && R_INC != op && L_DEC != op && R_DEC != op) || false == isInduction(unary->getOperand())) {
+            return false;
+        }
+        loop.isDecrement = L_DEC == op || R_DEC == op;
+    } else if (auto *compound = dynamic_cast<NCompoundAssignment *>(increment)) {
+        if ((ADD != compound->getOperator() && SUB != compound->getOperator()) ||
+            false == isInduction(compound->getLHS())) {
+            return false;
+        }
+        loop.step = compound->getRHS();
+        loop.isDecrement = SUB == compound->getOperator();
+    } else if (auto *assignment = dynamic_cast<NAssignment *>(increment)) {
+        // i = i + step, i = step + i or i = i - step
+        auto *sum = dynamic_cast<NBinaryOperator *>(assignment->getRHS());
+        if (false == isInduction(assignment->getLHS()) || nullptr == sum ||
+            (ADD != sum->getOperator() && SUB != sum->getOperator())) {
+            return false;
+        }
+        if (true == isInduction(sum->getLHS())) {
+            loop.step = sum->getRHS();
+        } else if (ADD == sum->getOperator() && true == isInduction(sum->getRHS())) {
+            loop.step = sum->getLHS();
+        } else {
+            return false;
+        }
+        loop.isDecrement = SUB == sum->getOperator();
+    } else {
+        return false;
+    }
+    // ++ and -- must move towards the bound; the sign of a += step is the programmer's promise
+    bool isAscending = LT == loop.comparison || LE == loop.comparison;
+    return nullptr != loop.step || isAscending != loop.isDecrement;
+}
+
+// The loop becomes `void <function>.omp_outlined(long lower, long upper, char *context)`, which runs iterations
+// [lower, upper) of the loop. Values of the enclosing function the body uses - the addresses of shared variables,
+// the start and step - reach it through a struct on the caller's stack. The runtime library calls it once per chunk
+// on its thread pool: __toyc_omp_parallel_for(trip_count, schedule, chunk_size, outlined, context). Private copies
+// of reduction variables start at 0 and are added to the shared variable under the runtime's reduction lock.
+StmtCodegenResult NForStatement::parallelCodegen(ASTContext &context) {
+    const std::string pragmaName = "'#pragma omp parallel for'";
+    CanonicalLoop loop;
+    if (false == matchCanonicalLoop(initializationNode.get(), conditionNode.get(), incrementNode.get(), loop)) {
+        return StmtCodegenResult(pragmaName + " needs a loop of the form 'for (i = lb; i < ub; i += step)'");
+    }
+
+    llvm::IRBuilder<> &builder = context.builder;
+    TypeManager &typeManager = context.getTypeManager();
+    llvm::Type *int64Type = builder.getInt64Ty();
+    TypeIdx longTypeIdx = typeManager.getPrimitiveIdx(VAR_TYPE_LONG);
+
+    // Trip count, evaluated once before the loop as OpenMP requires. As in a serial loop, the init clause's
+    // declaration belongs to the loop.
+    auto scopeGuard = toyc::utility::makeScopeGuard([&context]() { context.popScope(); });
+    context.pushScope();
+    initializationNode->setParent(this);
+    StmtCodegenResult initResult = initializationNode->codegen(context);
+    if (false == initResult.isSuccess()) {
+        return StmtCodegenResult("For loop initialization generation failed") << initResult;
+    }
+    auto [hasInduction, induction] = context.variableTable->lookup(loop.induction);
+    if (false == hasInduction || false == typeManager.isIntegerType(induction.second)) {
+        return StmtCodegenResult(pragmaName + " needs an integer loop variable");
+    }
+    TypeIdx inductionTypeIdx = induction.second;
+    llvm::Type *inductionType = typeManager.realize(inductionTypeIdx);
+    bool isSigned = typeManager.isSignedIntegerType(inductionTypeIdx);
+
+    llvm::LoadInst *startValue = builder.CreateLoad(inductionType, induction.first, loop.induction);
+    context.annotateAccess(startValue, inductionTypeIdx);
+    llvm::Value *start = builder.CreateIntCast(startValue, int64Type, isSigned, "omp_start");
+
+    ExprCodegenResult boundResult = loop.bound->codegen(context);
+    if (false == boundResult.isSuccess()) {
+        return StmtCodegenResult("For loop condition generation failed") << boundResult;
+    }
+    ExprCodegenResult boundCast =
+        typeManager.typeCast(boundResult.getValue(), boundResult.getType(), inductionTypeIdx, builder);
+    if (false == boundCast.isSuccess()) {
+        return StmtCodegenResult("Type cast failed for for loop condition") << boundCast;
+    }
+    llvm::Value *bound = builder.CreateIntCast(boundCast.getValue(), int64Type, isSigned, "omp_bound");
+
+    llvm::Value *step = builder.getInt64(1);
+    if (nullptr != loop.step) {
+        ExprCodegenResult stepResult = loop.step->codegen(context);
+        if (false == stepResult.isSuccess()) {
+            return StmtCodegenResult("For loop increment generation failed") << stepResult;
+        }
+        ExprCodegenResult stepCast =
+            typeManager.typeCast(stepResult.getValue(), stepResult.getType(), longTypeIdx, builder);
+        if (false == stepCast.isSuccess() || false == stepCast.getValue()->getType()->isIntegerTy()) {
+            return StmtCodegenResult(pragmaName + " needs an integer step");
+        }
+        step = stepCast.getValue();
+        auto *constantStep = llvm::dyn_cast<llvm::ConstantInt>(step);
+        if (nullptr != constantStep && true == constantStep->isZero()) {
+            return StmtCodegenResult(pragmaName + " needs a nonzero step");
+        }
+    }
+    if (true == loop.isDecrement) {
+        step = builder.CreateNeg(step, "omp_step");
+    }
+
+    bool isAscending = LT == loop.comparison || LE == loop.comparison;
+    llvm::Value *distance = isAscending ? builder.CreateSub(bound, start) : builder.CreateSub(start, bound);
+    if (LE == loop.comparison || GE == loop.comparison) {
+        distance = builder.CreateAdd(distance, builder.getInt64(1));
+    }
+    llvm::Value *stride = isAscending ? step : builder.CreateNeg(step);
+    // A step that is zero or moves away from the bound at run time runs no iterations rather than dividing by it
+    llvm::Value *hasStride = builder.CreateICmpSGT(stride, builder.getInt64(0));
+    llvm::Value *divisor = builder.CreateSelect(hasStride, stride, builder.getInt64(1));
+    llvm::Value *rounded = builder.CreateSub(builder.CreateAdd(distance, divisor), builder.getInt64(1));
+    llvm::Value *hasIterations = builder.CreateAnd(builder.CreateICmpSGT(distance, builder.getInt64(0)), hasStride);
+    llvm::Value *tripCount = builder.CreateSelect(hasIterations, builder.CreateSDiv(rounded, divisor),
+                                                  builder.getInt64(0), "omp_trip_count");
+
+    // Emit the outlined function with the caller's codegen state set aside
+    NFunctionDefinition *parentDefinition = context.currentFunction;
+    llvm::Function *parentFunction = parentDefinition->getFunction();
+    llvm::BasicBlock *parentBlock = builder.GetInsertBlock();
+    std::string outlinedName = parentFunction->getName().str() + ".omp_outlined";
+    for (int suffix = 1; nullptr != context.module.getFunction(outlinedName); ++suffix) {
+        outlinedName = parentFunction->getName().str() + ".omp_outlined." + std::to_string(suffix);
+    }
+
+    auto *params = new NParameter(longTypeIdx, "lower", nullptr);
+    params->next.reset(new NParameter(longTypeIdx, "upper", nullptr));
+    params->next->next.reset(
+        new NParameter(typeManager.getPointerIdx(typeManager.getPrimitiveIdx(VAR_TYPE_CHAR)), "context", nullptr));
+    NFunctionDefinition outlinedDefinition(typeManager.getPrimitiveIdx(VAR_TYPE_VOID), outlinedName, params, nullptr);
+    StmtCodegenResult declarationResult = outlinedDefinition.codegen(context);
+    if (false == declarationResult.isSuccess()) {
+        return StmtCodegenResult("Failed to outline " + pragmaName + " body") << declarationResult;
+    }
+    llvm::Function *outlined = outlinedDefinition.getFunction();
+    outlined->setLinkage(llvm::GlobalValue::InternalLinkage);
+    for (const llvm::Attribute &attribute : parentFunction->getAttributes().getFnAttrs()) {
+        if (true == attribute.isStringAttribute()) {
+            outlined->addFnAttr(attribute);  // no-builtins and friends
+        }
+    }
+
+    ScopeChain parentScopes = std::move(context.scopeStack);
+    std::stack<std::shared_ptr<NJumpContext>> parentJumpContexts = std::move(context.jumpContextStack);
+    std::map<std::string, llvm::BasicBlock *> parentLabels = std::move(context.labels);
+    std::map<std::string, ScopeChain> parentLabelScopes = std::move(context.labelScopes);
+    std::map<std::string, std::vector<ASTContext::PendingGoto>> parentPendingGotos = std::move(context.pendingGotos);
+    llvm::SwitchInst *parentSwitch = context.currentSwitch;
+    context.scopeStack.clear();
+    context.jumpContextStack = {};
+    context.clearLabels();
+    context.currentSwitch = nullptr;
+    context.currentFunction = &outlinedDefinition;
+    context.pushScope();
+    auto restoreParent = [&]() {
+        context.popScope();
+        context.scopeStack = std::move(parentScopes);
+        context.jumpContextStack = std::move(parentJumpContexts);
+        context.labels = std::move(parentLabels);
+        context.labelScopes = std::move(parentLabelScopes);
+        context.pendingGotos = std::move(parentPendingGotos);
+        context.currentSwitch = parentSwitch;
+        context.currentFunction = parentDefinition;
+        context.functionDefinitions.erase(outlinedName);
+        builder.SetInsertPoint(parentBlock);
+    };
+    auto restoreGuard = toyc::utility::makeScopeGuard(restoreParent);
+
+    auto argument = outlined->arg_begin();
+    llvm::Argument *lower = &*argument++;
+    llvm::Argument *upper = &*argument++;
+    llvm::Argument *contextArgument = &*argument;
+
+    llvm::BasicBlock *entryBlock = llvm::BasicBlock::Create(context.llvmContext, "entry", outlined);
+    builder.SetInsertPoint(entryBlock);
+    llvm::AllocaInst *iteration = builder.CreateAlloca(int64Type, nullptr, "omp_iteration");
+    builder.CreateStore(lower, iteration);
+    llvm::AllocaInst *privateInduction = builder.CreateAlloca(inductionType, nullptr, loop.induction);
+    context.variableTable->insert(loop.induction, std::make_pair(privateInduction, inductionTypeIdx));
+
+    for (const std::string &name : loopHints.privateVars) {
+        auto [found, shared] = context.variableTable->lookup(name);
+        if (false == found) {
+            return StmtCodegenResult("Undeclared variable '" + name + "' in private clause");
+        }
+        llvm::AllocaInst *copy = builder.CreateAlloca(typeManager.realize(shared.second), nullptr, name);
+        context.variableTable->insert(name, std::make_pair(copy, shared.second));
+    }
+
+    struct Reduction {
+        llvm::Value *shared;
+        llvm::AllocaInst *copy;
+        TypeIdx typeIdx;
+    };
+    std::vector<Reduction> reductions;
+    for (const std::string &name : loopHints.reductionVars) {
+        auto [found, shared] = context.variableTable->lookup(name);
+        if (false == found) {
+            return StmtCodegenResult("Undeclared variable '" + name + "' in reduction clause");
+        }
+        if (false == typeManager.isIntegerType(shared.second) &&
+            false == typeManager.isFloatingPointType(shared.second)) {
+            return StmtCodegenResult("Reduction variable '" + name + "' must have arithmetic type");
+        }
+        llvm::Type *type = typeManager.realize(shared.second);
+        llvm::AllocaInst *copy = builder.CreateAlloca(type, nullptr, name);
+        builder.CreateStore(llvm::Constant::getNullValue(type), copy);
+        context.variableTable->insert(name, std::make_pair(copy, shared.second));
+        reductions.push_back({shared.first, copy, shared.second});
+    }
+
+    llvm::BasicBlock *conditionBlock = llvm::BasicBlock::Create(context.llvmContext, "omp_condition", outlined);
+    llvm::BasicBlock *incrementBlock = llvm::BasicBlock::Create(context.llvmContext, "omp_increment", outlined);
+    llvm::BasicBlock *afterBlock = llvm::BasicBlock::Create(context.llvmContext, "omp_after", outlined);
+    builder.CreateBr(conditionBlock);
 
+    context.pushJumpContext(std::make_shared<NParallelForContext>(incrementBlock));
+    bodyNode->setParent(this);
+    bodyNode->setName("omp_body");
+    bodyNode->setNextBlock(incrementBlock);
+    StmtCodegenResult bodyResult = bodyNode->codegen(context);
+    context.popJumpContext();
+    if (false == bodyResult.isSuccess()) {
+        return StmtCodegenResult("For loop body generation failed") << bodyResult;
+    }
+    for (llvm::BasicBlock &block : *outlined) {
+        if (nullptr != block.getTerminator() && llvm::isa<llvm::ReturnInst>(block.getTerminator())) {
+            return StmtCodegenResult("Return statement in the body of " + pragmaName);
+        }
+    }
+
+    builder.SetInsertPoint(incrementBlock);
+    builder.CreateStore(builder.CreateAdd(builder.CreateLoad(int64Type, iteration), builder.getInt64(1)), iteration);
+    builder.CreateBr(conditionBlock);
+
+    // i = start + k * step for iteration k
+    builder.SetInsertPoint(conditionBlock);
+    llvm::Value *current = builder.CreateLoad(int64Type, iteration, "k");
+    llvm::Value *inductionValue = builder.CreateAdd(start, builder.CreateMul(current, step));
+    context.annotateAccess(
+        builder.CreateStore(builder.CreateIntCast(inductionValue, inductionType, isSigned), privateInduction),
+        inductionTypeIdx);
+    builder.CreateCondBr(builder.CreateICmpSLT(current, upper), bodyNode->getBlock(), afterBlock);
+    if (false == loopHints.empty()) {
+        attachLoopHints(context, loopHints, conditionBlock, entryBlock, conditionBlock, afterBlock);
+    }
+
+    builder.SetInsertPoint(afterBlock);
+    if (false == reductions.empty()) {
+        builder.CreateCall(context.module.getOrInsertFunction("__toyc_omp_reduce_begin", builder.getVoidTy()));
+        for (const Reduction &reduction : reductions) {
+            llvm::Type *type = reduction.copy->getAllocatedType();
+            llvm::LoadInst *sharedValue = builder.CreateLoad(type, reduction.shared);
+            llvm::LoadInst *partial = builder.CreateLoad(type, reduction.copy);
+            context.annotateAccess(sharedValue, reduction.typeIdx);
+            context.annotateAccess(partial, reduction.typeIdx);
+            llvm::Value *sum = type->isFloatingPointTy() ? builder.CreateFAdd(sharedValue, partial)
+                                                         : builder.CreateAdd(sharedValue, partial);
+            context.annotateAccess(builder.CreateStore(sum, reduction.shared), reduction.typeIdx);
+        }
+        builder.CreateCall(context.module.getOrInsertFunction("__toyc_omp_reduce_end", builder.getVoidTy()));
+    }
+    builder.CreateRetVoid();
+
+    // Everything the outlined body uses from the enclosing functions travels in one context struct. When loops
+    // nest, the inner body can use values of any outer function; the outer loop's outlining captures them in turn.
+    std::vector<llvm::Value *> captures;
+    for (llvm::BasicBlock &block : *outlined) {
+        for (llvm::Instruction &instruction : block) {
+            for (llvm::Value *operand : instruction.operands()) {
+                auto *definition = llvm::dyn_cast<llvm::Instruction>(operand);
+                auto *parameter = llvm::dyn_cast<llvm::Argument>(operand);
+                bool isOuterValue = (nullptr != definition && definition->getFunction() != outlined) ||
+                                    (nullptr != parameter && parameter->getParent() != outlined);
+                if (true == isOuterValue && captures.end() == std::find(captures.begin(), captures.end(), operand)) {
+                    captures.push_back(operand);
+                }
+            }
+        }
+    }
+    std::vector<llvm::Type *> captureTypes;
+    for (llvm::Value *capture : captures) {
+        captureTypes.push_back(capture->getType());
+    }
+    llvm::StructType *contextType = llvm::StructType::get(context.llvmContext, captureTypes);
+    auto firstInstruction = entryBlock->begin();
+    while (llvm::isa<llvm::AllocaInst>(*firstInstruction)) {
+        ++firstInstruction;
+    }
+    builder.SetInsertPoint(entryBlock, firstInstruction);
+    for (unsigned i = 0; i < captures.size(); ++i) {
+        llvm::Value *field = builder.CreateStructGEP(contextType, contextArgument, i);
+        llvm::Value *captured = builder.CreateLoad(captureTypes[i], field, captures[i]->getName());
+        captures[i]->replaceUsesWithIf(captured, [outlined](llvm::Use &use) {
+            return llvm::cast<llvm::Instruction>(use.getUser())->getFunction() == outlined;
+        });
+    }
+
+    StmtCodegenResult finalizeResult = outlinedDefinition.finalizeBody(context);
+    if (false == finalizeResult.isSuccess()) {
+        return StmtCodegenResult("Failed to outline " + pragmaName + " body") << finalizeResult;
+    }
+    restoreGuard.dismiss();
+    restoreParent();
+
+    // Back in the enclosing function: fill in the context and run the loop on the thread pool
+    llvm::Type *pointerType = builder.getPtrTy();
+    llvm::Value *contextPointer = llvm::ConstantPointerNull::get(builder.getPtrTy());
+    if (false == captures.empty()) {
+        llvm::AllocaInst *contextStorage = context.createEntryAlloca(contextType, "omp_context");
+        for (unsigned i = 0; i < captures.size(); ++i) {
+            builder.CreateStore(captures[i], builder.CreateStructGEP(contextType, contextStorage, i));
+        }
+        contextPointer = contextStorage;
+    }
+    llvm::FunctionCallee parallelFor =
+        context.module.getOrInsertFunction("__toyc_omp_parallel_for", builder.getVoidTy(), int64Type,
+                                           builder.getInt32Ty(), int64Type, pointerType, pointerType);
+    builder.CreateCall(parallelFor, {tripCount, builder.getInt32(loopHints.schedule),
+                                     builder.getInt64(loopHints.chunkSize), outlined, contextPointer});
+    ScopeChain outer(context.scopeStack.begin(), context.scopeStack.end() - 1);
+    context.emitScopeExit(context.scopeStack, outer);
     return StmtCodegenResult();
 }
 
@@ -379,6 +1265,10 @@ StmtCodegenResult NWhileStatement::codegen(ASTContext &context) {
         context.builder.CreateBr(loopCondition);
     }
 
+    if (false == loopHints.empty()) {
+        llvm::BasicBlock *header = (true == isDoWhile) ? loopBody : loopCondition;
+        attachLoopHints(context, loopHints, header, previousBlock, loopCondition, afterBlock);
+    }
     context.builder.SetInsertPoint(afterBlock);
 
     return StmtCodegenResult();
@@ -396,6 +1286,8 @@ StmtCodegenResult NBreakStatement::codegen(ASTContext &context) {
 
     // Get the break target from the jump context
     llvm::BasicBlock *breakTarget = jumpCtx->getBreakTarget();
+    ScopeChain outer(context.scopeStack.begin(), context.scopeStack.begin() + jumpCtx->getScopeDepth());
+    context.emitScopeExit(context.scopeStack, outer);
     context.builder.CreateBr(breakTarget);
 
     // Create an unreachable block after the break to avoid dangling insert point
@@ -418,6 +1310,8 @@ StmtCodegenResult NContinueStatement::codegen(ASTContext &context) {
 
     // Get the continue target from the jump context
     llvm::BasicBlock *continueTarget = jumpCtx->getContinueTarget();
+    ScopeChain outer(context.scopeStack.begin(), context.scopeStack.begin() + jumpCtx->getScopeDepth());
+    context.emitScopeExit(context.scopeStack, outer);
     context.builder.CreateBr(continueTarget);
 
     // Create an unreachable block after the continue to avoid dangling insert point
@@ -436,7 +1330,17 @@ StmtCodegenResult NLabelStatement::codegen(ASTContext &context) {
         if (!labelBlock->empty()) {
             return StmtCodegenResult("Label '" + label + "' is already defined");
         }
-        context.pendingGotos.erase(label);
+        // Patch the scope exits of earlier gotos in front of their branches now that the target is known
+        auto pending = context.pendingGotos.find(label);
+        if (context.pendingGotos.end() != pending) {
+            llvm::IRBuilderBase::InsertPointGuard insertGuard(context.builder);
+            for (const ASTContext::PendingGoto &pendingGoto : pending->second) {
+                context.dropBypassedLifetimes(pendingGoto.scopes, context.scopeStack);
+                context.builder.SetInsertPoint(pendingGoto.branch);
+                context.emitScopeExit(pendingGoto.scopes, context.scopeStack);
+            }
+            context.pendingGotos.erase(pending);
+        }
     } else {
         labelBlock = llvm::BasicBlock::Create(context.llvmContext, "label_" + label, function);
 
@@ -450,6 +1354,7 @@ StmtCodegenResult NLabelStatement::codegen(ASTContext &context) {
 
     // Set insert point to the label block
     context.builder.SetInsertPoint(labelBlock);
+    context.labelScopes[label] = context.scopeStack;
 
     // Generate code for the statement after the label
     if (statement) {
@@ -469,12 +1374,18 @@ StmtCodegenResult NGotoStatement::codegen(ASTContext &context) {
     if (!targetBlock) {
         // Label not yet defined, create a placeholder block
         targetBlock = llvm::BasicBlock::Create(context.llvmContext, "label_" + label, function);
+        context.registerLabel(label, targetBlock);
+    }
 
+    auto labelScopes = context.labelScopes.find(label);
+    if (context.labelScopes.end() != labelScopes) {
+        // Backward jump: the target scope chain is already known
+        context.dropBypassedLifetimes(context.scopeStack, labelScopes->second);
+        context.emitScopeExit(context.scopeStack, labelScopes->second);
         context.builder.CreateBr(targetBlock);
-        context.registerLabel(label, targetBlock);
-        context.pendingGotos.insert(label);
     } else {
-        context.builder.CreateBr(targetBlock);
+        llvm::BranchInst *branch = context.builder.CreateBr(targetBlock);
+        context.pendingGotos[label].push_back({branch, context.scopeStack});
     }
 
     // Create an unreachable block after the goto
@@ -484,8 +1395,31 @@ StmtCodegenResult NGotoStatement::codegen(ASTContext &context) {
     return StmtCodegenResult();
 }
 
+// Number of case labels directly in the switch body, used to size the SwitchInst up front
+static unsigned countCaseLabels(NStatement *body) {
+    unsigned count = 0;
+    NStatement *first = ("Block" == body->getType()) ? static_cast<NBlock *>(body)->getStatements() : body;
+    for (NStatement *stmt = first; nullptr != stmt; stmt = stmt->next.get()) {
+        auto *caseStmt = dynamic_cast<NCaseStatement *>(stmt);
+        if (nullptr != caseStmt && false == caseStmt->getIsDefault()) {
+            count++;
+        }
+    }
+    return count;
+}
+
 StmtCodegenResult NSwitchStatement::codegen(ASTContext &context) {
-    ExprCodegenResult condResult = condition->codegen(context);
+    // switch (__builtin_expect(x, v)) dispatches on x and weights the edge to case v as likely
+    NExpression *conditionExpr = condition.get();
+    NExpression *expectedExpr = nullptr;
+    auto *call = dynamic_cast<NFunctionCall *>(conditionExpr);
+    if (nullptr != call && "__builtin_expect" == call->getName() && nullptr != call->getArguments() &&
+        nullptr != call->getArguments()->next) {
+        conditionExpr = call->getArguments()->expr.get();
+        expectedExpr = call->getArguments()->next->expr.get();
+    }
+
+    ExprCodegenResult condResult = conditionExpr->codegen(context);
     llvm::Value *condValue = condResult.getValue();
     TypeIdx condTypeIdx = condResult.getType();
 
@@ -493,12 +1427,33 @@ StmtCodegenResult NSwitchStatement::codegen(ASTContext &context) {
         return StmtCodegenResult("Failed to evaluate switch condition") << condResult;
     }
 
-    TypeIdx intTypeIdx = context.typeManager->getPrimitiveIdx(VAR_TYPE_INT);
-    ExprCodegenResult castResult = context.typeManager->typeCast(condValue, condTypeIdx, intTypeIdx, context.builder);
-    if (false == castResult.isSuccess() || nullptr == castResult.getValue()) {
-        return StmtCodegenResult("Failed to cast switch condition to integer") << castResult;
+    // Integer promotion only: narrower types widen to int, long stays long
+    if (nullptr == condValue || false == condValue->getType()->isIntegerTy()) {
+        return StmtCodegenResult("Switch condition must have integer type");
+    }
+    TypeIdx switchTypeIdx = context.typeManager->unqualify(condTypeIdx);
+    if (condValue->getType()->getIntegerBitWidth() < 32) {
+        switchTypeIdx = context.typeManager->getPrimitiveIdx(VAR_TYPE_INT);
+        ExprCodegenResult castResult =
+            context.typeManager->typeCast(condValue, condTypeIdx, switchTypeIdx, context.builder);
+        if (false == castResult.isSuccess() || nullptr == castResult.getValue()) {
+            return StmtCodegenResult("Failed to cast switch condition to integer") << castResult;
+        }
+        condValue = castResult.getValue();
+    }
+
+    llvm::ConstantInt *expectedValue = nullptr;
+    if (nullptr != expectedExpr) {
+        ExprCodegenResult expectedResult = expectedExpr->codegen(context);
+        if (false == expectedResult.isSuccess()) {
+            return StmtCodegenResult("Failed to evaluate expected switch value") << expectedResult;
+        }
+        ExprCodegenResult castResult = context.typeManager->typeCast(
+            expectedResult.getValue(), expectedResult.getType(), switchTypeIdx, context.builder);
+        if (true == castResult.isSuccess()) {
+            expectedValue = llvm::dyn_cast<llvm::ConstantInt>(castResult.getValue());
+        }
     }
-    condValue = castResult.getValue();
 
     llvm::Function *function = context.currentFunction->getFunction();
     llvm::BasicBlock *currentBlock = context.builder.GetInsertBlock();
@@ -509,9 +1464,7 @@ StmtCodegenResult NSwitchStatement::codegen(ASTContext &context) {
     context.builder.CreateBr(switchBlock);
     context.builder.SetInsertPoint(switchBlock);
 
-    llvm::SwitchInst *switchInst = context.builder.CreateSwitch(condValue, defaultBlock,
-                                                                10  // Estimated number of cases
-    );
+    llvm::SwitchInst *switchInst = context.builder.CreateSwitch(condValue, defaultBlock, countCaseLabels(body.get()));
 
     auto jumpGuard = toyc::utility::makeScopeGuard([&context]() { context.popJumpContext(); });
     context.pushJumpContext(std::make_shared<NSwitchContext>(afterBlock));
@@ -521,17 +1474,27 @@ StmtCodegenResult NSwitchStatement::codegen(ASTContext &context) {
     llvm::BasicBlock *oldSwitchAfter = context.currentSwitchAfter;
     llvm::BasicBlock *oldDefaultBlock = context.currentSwitchDefault;
     bool oldHasDefault = context.switchHasDefault;
-    auto restoreGuard =
-        toyc::utility::makeScopeGuard([&context, oldSwitch, oldSwitchAfter, oldDefaultBlock, oldHasDefault]() {
-            context.currentSwitch = oldSwitch;
-            context.currentSwitchAfter = oldSwitchAfter;
-            context.currentSwitchDefault = oldDefaultBlock;
-            context.switchHasDefault = oldHasDefault;
-        });
+    ScopeChain oldSwitchScopes = context.currentSwitchScopes;
+    TypeIdx oldSwitchTypeIdx = context.currentSwitchTypeIdx;
+    std::vector<ASTContext::CaseRange> oldSwitchRanges = context.currentSwitchRanges;
+    auto restoreGuard = toyc::utility::makeScopeGuard([&context, oldSwitch, oldSwitchAfter, oldDefaultBlock,
+                                                       oldHasDefault, oldSwitchScopes, oldSwitchTypeIdx,
+                                                       oldSwitchRanges]() {
+        context.currentSwitch = oldSwitch;
+        context.currentSwitchAfter = oldSwitchAfter;
+        context.currentSwitchDefault = oldDefaultBlock;
+        context.switchHasDefault = oldHasDefault;
+        context.currentSwitchScopes = oldSwitchScopes;
+        context.currentSwitchTypeIdx = oldSwitchTypeIdx;
+        context.currentSwitchRanges = oldSwitchRanges;
+    });
     context.currentSwitch = switchInst;
     context.currentSwitchAfter = afterBlock;
     context.currentSwitchDefault = defaultBlock;
     context.switchHasDefault = false;
+    context.currentSwitchScopes = context.scopeStack;
+    context.currentSwitchTypeIdx = switchTypeIdx;
+    context.currentSwitchRanges.clear();
 
     StmtCodegenResult bodyResult = body->codegen(context);
     if (false == bodyResult.isSuccess()) {
@@ -549,11 +1512,53 @@ StmtCodegenResult NSwitchStatement::codegen(ASTContext &context) {
         context.builder.CreateBr(afterBlock);
     }
 
+    if (nullptr != expectedValue) {
+        // Same weights llvm.expect lowering would produce: the expected destination is likely
+        const uint32_t likelyWeight = 2000;
+        const uint32_t unlikelyWeight = 1;
+        bool expectsDefault = switchInst->case_default() == switchInst->findCaseValue(expectedValue);
+        std::vector<uint32_t> weights{expectsDefault ? likelyWeight : unlikelyWeight};
+        for (const auto &switchCase : switchInst->cases()) {
+            weights.push_back(switchCase.getCaseValue() == expectedValue ? likelyWeight : unlikelyWeight);
+        }
+        switchInst->setMetadata(llvm::LLVMContext::MD_prof,
+                                llvm::MDBuilder(context.llvmContext).createBranchWeights(weights));
+    }
+
+    // Wide case ranges are tested in order before falling through to the default destination
+    llvm::BasicBlock *fallback = switchInst->getDefaultDest();
+    for (auto range = context.currentSwitchRanges.rbegin(); range != context.currentSwitchRanges.rend(); ++range) {
+        llvm::BasicBlock *rangeBlock = llvm::BasicBlock::Create(context.llvmContext, "switch_range", function);
+        context.builder.SetInsertPoint(rangeBlock);
+        llvm::Value *offset = context.builder.CreateSub(condValue, range->low, "range_offset");
+        llvm::Constant *span = llvm::ConstantInt::get(condValue->getType(),
+                                                      range->high->getValue() - range->low->getValue());
+        llvm::Value *inRange = context.builder.CreateICmpULE(offset, span, "in_range");
+        context.builder.CreateCondBr(inRange, range->block, fallback);
+        fallback = rangeBlock;
+    }
+    switchInst->setDefaultDest(fallback);
+
     context.builder.SetInsertPoint(afterBlock);
 
     return StmtCodegenResult();
 }
 
+ExprCodegenResult NCaseStatement::evaluateLabel(ASTContext &context, NExpression *label) {
+    ExprCodegenResult valResult = label->codegen(context);
+    if (false == valResult.isSuccess()) {
+        return ExprCodegenResult("Failed to evaluate case value") << valResult;
+    }
+
+    // Labels convert to the promoted condition type, folding to a constant for the jump table
+    ExprCodegenResult castResult = context.typeManager->typeCast(valResult.getValue(), valResult.getType(),
+                                                                 context.currentSwitchTypeIdx, context.builder);
+    if (false == castResult.isSuccess() || nullptr == llvm::dyn_cast<llvm::ConstantInt>(castResult.getValue())) {
+        return ExprCodegenResult("Case value must be a constant integer");
+    }
+    return castResult;
+}
+
 StmtCodegenResult NCaseStatement::codegen(ASTContext &context) {
     llvm::Function *function = context.currentFunction->getFunction();
 
@@ -580,21 +1585,401 @@ StmtCodegenResult NCaseStatement::codegen(ASTContext &context) {
 
     // Register the case with the switch instruction
     if (false == isDefault) {
-        ExprCodegenResult valResult = value->codegen(context);
-        llvm::Value *caseValue = valResult.getValue();
-        if (false == valResult.isSuccess()) {
-            return StmtCodegenResult("Failed to evaluate case value") << valResult;
+        ExprCodegenResult lowResult = evaluateLabel(context, value.get());
+        if (false == lowResult.isSuccess()) {
+            return StmtCodegenResult("Invalid case label") << lowResult;
         }
-
-        llvm::ConstantInt *constInt = llvm::dyn_cast<llvm::ConstantInt>(caseValue);
-        if (nullptr == constInt) {
-            return StmtCodegenResult("Case value must be a constant integer");
+        auto *low = llvm::cast<llvm::ConstantInt>(lowResult.getValue());
+        llvm::ConstantInt *high = low;
+        if (nullptr != rangeEnd) {
+            ExprCodegenResult highResult = evaluateLabel(context, rangeEnd.get());
+            if (false == highResult.isSuccess()) {
+                return StmtCodegenResult("Invalid case range upper bound") << highResult;
+            }
+            high = llvm::cast<llvm::ConstantInt>(highResult.getValue());
         }
 
-        switchInst->addCase(constInt, caseBlock);
+        // Like GCC, an empty range (lo > hi) matches nothing. Small ranges are enumerated so they stay
+        // part of the jump table; wide ones are checked after the table misses. Bounds order by the
+        // signedness of the promoted condition type.
+        const uint64_t maxEnumeratedRange = 64;
+        bool isSigned = context.typeManager->isSignedIntegerType(context.currentSwitchTypeIdx);
+        auto lessOrEqual = [isSigned](const llvm::APInt &a, const llvm::APInt &b) {
+            return true == isSigned ? a.sle(b) : a.ule(b);
+        };
+        auto describe = [isSigned](const llvm::APInt &v) { return llvm::toString(v, 10, isSigned); };
+        std::string label = describe(low->getValue());
+        if (nullptr != rangeEnd) {
+            label += " ... " + describe(high->getValue());
+        }
+        llvm::APInt span = high->getValue() - low->getValue();
+        bool isEmptyRange = false == lessOrEqual(low->getValue(), high->getValue());
+        // A value or range already taken by a wide range, or a wide range that takes an existing case value
+        for (const ASTContext::CaseRange &range : context.currentSwitchRanges) {
+            if (false == isEmptyRange && true == lessOrEqual(range.low->getValue(), high->getValue()) &&
+                true == lessOrEqual(low->getValue(), range.high->getValue())) {
+                return StmtCodegenResult("Duplicate (or overlapping) case value: " + label + " overlaps the range " +
+                                         describe(range.low->getValue()) + " ... " + describe(range.high->getValue()));
+            }
+        }
+        if (false == isEmptyRange && span.ult(maxEnumeratedRange)) {
+            llvm::APInt caseValue = low->getValue();
+            for (uint64_t i = 0; i <= span.getZExtValue(); ++i, ++caseValue) {
+                llvm::ConstantInt *caseConst = llvm::ConstantInt::get(context.llvmContext, caseValue);
+                if (switchInst->case_default() != switchInst->findCaseValue(caseConst)) {
+                    return StmtCodegenResult("Duplicate case value: " + describe(caseValue));
+                }
+                switchInst->addCase(caseConst, caseBlock);
+            }
+        } else if (false == isEmptyRange) {
+            for (const auto &switchCase : switchInst->cases()) {
+                const llvm::APInt &caseValue = switchCase.getCaseValue()->getValue();
+                if (true == lessOrEqual(low->getValue(), caseValue) &&
+                    true == lessOrEqual(caseValue, high->getValue())) {
+                    return StmtCodegenResult("Duplicate (or overlapping) case value: the range " + label +
+                                             " contains " + describe(caseValue));
+                }
+            }
+            context.currentSwitchRanges.push_back({low, high, caseBlock});
+        }
     }
 
+    // Declarations in the switch body that precede this label are jumped over by the dispatch
+    context.dropBypassedLifetimes(context.currentSwitchScopes, context.scopeStack);
+
     context.builder.SetInsertPoint(caseBlock);
 
     return StmtCodegenResult();
 }
+
+// x86 constraint letters that name one register, spelled the way LLVM expects
+static const std::map<char, std::string> asmRegisterLetters = {{'a', "{ax}"}, {'b', "{bx}"}, {'c', "{cx}"},
+                                                               {'d', "{dx}"}, {'S', "{si}"}, {'D', "{di}"}};
+
+// Translates the letters of a GCC constraint, stripped of its `=`, `+`, `&` and `%` modifiers
+static std::string lowerConstraintLetters(const std::string &letters) {
+    std::string lowered;
+    for (char letter : letters) {
+        auto it = asmRegisterLetters.find(letter);
+        if (asmRegisterLetters.end() != it) {
+            lowered += it->second;
+        } else if ('g' == letter) {
+            lowered += "imr";
+        } else {
+            lowered += letter;
+        }
+    }
+    return lowered;
+}
+
+// Operands that can only live in memory are passed by address (LLVM's indirect `*m` constraints)
+static bool isMemoryOnlyConstraint(const std::string &letters) {
+    return false == letters.empty() && std::string::npos == letters.find_first_not_of("moV<>");
+}
+
+static std::string stripConstraintModifiers(std::string constraint, const std::string &modifiers) {
+    constraint.erase(std::remove_if(constraint.begin(), constraint.end(),
+                                    [&](char c) { return std::string::npos != modifiers.find(c); }),
+                     constraint.end());
+    return constraint;
+}
+
+int NAsmStatement::findOperand(const std::string &name) const {
+    for (size_t i = 0; i < outputs.size(); i++) {
+        if (name == outputs[i].name) {
+            return static_cast<int>(i);
+        }
+    }
+    for (size_t i = 0; i < inputs.size(); i++) {
+        if (name == inputs[i].name) {
+            return static_cast<int>(outputs.size() + i);
+        }
+    }
+    return -1;
+}
+
+StmtCodegenResult NAsmStatement::lowerTemplate(std::string &lowered) const {
+    const int operandCount = static_cast<int>(outputs.size() + inputs.size());
+    for (size_t i = 0; i < asmTemplate.size(); i++) {
+        char c = asmTemplate[i];
+        if ('$' == c) {
+            lowered += "$$";
+            continue;
+        }
+        // Unescaped braces and bars select between AT&T and Intel syntax; LLVM spells them $( $| $)
+        if ('{' == c || '|' == c || '}' == c) {
+            lowered += '$';
+            lowered += ('{' == c) ? '(' : ('}' == c) ? ')' : '|';
+            continue;
+        }
+        if ('%' != c) {
+            lowered += c;
+            continue;
+        }
+        if (++i == asmTemplate.size()) {
+            return StmtCodegenResult("Asm template ends with '%'");
+        }
+        c = asmTemplate[i];
+        if ('%' == c || '{' == c || '|' == c || '}' == c) {
+            lowered += c;
+            continue;
+        }
+        if ('=' == c) {
+            lowered += "${:uid}";
+            continue;
+        }
+
+        // %[modifier](N | [name]), e.g. %0, %k1, %[value], %b[value]
+        std::string modifier;
+        if (0 != std::isalpha(static_cast<unsigned char>(c))) {
+            modifier = c;
+            if (++i == asmTemplate.size()) {
+                return StmtCodegenResult("Asm template ends with '%" + modifier + "'");
+            }
+            c = asmTemplate[i];
+        }
+        int operand = 0;
+        if (0 != std::isdigit(static_cast<unsigned char>(c))) {
+            size_t end = i;
+            while (end < asmTemplate.size() && 0 != std::isdigit(static_cast<unsigned char>(asmTemplate[end]))) {
+                end++;
+            }
+            operand = std::stoi(asmTemplate.substr(i, end - i));
+            i = end - 1;
+        } else if ('[' == c) {
+            size_t close = asmTemplate.find(']', i);
+            if (std::string::npos == close) {
+                return StmtCodegenResult("Unterminated operand name in asm template");
+            }
+            std::string name = asmTemplate.substr(i + 1, close - i - 1);
+            operand = findOperand(name);
+            if (operand < 0) {
+                return StmtCodegenResult("Undefined named operand '" + name + "' in asm template");
+            }
+            i = close;
+        } else {
+            return StmtCodegenResult(std::string("Invalid '%") + c + "' in asm template");
+        }
+        if (operand >= operandCount) {
+            return StmtCodegenResult("Invalid operand number " + std::to_string(operand) + " in asm template");
+        }
+        lowered += modifier.empty() ? "$" + std::to_string(operand)
+                                    : "${" + std::to_string(operand) + ":" + modifier + "}";
+    }
+    return StmtCodegenResult();
+}
+
+StmtCodegenResult NAsmStatement::codegen(ASTContext &context) {
+    std::string loweredTemplate;
+    StmtCodegenResult templateResult = lowerTemplate(loweredTemplate);
+    if (false == templateResult.isSuccess()) {
+        return templateResult;
+    }
+
+    // Constraints run outputs, inputs, then the inputs tied to `+` outputs; the call's arguments are the
+    // addresses of memory outputs followed by the input values in the same order
+    std::vector<std::string> constraints;
+    std::vector<llvm::Value *> arguments;
+    std::vector<std::pair<unsigned, llvm::Type *>> elementTypes;  // argument number -> type of the memory operand
+    std::vector<std::string> tiedConstraints;
+    std::vector<llvm::Value *> tiedArguments;
+    std::vector<AllocCodegenResult> results;  // lvalues receiving the register outputs, in return order
+    std::vector<llvm::Type *> resultTypes;
+    std::vector<int> resultOfOutput(outputs.size(), -1);
+    bool readsMemory = false;
+    bool writesMemory = false;
+
+    for (size_t i = 0; i < outputs.size(); i++) {
+        const std::string &constraint = outputs[i].constraint;
+        const std::string operandName = "Asm output operand " + std::to_string(i);
+        if (constraint.empty() || ('=' != constraint.front() && '+' != constraint.front())) {
+            return StmtCodegenResult(operandName + " constraint must start with '=' or '+'");
+        }
+        bool readWrite = '+' == constraint.front();
+        bool earlyClobber = std::string::npos != constraint.find('&');
+        std::string letters = lowerConstraintLetters(stripConstraintModifiers(constraint, "=+&%"));
+
+        AllocCodegenResult lvalue = outputs[i].expression->allocgen(context);
+        if (false == lvalue.isSuccess()) {
+            return StmtCodegenResult(operandName + " is not an lvalue") << lvalue;
+        }
+        TypeIdx typeIdx = lvalue.getType();
+        if (true == context.typeManager->isConstQualified(typeIdx)) {
+            return StmtCodegenResult(operandName + " is const-qualified");
+        }
+        llvm::Type *type = context.typeManager->realize(typeIdx);
+
+        if (true == isMemoryOnlyConstraint(letters)) {
+            if (0 != lvalue.getBitField().width) {
+                return StmtCodegenResult(operandName + " is a bit-field and cannot be addressed");
+            }
+            constraints.push_back("=*" + letters);
+            elementTypes.emplace_back(arguments.size(), type);
+            arguments.push_back(lvalue.getAllocaInst());
+            writesMemory = true;
+            if (true == readWrite) {
+                tiedConstraints.push_back("*" + letters);
+                tiedArguments.push_back(lvalue.getAllocaInst());
+                readsMemory = true;
+            }
+            continue;
+        }
+
+        if (type->isAggregateType()) {
+            return StmtCodegenResult(operandName + " does not fit in a register");
+        }
+        if (true == readWrite) {
+            llvm::Value *current = nullptr;
+            if (0 != lvalue.getBitField().width) {
+                current = context.loadBitField(lvalue);
+            } else {
+                bool isVolatile = context.typeManager->isVolatileQualified(typeIdx);
+                llvm::LoadInst *load =
+                    context.builder.CreateLoad(type, lvalue.getAllocaInst(), isVolatile, "asm_inout");
+                context.annotateAccess(load, typeIdx);
+                current = load;
+            }
+            tiedConstraints.push_back(std::to_string(i));
+            tiedArguments.push_back(current);
+        }
+        constraints.push_back((true == earlyClobber ? "=&" : "=") + letters);
+        resultOfOutput[i] = static_cast<int>(results.size());
+        results.push_back(lvalue);
+        resultTypes.push_back(type);
+    }
+
+    for (size_t i = 0; i < inputs.size(); i++) {
+        std::string constraint = stripConstraintModifiers(inputs[i].constraint, "%");
+        const std::string operandName = "Asm input operand " + std::to_string(outputs.size() + i);
+        if (constraint.empty() || std::string::npos != constraint.find_first_of("=+&")) {
+            return StmtCodegenResult(operandName + " has an invalid constraint '" + inputs[i].constraint + "'");
+        }
+
+        // "0" or "[name]" shares the register of an output
+        int tiedOutput = -1;
+        if (std::string::npos == constraint.find_first_not_of("0123456789")) {
+            tiedOutput = std::stoi(constraint);
+        } else if ('[' == constraint.front() && ']' == constraint.back()) {
+            tiedOutput = findOperand(constraint.substr(1, constraint.size() - 2));
+        }
+        if (tiedOutput >= 0 || '[' == constraint.front()) {
+            if (tiedOutput < 0 || tiedOutput >= static_cast<int>(outputs.size()) || resultOfOutput[tiedOutput] < 0) {
+                return StmtCodegenResult(operandName + " is tied to an invalid output operand");
+            }
+            ExprCodegenResult valueResult = inputs[i].expression->codegen(context);
+            if (false == valueResult.isSuccess()) {
+                return StmtCodegenResult("Failed to generate code for " + operandName) << valueResult;
+            }
+            TypeIdx outputTypeIdx = results[resultOfOutput[tiedOutput]].getType();
+            ExprCodegenResult castResult = context.typeManager->typeCast(
+                valueResult.getValue(), valueResult.getType(), outputTypeIdx, context.builder);
+            if (false == castResult.isSuccess()) {
+                return StmtCodegenResult("Type cast failed for " + operandName) << castResult;
+            }
+            constraints.push_back(std::to_string(tiedOutput));
+            arguments.push_back(castResult.getValue());
+            continue;
+        }
+
+        std::string letters = lowerConstraintLetters(constraint);
+        if (true == isMemoryOnlyConstraint(letters)) {
+            AllocCodegenResult address = inputs[i].expression->aggregategen(context);
+            if (false == address.isSuccess()) {
+                return StmtCodegenResult("Failed to generate code for " + operandName) << address;
+            }
+            if (0 != address.getBitField().width) {
+                return StmtCodegenResult(operandName + " is a bit-field and cannot be addressed");
+            }
+            constraints.push_back("*" + letters);
+            elementTypes.emplace_back(arguments.size(), context.typeManager->realize(address.getType()));
+            arguments.push_back(address.getAllocaInst());
+            readsMemory = true;
+            continue;
+        }
+
+        ExprCodegenResult valueResult = inputs[i].expression->codegen(context);
+        if (false == valueResult.isSuccess()) {
+            return StmtCodegenResult("Failed to generate code for " + operandName) << valueResult;
+        }
+        llvm::Value *value = valueResult.getValue();
+        if (value->getType()->isAggregateType()) {
+            return StmtCodegenResult(operandName + " does not fit in a register");
+        }
+        if (std::string::npos == letters.find_first_not_of("in") && false == llvm::isa<llvm::Constant>(value)) {
+            return StmtCodegenResult(operandName + " must be a constant");
+        }
+        constraints.push_back(letters);
+        arguments.push_back(value);
+    }
+    constraints.insert(constraints.end(), tiedConstraints.begin(), tiedConstraints.end());
+    arguments.insert(arguments.end(), tiedArguments.begin(), tiedArguments.end());
+
+    bool clobbersMemory = false;
+    for (std::string clobber : clobbers) {
+        if ("memory" == clobber) {
+            clobbersMemory = true;
+        } else if ("cc" == clobber) {
+            continue;  // the flags are always clobbered below
+        }
+        if (false == clobber.empty() && '%' == clobber.front()) {
+            clobber.erase(0, 1);
+        }
+        if (clobber.empty()) {
+            return StmtCodegenResult("Empty register name in asm clobber list");
+        }
+        constraints.push_back("~{" + clobber + "}");
+    }
+    // Like GCC on x86, every asm statement may change the direction, x87 status and condition flags
+    constraints.insert(constraints.end(), {"~{dirflag}", "~{fpsr}", "~{flags}"});
+
+    std::string constraintString;
+    for (const std::string &constraint : constraints) {
+        constraintString += (constraintString.empty() ? "" : ",") + constraint;
+    }
+
+    llvm::Type *returnType = context.builder.getVoidTy();
+    if (1 == resultTypes.size()) {
+        returnType = resultTypes.front();
+    } else if (resultTypes.size() > 1) {
+        returnType = llvm::StructType::get(context.llvmContext, resultTypes);
+    }
+    std::vector<llvm::Type *> argumentTypes;
+    for (llvm::Value *argument : arguments) {
+        argumentTypes.push_back(argument->getType());
+    }
+    llvm::FunctionType *asmType = llvm::FunctionType::get(returnType, argumentTypes, false);
+
+    // An asm without outputs is implicitly volatile; otherwise it is a pure function of its operands that
+    // LLVM may hoist, merge or delete
+    bool hasSideEffects = true == isVolatile || true == outputs.empty();
+    llvm::InlineAsm *inlineAsm = llvm::InlineAsm::get(asmType, loweredTemplate, constraintString, hasSideEffects);
+    llvm::CallInst *call = context.builder.CreateCall(asmType, inlineAsm, arguments);
+    call->addFnAttr(llvm::Attribute::NoUnwind);
+    for (const auto &[argumentNumber, elementType] : elementTypes) {
+        call->addParamAttr(argumentNumber,
+                           llvm::Attribute::get(context.llvmContext, llvm::Attribute::ElementType, elementType));
+    }
+    if (false == hasSideEffects && false == clobbersMemory) {
+        if (false == readsMemory && false == writesMemory) {
+            call->setDoesNotAccessMemory();
+        } else if (false == writesMemory) {
+            call->setOnlyReadsMemory();
+        }
+    }
+
+    for (size_t i = 0; i < results.size(); i++) {
+        llvm::Value *value = call;
+        if (results.size() > 1) {
+            value = context.builder.CreateExtractValue(call, static_cast<unsigned>(i), "asm_output");
+        }
+        if (0 != results[i].getBitField().width) {
+            context.storeBitField(results[i], value);
+            continue;
+        }
+        TypeIdx typeIdx = results[i].getType();
+        bool isVolatile = context.typeManager->isVolatileQualified(typeIdx);
+        context.annotateAccess(context.builder.CreateStore(value, results[i].getAllocaInst(), isVolatile), typeIdx);
+    }
+
+    return StmtCodegenResult();
+}
@@ -1,10 +1,16 @@
 #include "ast/type.hpp"
 
+#include <llvm/IR/DataLayout.h>
 #include <llvm/IR/DerivedTypes.h>
 #include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/MDBuilder.h>
 #include <llvm/IR/Module.h>
+#include <llvm/IR/Operator.h>
 #include <llvm/IR/Type.h>
+#include <llvm/Support/MathExtras.h>
 
+#include <algorithm>
+#include <iomanip>
 #include <iostream>
 #include <string>
 
@@ -22,17 +28,32 @@ NStructDeclaration::~NStructDeclaration() = default;
 
 // ==================== StructTypeCodegen ====================
 
-StructTypeCodegen::StructTypeCodegen(std::string name, NStructDeclaration* members) : name(std::move(name)) {
-    setMembers(members);
-    delete members;  // StructTypeCodegen takes ownership of members
+StructTypeCodegen::StructTypeCodegen(std::string name, std::vector<MemberInfo> members)
+    : name(std::move(name)), memberInfos(std::move(members)) {}
+
+void StructTypeCodegen::setMembers(std::vector<MemberInfo> members) {
+    memberInfos = std::move(members);
+}
+
+void StructTypeCodegen::setLayoutAttributes(bool packed, uint64_t alignment) {
+    this->packed = this->packed || packed;
+    requestedAlignment = std::max(requestedAlignment, alignment);
 }
 
-void StructTypeCodegen::setMembers(NStructDeclaration* m) {
-    memberInfos.clear();
-    int index = 0;
-    for (NStructDeclaration* cur = m; cur != nullptr; cur = cur->next.get(), ++index) {
-        memberInfos.push_back({cur->declarator->getName(), cur->typeIdx});
+unsigned StructTypeCodegen::getElementIndex(int memberIndex) const {
+    if (memberIndex >= 0 && static_cast<size_t>(memberIndex) < elementIndices.size())
+        return elementIndices[memberIndex];
+    return static_cast<unsigned>(memberIndex);
+}
+
+int StructTypeCodegen::getMemberIndexForElement(unsigned elementIndex) const {
+    if (elementIndices.empty())
+        return elementIndex < memberInfos.size() ? static_cast<int>(elementIndex) : -1;
+    for (size_t i = 0; i < elementIndices.size(); ++i) {
+        if (elementIndices[i] == elementIndex && memberInfos[i].bitWidth < 0)
+            return static_cast<int>(i);
     }
+    return -1;  // a padding or bit-field element
 }
 
 int StructTypeCodegen::getMemberIndex(const std::string& memberName) const {
@@ -59,12 +80,16 @@ llvm::Type* PrimitiveTypeCodegen::getLLVMType(TypeManager& /*tm*/, llvm::LLVMCon
         case VAR_TYPE_BOOL:
             return llvm::Type::getInt1Ty(context);
         case VAR_TYPE_CHAR:
+        case VAR_TYPE_UCHAR:
             return llvm::Type::getInt8Ty(context);
         case VAR_TYPE_SHORT:
+        case VAR_TYPE_USHORT:
             return llvm::Type::getInt16Ty(context);
         case VAR_TYPE_INT:
+        case VAR_TYPE_UINT:
             return llvm::Type::getInt32Ty(context);
         case VAR_TYPE_LONG:
+        case VAR_TYPE_ULONG:
             return llvm::Type::getInt64Ty(context);
         case VAR_TYPE_FLOAT:
             return llvm::Type::getFloatTy(context);
@@ -99,6 +124,23 @@ llvm::Type* ArrayTypeCodegen::getLLVMType(TypeManager& tm, llvm::LLVMContext& /*
     return llvm::ArrayType::get(elemLLVMType, size);
 }
 
+llvm::Type* VectorTypeCodegen::getLLVMType(TypeManager& tm, llvm::LLVMContext& /*context*/,
+                                           llvm::Module& /*module*/) {
+    llvm::Type* elemLLVMType = tm.realize(elementIdx);
+    if (!elemLLVMType)
+        return nullptr;
+    return llvm::FixedVectorType::get(elemLLVMType, lanes);
+}
+
+// Width of the storage unit for a bit-field starting `shift` bits into a byte: the bytes it touches, widened to a
+// power of two when that many bytes are still available
+static BitFieldSlot bitFieldSlot(uint64_t shift, int width, uint64_t availableBytes) {
+    uint64_t bytes = llvm::divideCeil(shift + width, 8);
+    uint64_t widened = llvm::PowerOf2Ceil(bytes);
+    unsigned storageBits = static_cast<unsigned>(8 * (widened <= availableBytes ? widened : bytes));
+    return BitFieldSlot{storageBits, static_cast<unsigned>(shift), static_cast<unsigned>(width)};
+}
+
 llvm::Type* StructTypeCodegen::getLLVMType(TypeManager& tm, llvm::LLVMContext& context, llvm::Module& module) {
     llvm::StructType* existing = llvm::StructType::getTypeByName(module.getContext(), name);
     if (existing && !existing->isOpaque())
@@ -110,15 +152,158 @@ llvm::Type* StructTypeCodegen::getLLVMType(TypeManager& tm, llvm::LLVMContext& c
         return llvmStruct;
     }
 
+    const llvm::DataLayout& dataLayout = module.getDataLayout();
     std::vector<llvm::Type*> memberLLVMTypes;
+    std::vector<uint64_t> memberAlignments;
+    bool isNatural = false == packed && 0 == requestedAlignment;
     for (const MemberInfo& memberInfo : memberInfos) {
         llvm::Type* memberType = tm.realize(memberInfo.typeIdx);
         if (!memberType)
             break;
+        uint64_t memberAlignment = (packed || memberInfo.packed) ? 1 : tm.getAlignment(memberInfo.typeIdx);
+        memberAlignment = std::max(memberAlignment, memberInfo.alignment);
+        isNatural = isNatural && memberAlignment == dataLayout.getABITypeAlign(memberType).value() &&
+                    memberInfo.bitWidth < 0;
+        memberLLVMTypes.push_back(memberType);
+        memberAlignments.push_back(memberAlignment);
+    }
+
+    elementIndices.clear();
+    bitFieldStorage.assign(memberInfos.size(), BitFieldStorage());
+    if (true == isNatural) {
+        llvmStruct->setBody(memberLLVMTypes);
+        alignment = dataLayout.getABITypeAlign(llvmStruct).value();
+        return llvmStruct;
+    }
+
+    // Place each member by hand and spell out every hole, including the tail padding that rounds the size up
+    // to the struct's alignment. Bit-fields are allocated from the least significant bit as in the SysV ABI:
+    // one moves on to the next unit of its declared type only if it would straddle a unit boundary (packed ones
+    // never do), and a zero-width one closes the current unit. A run of bit-fields becomes one byte array.
+    llvm::Type* byteType = llvm::Type::getInt8Ty(context);
+    std::vector<llvm::Type*> elements;
+    uint64_t offset = 0;  // bytes covered by elements so far
+    uint64_t bit = 0;     // first free bit
+    std::vector<size_t> run;
+    std::vector<uint64_t> bitOffsets(memberInfos.size(), 0);
+    uint64_t runStart = 0;
+    uint64_t runEnd = 0;
+    alignment = 1;
+    auto closeRun = [&]() {
+        if (true == run.empty())
+            return;
+        if (runStart > offset)
+            elements.push_back(llvm::ArrayType::get(byteType, runStart - offset));
+        auto element = static_cast<unsigned>(elements.size());
+        elements.push_back(llvm::ArrayType::get(byteType, runEnd - runStart));
+        for (size_t member : run) {
+            uint64_t firstByte = bitOffsets[member] / 8;
+            elementIndices[member] = element;
+            bitFieldStorage[member].byteOffset = static_cast<unsigned>(firstByte - runStart);
+            bitFieldStorage[member].slot =
+                bitFieldSlot(bitOffsets[member] % 8, memberInfos[member].bitWidth, runEnd - firstByte);
+        }
+        offset = runEnd;
+        run.clear();
+    };
+    for (size_t i = 0; i < memberLLVMTypes.size(); ++i) {
+        const MemberInfo& member = memberInfos[i];
+        if (member.bitWidth >= 0) {
+            uint64_t unitBits = 8 * dataLayout.getTypeAllocSize(memberLLVMTypes[i]);
+            bool isPacked = packed || member.packed;
+            elementIndices.push_back(NoElement);
+            if (0 == member.bitWidth) {
+                bit = llvm::alignTo(bit, unitBits);
+                continue;
+            }
+            if (false == isPacked && bit / unitBits != (bit + member.bitWidth - 1) / unitBits)
+                bit = llvm::alignTo(bit, unitBits);
+            if (true == run.empty())
+                runStart = bit / 8;
+            bitOffsets[i] = bit;
+            run.push_back(i);
+            bit += member.bitWidth;
+            runEnd = llvm::divideCeil(bit, 8);
+            // Unnamed bit-fields only pad; they do not align the struct
+            if (false == member.name.empty())
+                alignment = std::max(alignment, memberAlignments[i]);
+            continue;
+        }
+        closeRun();
+        uint64_t memberOffset = llvm::alignTo(std::max(offset, llvm::divideCeil(bit, 8)), memberAlignments[i]);
+        if (memberOffset > offset)
+            elements.push_back(llvm::ArrayType::get(byteType, memberOffset - offset));
+        elementIndices.push_back(static_cast<unsigned>(elements.size()));
+        elements.push_back(memberLLVMTypes[i]);
+        offset = memberOffset + dataLayout.getTypeAllocSize(memberLLVMTypes[i]);
+        bit = 8 * offset;
+        alignment = std::max(alignment, memberAlignments[i]);
+    }
+    closeRun();
+    alignment = std::max(alignment, requestedAlignment);
+    uint64_t size = llvm::alignTo(std::max(offset, llvm::divideCeil(bit, 8)), alignment);
+    if (size > offset)
+        elements.push_back(llvm::ArrayType::get(byteType, size - offset));
+
+    llvmStruct->setBody(elements, true);
+    return llvmStruct;
+}
+
+llvm::Type* UnionTypeCodegen::getLLVMType(TypeManager& tm, llvm::LLVMContext& context, llvm::Module& module) {
+    std::string llvmName = getLLVMName();
+    llvm::StructType* existing = llvm::StructType::getTypeByName(module.getContext(), llvmName);
+    if (existing && !existing->isOpaque())
+        return existing;
+
+    llvm::StructType* llvmStruct = llvm::StructType::create(context, llvmName);
+    if (false == this->hasMembers()) {
+        return llvmStruct;
+    }
+
+    // Sized to the largest member and aligned to the strictest one; named bit-fields count with their
+    // declared type's alignment, and only occupy the bytes their width needs
+    const llvm::DataLayout& dataLayout = module.getDataLayout();
+    std::vector<llvm::Type*> memberLLVMTypes;
+    uint64_t size = 0;
+    alignment = 1;
+    for (const MemberInfo& memberInfo : memberInfos) {
+        llvm::Type* memberType = tm.realize(memberInfo.typeIdx);
+        if (!memberType)
+            return llvmStruct;
+        uint64_t memberAlignment = (packed || memberInfo.packed) ? 1 : tm.getAlignment(memberInfo.typeIdx);
+        memberAlignment = std::max(memberAlignment, memberInfo.alignment);
+        if (memberInfo.bitWidth >= 0) {
+            size = std::max(size, llvm::divideCeil(static_cast<uint64_t>(memberInfo.bitWidth), 8));
+            if (true == memberInfo.name.empty())
+                memberAlignment = 1;
+        } else {
+            size = std::max(size, static_cast<uint64_t>(dataLayout.getTypeAllocSize(memberType)));
+        }
+        alignment = std::max(alignment, memberAlignment);
         memberLLVMTypes.push_back(memberType);
     }
+    alignment = std::max(alignment, requestedAlignment);
+    size = llvm::alignTo(size, alignment);
 
-    llvmStruct->setBody(memberLLVMTypes);
+    elementIndices.assign(memberInfos.size(), 0);
+    bitFieldStorage.assign(memberInfos.size(), BitFieldStorage());
+    for (size_t i = 0; i < memberInfos.size(); ++i) {
+        if (memberInfos[i].bitWidth > 0)
+            bitFieldStorage[i].slot = bitFieldSlot(0, memberInfos[i].bitWidth, size);
+    }
+
+    // The first named member is the one an initializer sets
+    size_t firstNamed = 0;
+    while (firstNamed + 1 < memberInfos.size() && true == memberInfos[firstNamed].name.empty())
+        ++firstNamed;
+    llvm::Type* byteType = llvm::Type::getInt8Ty(context);
+    llvm::Type* first = memberInfos[firstNamed].bitWidth >= 0 ? llvm::ArrayType::get(byteType, size)
+                                                              : memberLLVMTypes[firstNamed];
+    std::vector<llvm::Type*> elements{first};
+    uint64_t firstSize = dataLayout.getTypeAllocSize(first);
+    if (size > firstSize)
+        elements.push_back(llvm::ArrayType::get(byteType, size - firstSize));
+    llvmStruct->setBody(elements, true);
     return llvmStruct;
 }
 
@@ -156,6 +341,11 @@ TypeIdx TypeManager::getPointerIdx(TypeIdx pointee, int level) {
 TypeIdx TypeManager::getQualifiedIdx(TypeIdx base, uint8_t qualifiers) {
     if (qualifiers == QUAL_NONE)
         return base;
+    // `const _Atomic int` folds into one layer, so each is*Qualified query sees every qualifier
+    if (auto* q = dynamic_cast<const QualifiedTypeCodegen*>(get(base))) {
+        qualifiers |= q->getQualifiers();
+        base = q->getBaseIdx();
+    }
     TypeKey key;
     key.kind = TypeKey::Qualified;
     key.baseIdx = base;
@@ -175,21 +365,170 @@ TypeIdx TypeManager::getArrayIdx(TypeIdx elem, std::vector<int> dims) {
     return current;
 }
 
+TypeIdx TypeManager::getVectorIdx(TypeIdx elem, int lanes) {
+    TypeKey key;
+    key.kind = TypeKey::Vector;
+    key.elementIdx = unqualify(elem);
+    key.size = lanes;
+    return registerType(key, std::make_unique<VectorTypeCodegen>(key.elementIdx, lanes));
+}
+
 TypeIdx TypeManager::getStructIdx(const std::string& name, NStructDeclaration* members) {
+    return getRecordIdx(TypeKey::Struct, name, members);
+}
+
+TypeIdx TypeManager::getUnionIdx(const std::string& name, NStructDeclaration* members) {
+    return getRecordIdx(TypeKey::Union, name, members);
+}
+
+TypeIdx TypeManager::getRecordIdx(TypeKey::Kind kind, const std::string& name, NStructDeclaration* members) {
     TypeKey key;
-    key.kind = TypeKey::Struct;
+    key.kind = kind;
     key.structName = name;
+
+    // Every declarator of a member declaration is its own member, typed by its pointer and array parts
+    std::vector<StructTypeCodegen::MemberInfo> memberInfos;
+    for (NStructDeclaration* cur = members; cur != nullptr; cur = cur->next.get()) {
+        for (NDeclarator* declarator = cur->declarator.get(); declarator != nullptr;
+             declarator = declarator->next.get()) {
+            memberInfos.push_back({declarator->getName(), getDeclaratorType(cur->typeIdx, declarator),
+                                   declarator->alignment, declarator->packed, declarator->bitWidth});
+        }
+    }
+    delete members;  // the member list is consumed here
+
     auto it = cache_.find(key);
     if (it != cache_.end()) {
-        if (members != nullptr) {
-            StructTypeCodegen* existing = static_cast<StructTypeCodegen*>(types_[it->second].get());
-            if (false == existing->hasMembers()) {
-                existing->setMembers(members);
-            }
+        StructTypeCodegen* existing = static_cast<StructTypeCodegen*>(types_[it->second].get());
+        if (false == memberInfos.empty() && false == existing->hasMembers()) {
+            existing->setMembers(std::move(memberInfos));
         }
         return it->second;
     }
-    return registerType(key, std::make_unique<StructTypeCodegen>(name, members));
+    if (TypeKey::Union == kind)
+        return registerType(key, std::make_unique<UnionTypeCodegen>(name, std::move(memberInfos)));
+    return registerType(key, std::make_unique<StructTypeCodegen>(name, std::move(memberInfos)));
+}
+
+void TypeManager::setStructLayoutAttributes(TypeIdx idx, bool packed, uint64_t alignment) {
+    if (idx >= types_.size())
+        return;
+    if (auto* stc = dynamic_cast<StructTypeCodegen*>(types_[idx].get()))
+        stc->setLayoutAttributes(packed, alignment);
+}
+
+TypeIdx TypeManager::getDeclaratorType(TypeIdx baseIdx, const NDeclarator* declarator) {
+    TypeIdx idx = baseIdx;
+    if (true == declarator->isPointer()) {
+        idx = getPointerIdx(idx, declarator->pointerLevel);
+        if (declarator->qualifiers != QUAL_NONE)
+            idx = getQualifiedIdx(idx, declarator->qualifiers);
+    }
+    if (true == declarator->isArray()) {
+        std::vector<int> dimensions;
+        for (const auto& sizeExpr : declarator->getArrayDimensions()) {
+            auto* size = dynamic_cast<NInteger*>(sizeExpr.get());
+            dimensions.push_back(nullptr != size ? static_cast<int>(size->getValue()) : 0);
+        }
+        idx = getArrayIdx(idx, std::move(dimensions));
+    }
+    return idx;
+}
+
+uint64_t TypeManager::getAlignment(TypeIdx idx) {
+    const TypeCodegen* tc = get(idx);
+    if (auto* q = dynamic_cast<const QualifiedTypeCodegen*>(tc))
+        return getAlignment(q->getBaseIdx());
+    if (auto* atc = dynamic_cast<const ArrayTypeCodegen*>(tc))
+        return getAlignment(atc->getElementIdx());
+    llvm::Type* type = realize(idx);
+    if (nullptr == type || type->isVoidTy())
+        return 1;
+    if (auto* stc = dynamic_cast<const StructTypeCodegen*>(tc))
+        return stc->getAlignment();
+    return module.getDataLayout().getABITypeAlign(type).value();
+}
+
+TypeIdx TypeManager::findRecordIdx(llvm::StructType* structType) const {
+    if (nullptr == structType || false == structType->hasName())
+        return InvalidTypeIdx;
+    TypeKey key;
+    key.kind = TypeKey::Struct;
+    key.structName = structType->getName().str();
+    // A '.' cannot appear in a C tag, so the "union." prefix of getLLVMName is unambiguous
+    if (0 == key.structName.rfind("union.", 0)) {
+        key.kind = TypeKey::Union;
+        key.structName = key.structName.substr(6);
+    }
+    auto it = cache_.find(key);
+    return (it != cache_.end()) ? it->second : InvalidTypeIdx;
+}
+
+const StructTypeCodegen* TypeManager::findStruct(llvm::StructType* structType) const {
+    TypeIdx idx = findRecordIdx(structType);
+    return (InvalidTypeIdx != idx) ? dynamic_cast<const StructTypeCodegen*>(get(idx)) : nullptr;
+}
+
+void TypeManager::printStructLayouts(std::ostream& out) {
+    static constexpr uint64_t CacheLineSize = 64;
+    const llvm::DataLayout& dataLayout = module.getDataLayout();
+
+    for (TypeIdx idx = 0; idx < static_cast<TypeIdx>(types_.size()); ++idx) {
+        auto* stc = dynamic_cast<const StructTypeCodegen*>(types_[idx].get());
+        if (nullptr == stc || false == stc->hasMembers())
+            continue;
+        auto* structType = llvm::dyn_cast_or_null<llvm::StructType>(realize(idx));
+        if (nullptr == structType || structType->isOpaque())
+            continue;
+
+        const llvm::StructLayout* layout = dataLayout.getStructLayout(structType);
+        uint64_t size = layout->getSizeInBytes();
+        out << (stc->isUnion() ? "union " : "struct ") << (stc->getName().empty() ? "<anonymous>" : stc->getName())
+            << ": size " << size
+            << ", align " << stc->getAlignment() << (stc->isPacked() ? ", packed" : "") << ", "
+            << (size + CacheLineSize - 1) / CacheLineSize << " cache line(s)\n";
+        out << "  offset  size  member\n";
+
+        uint64_t end = 0;
+        uint64_t padding = 0;
+        auto printHole = [&](uint64_t from, uint64_t to) {
+            out << "  " << std::setw(6) << from << "  " << std::setw(4) << to - from << "  <padding>\n";
+            padding += to - from;
+        };
+        for (size_t i = 0; i < stc->getMemberCount(); ++i) {
+            const StructTypeCodegen::MemberInfo& member = stc->getMember(static_cast<int>(i));
+            unsigned element = stc->getElementIndex(static_cast<int>(i));
+            if (StructTypeCodegen::NoElement == element)
+                continue;
+            llvm::Type* memberType = realize(member.typeIdx);
+            uint64_t offset = layout->getElementOffset(element);
+            uint64_t memberSize = dataLayout.getTypeAllocSize(memberType);
+            // A bit-field is listed from the byte holding its lowest bit, with the bytes its bits touch
+            const BitFieldSlot& slot = stc->getBitFieldStorage(static_cast<int>(i)).slot;
+            if (true == stc->isBitField(static_cast<int>(i))) {
+                offset += stc->getBitFieldStorage(static_cast<int>(i)).byteOffset;
+                memberSize = llvm::divideCeil(slot.shift + slot.width, 8);
+            }
+            if (offset > end)
+                printHole(end, offset);
+            if (offset > 0 && offset / CacheLineSize != (offset - 1) / CacheLineSize && offset >= end)
+                out << "  ---- cache line " << offset / CacheLineSize << " ----\n";
+            out << "  " << std::setw(6) << offset << "  " << std::setw(4) << memberSize << "  "
+                << (member.name.empty() ? "<unnamed>" : member.name);
+            if (true == stc->isBitField(static_cast<int>(i)))
+                out << ":" << slot.width << " (" << getTypeName(memberType) << ", bits " << slot.shift << "-"
+                    << slot.shift + slot.width - 1 << ")";
+            else
+                out << " (" << getTypeName(memberType) << ")";
+            if (memberSize > 0 && offset / CacheLineSize != (offset + memberSize - 1) / CacheLineSize)
+                out << "  [crosses a cache line]";
+            out << "\n";
+            end = std::max(end, offset + memberSize);
+        }
+        if (size > end)
+            printHole(end, size);
+        out << "  total padding: " << padding << " byte(s)\n";
+    }
 }
 
 bool TypeManager::isConstQualified(TypeIdx idx) const {
@@ -204,6 +543,18 @@ bool TypeManager::isVolatileQualified(TypeIdx idx) const {
     return false;
 }
 
+bool TypeManager::isRestrictQualified(TypeIdx idx) const {
+    if (auto* q = dynamic_cast<const QualifiedTypeCodegen*>(get(idx)))
+        return q->isRestrict();
+    return false;
+}
+
+bool TypeManager::isAtomicQualified(TypeIdx idx) const {
+    if (auto* q = dynamic_cast<const QualifiedTypeCodegen*>(get(idx)))
+        return q->isAtomic();
+    return false;
+}
+
 TypeIdx TypeManager::unqualify(TypeIdx idx) const {
     if (auto* q = dynamic_cast<const QualifiedTypeCodegen*>(get(idx)))
         return q->getBaseIdx();
@@ -219,6 +570,58 @@ bool TypeManager::isFloatingPointType(TypeIdx idx) const {
     return false;
 }
 
+bool TypeManager::isUnsignedType(TypeIdx idx) const {
+    if (auto* ptc = dynamic_cast<const PrimitiveTypeCodegen*>(get(unqualify(idx)))) {
+        VarType vt = ptc->getVarType();
+        return vt == VAR_TYPE_BOOL || vt == VAR_TYPE_UCHAR || vt == VAR_TYPE_USHORT || vt == VAR_TYPE_UINT ||
+               vt == VAR_TYPE_ULONG;
+    }
+    return false;
+}
+
+bool TypeManager::isSignedIntegerType(TypeIdx idx) const {
+    if (auto* ptc = dynamic_cast<const PrimitiveTypeCodegen*>(get(unqualify(idx)))) {
+        VarType vt = ptc->getVarType();
+        return vt == VAR_TYPE_CHAR || vt == VAR_TYPE_SHORT || vt == VAR_TYPE_INT || vt == VAR_TYPE_LONG;
+    }
+    return false;
+}
+
+bool TypeManager::isIntegerType(TypeIdx idx) const {
+    return isUnsignedType(idx) || isSignedIntegerType(idx);
+}
+
+bool TypeManager::isVectorType(TypeIdx idx) const {
+    return nullptr != dynamic_cast<const VectorTypeCodegen*>(get(unqualify(idx)));
+}
+
+bool TypeManager::isRecordType(TypeIdx idx) const {
+    return nullptr != dynamic_cast<const StructTypeCodegen*>(get(unqualify(idx)));
+}
+
+TypeIdx TypeManager::getScalarTypeIdx(TypeIdx idx) const {
+    if (auto* vtc = dynamic_cast<const VectorTypeCodegen*>(get(unqualify(idx))))
+        return vtc->getElementIdx();
+    return unqualify(idx);
+}
+
+TypeIdx TypeManager::promoteInteger(TypeIdx idx) {
+    if (auto* ptc = dynamic_cast<const PrimitiveTypeCodegen*>(get(unqualify(idx)))) {
+        switch (ptc->getVarType()) {
+            // Every value of these fits in int, so they all promote to (signed) int
+            case VAR_TYPE_BOOL:
+            case VAR_TYPE_CHAR:
+            case VAR_TYPE_UCHAR:
+            case VAR_TYPE_SHORT:
+            case VAR_TYPE_USHORT:
+                return getPrimitiveIdx(VAR_TYPE_INT);
+            default:
+                return unqualify(idx);
+        }
+    }
+    return idx;
+}
+
 ExprCodegenResult TypeManager::typeCast(llvm::Value* value, TypeIdx fromTypeIdx, TypeIdx toTypeIdx,
                                         llvm::IRBuilder<>& builder) {
     llvm::Type* fromType = realize(fromTypeIdx);
@@ -263,21 +666,27 @@ ExprCodegenResult TypeManager::typeCast(llvm::Value* value, TypeIdx fromTypeIdx,
         return ExprCodegenResult(result, toTypeIdx);
     }
 
-    // Int to Int
+    // Int to Int: widening follows the signedness of the source
     if (fromIsInt && toIsInt) {
-        result = builder.CreateIntCast(value, toType, true, "int_cast");
+        result = builder.CreateIntCast(value, toType, false == isUnsignedType(fromTypeIdx), "int_cast");
         return ExprCodegenResult(result, toTypeIdx);
     }
 
     // Float to Int
     if (fromIsFloat && toIsInt) {
-        result = builder.CreateFPToSI(value, toType, "float_to_int");
+        if (true == isUnsignedType(toTypeIdx))
+            result = builder.CreateFPToUI(value, toType, "float_to_int");
+        else
+            result = builder.CreateFPToSI(value, toType, "float_to_int");
         return ExprCodegenResult(result, toTypeIdx);
     }
 
     // Int to Float
     if (fromIsInt && toIsFloat) {
-        result = builder.CreateSIToFP(value, toType, "int_to_float");
+        if (true == isUnsignedType(fromTypeIdx))
+            result = builder.CreateUIToFP(value, toType, "int_to_float");
+        else
+            result = builder.CreateSIToFP(value, toType, "int_to_float");
         return ExprCodegenResult(result, toTypeIdx);
     }
 
@@ -287,6 +696,16 @@ ExprCodegenResult TypeManager::typeCast(llvm::Value* value, TypeIdx fromTypeIdx,
         return ExprCodegenResult(result, toTypeIdx);
     }
 
+    // Vector to Vector of the same size reinterprets the bits, as GCC does
+    if (fromType->isVectorTy() && toType->isVectorTy()) {
+        llvm::DataLayout dataLayout(&module);
+        if (dataLayout.getTypeSizeInBits(fromType) != dataLayout.getTypeSizeInBits(toType)) {
+            return ExprCodegenResult("Cannot convert between vector types of different sizes");
+        }
+        result = builder.CreateBitCast(value, toType, "vector_cast");
+        return ExprCodegenResult(result, toTypeIdx);
+    }
+
     // Pointer casts
     if (fromType->isPointerTy() && toType->isPointerTy()) {
         result = builder.CreateBitCast(value, toType, "ptr_cast");
@@ -320,9 +739,173 @@ llvm::Type* TypeManager::realize(TypeIdx idx) {
     return types_[idx]->getLLVMType(*this, context, module);
 }
 
+// ==================== Calling convention ====================
+
+namespace {
+
+enum class EightbyteClass { None, Integer, Sse, SseUp };
+
+// Classification of the (at most two) eightbytes of a record passed by value
+struct Eightbytes {
+    EightbyteClass classes[2] = {EightbyteClass::None, EightbyteClass::None};
+    bool holdsDouble[2] = {false, false};  // an 8-byte SSE scalar fills the eightbyte
+    bool upperHalf[2] = {false, false};    // something lives in bytes 4-7 of the eightbyte
+    llvm::Type* wideVector = nullptr;      // a 16-byte vector filling both eightbytes, passed in one XMM register
+};
+
+// Integer wins over SSE when both meet in one eightbyte
+void markBytes(Eightbytes& eightbytes, uint64_t offset, uint64_t size, EightbyteClass cls) {
+    for (uint64_t i = offset / 8; i <= (offset + size - 1) / 8; i++) {
+        EightbyteClass& merged = eightbytes.classes[i];
+        merged = (EightbyteClass::None == merged || EightbyteClass::Integer == cls) ? cls : merged;
+        merged = (EightbyteClass::SseUp == merged && EightbyteClass::Sse == cls) ? cls : merged;
+        eightbytes.upperHalf[i] = eightbytes.upperHalf[i] || offset + size > 8 * i + 4;
+    }
+}
+
+// Walks the scalars of idx placed at offset; false if one is misaligned, which sends the record to memory
+bool classifyEightbytes(TypeManager& tm, const llvm::DataLayout& layout, TypeIdx idx, uint64_t offset,
+                        Eightbytes& eightbytes) {
+    idx = tm.unqualify(idx);
+    const TypeCodegen* tc = tm.get(idx);
+    llvm::Type* type = tm.realize(idx);
+    if (0 != offset % tm.getAlignment(idx))
+        return false;
+
+    if (auto* stc = dynamic_cast<const StructTypeCodegen*>(tc)) {
+        const llvm::StructLayout* structLayout = layout.getStructLayout(llvm::cast<llvm::StructType>(type));
+        for (size_t i = 0; i < stc->getMemberCount(); i++) {
+            unsigned element = stc->getElementIndex(static_cast<int>(i));
+            if (StructTypeCodegen::NoElement == element)
+                continue;
+            uint64_t memberOffset = offset + structLayout->getElementOffset(element);
+            if (stc->isBitField(static_cast<int>(i))) {
+                const StructTypeCodegen::BitFieldStorage& storage = stc->getBitFieldStorage(static_cast<int>(i));
+                if (false == stc->getMember(static_cast<int>(i)).name.empty())
+                    markBytes(eightbytes, memberOffset + storage.byteOffset, storage.slot.storageBits / 8,
+                              EightbyteClass::Integer);
+                continue;
+            }
+            if (false == classifyEightbytes(tm, layout, stc->getMemberTypeIdx(static_cast<int>(i)), memberOffset,
+                                            eightbytes))
+                return false;
+        }
+        return true;
+    }
+    if (auto* atc = dynamic_cast<const ArrayTypeCodegen*>(tc)) {
+        uint64_t elementSize = layout.getTypeAllocSize(tm.realize(atc->getElementIdx()));
+        for (int i = 0; i < atc->getSize(); i++) {
+            if (false == classifyEightbytes(tm, layout, atc->getElementIdx(), offset + i * elementSize, eightbytes))
+                return false;
+        }
+        return true;
+    }
+
+    uint64_t size = layout.getTypeAllocSize(type);
+    if (type->isVectorTy() && 16 == size) {
+        eightbytes.wideVector = type;
+        markBytes(eightbytes, offset, 8, EightbyteClass::Sse);
+        markBytes(eightbytes, offset + 8, 8, EightbyteClass::SseUp);
+        return true;
+    }
+    bool isSse = type->isFloatingPointTy() || type->isVectorTy();
+    markBytes(eightbytes, offset, size, isSse ? EightbyteClass::Sse : EightbyteClass::Integer);
+    eightbytes.holdsDouble[offset / 8] = eightbytes.holdsDouble[offset / 8] || type->isDoubleTy();
+    return true;
+}
+
+ArgumentPassing classifyRecord(TypeManager& tm, const llvm::DataLayout& layout, TypeIdx idx) {
+    ArgumentPassing passing;
+    llvm::Type* type = tm.realize(idx);
+    uint64_t size = layout.getTypeAllocSize(type);
+    Eightbytes eightbytes;
+    if (0 == size) {
+        passing.kind = ArgumentPassing::Ignored;
+        return passing;
+    }
+    if (size > 16 || false == classifyEightbytes(tm, layout, idx, 0, eightbytes)) {
+        passing.kind = ArgumentPassing::Indirect;
+        return passing;
+    }
+
+    passing.kind = ArgumentPassing::Coerced;
+    // A union of a 16-byte vector and anything else falls back to two eightbytes
+    if (EightbyteClass::Sse == eightbytes.classes[0] && EightbyteClass::SseUp == eightbytes.classes[1]) {
+        passing.pieces.push_back(eightbytes.wideVector);
+        return passing;
+    }
+    llvm::LLVMContext& context = type->getContext();
+    for (uint64_t i = 0; i < llvm::divideCeil(size, 8); i++) {
+        // Trailing padding (left by aligned(N)) needs no register
+        if (i > 0 && EightbyteClass::None == eightbytes.classes[i])
+            continue;
+        uint64_t bytes = std::min<uint64_t>(8, size - 8 * i);
+        llvm::Type* piece = llvm::Type::getIntNTy(context, static_cast<unsigned>(8 * bytes));
+        if (EightbyteClass::Sse == eightbytes.classes[i] || EightbyteClass::SseUp == eightbytes.classes[i]) {
+            if (eightbytes.holdsDouble[i])
+                piece = llvm::Type::getDoubleTy(context);
+            else if (eightbytes.upperHalf[i])
+                piece = llvm::FixedVectorType::get(llvm::Type::getFloatTy(context), 2);
+            else
+                piece = llvm::Type::getFloatTy(context);
+        }
+        passing.pieces.push_back(piece);
+    }
+    return passing;
+}
+
+}  // namespace
+
+ArgumentPassing TypeManager::classifyArgument(TypeIdx idx, ArgumentRegisters& registers) {
+    if (false == isRecordType(idx)) {
+        // LLVM places scalars itself; they only use up registers
+        llvm::Type* type = realize(idx);
+        bool isSse = nullptr != type && (type->isFloatingPointTy() || type->isVectorTy());
+        unsigned& available = isSse ? registers.sse : registers.integer;
+        available -= (available > 0) ? 1 : 0;
+        return ArgumentPassing();
+    }
+
+    ArgumentPassing passing = classifyRecord(*this, module.getDataLayout(), unqualify(idx));
+    if (ArgumentPassing::Coerced == passing.kind) {
+        unsigned integer = static_cast<unsigned>(std::count_if(
+            passing.pieces.begin(), passing.pieces.end(), [](llvm::Type* piece) { return piece->isIntegerTy(); }));
+        unsigned sse = static_cast<unsigned>(passing.pieces.size()) - integer;
+        if (integer > registers.integer || sse > registers.sse) {
+            passing.kind = ArgumentPassing::Indirect;
+            passing.pieces.clear();
+        } else {
+            registers.integer -= integer;
+            registers.sse -= sse;
+        }
+    }
+    return passing;
+}
+
+ArgumentPassing TypeManager::classifyReturn(TypeIdx idx) {
+    // rax/rdx and xmm0/xmm1 always have room for both eightbytes
+    if (false == isRecordType(idx))
+        return ArgumentPassing();
+    return classifyRecord(*this, module.getDataLayout(), unqualify(idx));
+}
+
 // ==================== LLVM-level helpers ====================
 
 TypeIdx TypeManager::getCommonTypeIdx(TypeIdx a, TypeIdx b) {
+    // Usual arithmetic conversions for two integer operands: promote, then prefer the wider type and, at
+    // equal width, the unsigned one. A wider signed type holds every value of a narrower unsigned one.
+    if (isIntegerType(a) && isIntegerType(b)) {
+        TypeIdx pa = promoteInteger(a);
+        TypeIdx pb = promoteInteger(b);
+        if (pa == pb)
+            return pa;
+        unsigned widthA = realize(pa)->getIntegerBitWidth();
+        unsigned widthB = realize(pb)->getIntegerBitWidth();
+        if (widthA != widthB)
+            return widthA > widthB ? pa : pb;
+        return isUnsignedType(pa) ? pa : pb;
+    }
+
     if (a == b)
         return a;
     llvm::Type* ta = realize(a);
@@ -361,6 +944,10 @@ std::string TypeManager::getTypeName(llvm::Type* type) const {
         auto* arrayType = llvm::cast<llvm::ArrayType>(type);
         return "array[" + std::to_string(arrayType->getNumElements()) + "]";
     }
+    if (auto* vectorType = llvm::dyn_cast<llvm::FixedVectorType>(type)) {
+        return "vector<" + std::to_string(vectorType->getNumElements()) + " x " +
+               getTypeName(vectorType->getElementType()) + ">";
+    }
     if (auto* structType = llvm::dyn_cast<llvm::StructType>(type)) {
         std::string name;
         if (structType->hasName()) {
@@ -398,3 +985,126 @@ llvm::Type* TypeManager::getCommonType(llvm::Type* type1, llvm::Type* type2) {
     };
     return (getIntegerRank(type1) >= getIntegerRank(type2)) ? type1 : type2;
 }
+
+// ==================== TBAA ====================
+
+llvm::MDNode* TypeManager::getTBAATypeNode(TypeIdx idx) {
+    idx = unqualify(idx);
+    auto cached = tbaaTypeNodes_.find(idx);
+    if (cached != tbaaTypeNodes_.end())
+        return cached->second;
+
+    llvm::MDBuilder mdBuilder(context);
+    if (nullptr == tbaaRoot_)
+        tbaaRoot_ = mdBuilder.createTBAARoot("Simple C/C++ TBAA");
+
+    // Character types may alias anything, so every other scalar hangs below them. Signed and unsigned
+    // variants of a type may alias each other and share one node.
+    llvm::MDNode* node = nullptr;
+    const TypeCodegen* tc = get(idx);
+    if (auto* ptc = dynamic_cast<const PrimitiveTypeCodegen*>(tc)) {
+        const char* name = nullptr;
+        switch (ptc->getVarType()) {
+            case VAR_TYPE_CHAR:
+            case VAR_TYPE_UCHAR:
+                node = mdBuilder.createTBAAScalarTypeNode("omnipotent char", tbaaRoot_);
+                break;
+            case VAR_TYPE_BOOL:
+                name = "_Bool";
+                break;
+            case VAR_TYPE_SHORT:
+            case VAR_TYPE_USHORT:
+                name = "short";
+                break;
+            case VAR_TYPE_INT:
+            case VAR_TYPE_UINT:
+                name = "int";
+                break;
+            case VAR_TYPE_LONG:
+            case VAR_TYPE_ULONG:
+                name = "long";
+                break;
+            case VAR_TYPE_FLOAT:
+                name = "float";
+                break;
+            case VAR_TYPE_DOUBLE:
+                name = "double";
+                break;
+            default:
+                break;
+        }
+        if (nullptr != name)
+            node = mdBuilder.createTBAAScalarTypeNode(name, getTBAATypeNode(getPrimitiveIdx(VAR_TYPE_CHAR)));
+    } else if (dynamic_cast<const PointerTypeCodegen*>(tc)) {
+        node = mdBuilder.createTBAAScalarTypeNode("any pointer", getTBAATypeNode(getPrimitiveIdx(VAR_TYPE_CHAR)));
+    } else if (auto* atc = dynamic_cast<const ArrayTypeCodegen*>(tc)) {
+        node = getTBAATypeNode(atc->getElementIdx());
+    } else if (dynamic_cast<const VectorTypeCodegen*>(tc)) {
+        // Whole-vector accesses may overlap lane accesses of the element type, so vectors alias like char
+        node = getTBAATypeNode(getPrimitiveIdx(VAR_TYPE_CHAR));
+    } else if (auto* stc = dynamic_cast<const StructTypeCodegen*>(tc); nullptr != stc && true == stc->isUnion()) {
+        // Members of a union overlap, so the union as a whole aliases like char
+        node = getTBAATypeNode(getPrimitiveIdx(VAR_TYPE_CHAR));
+    } else if (nullptr != stc) {
+        auto* structType = llvm::dyn_cast_or_null<llvm::StructType>(realize(idx));
+        if (nullptr != structType && false == structType->isOpaque()) {
+            llvm::DataLayout dataLayout(&module);
+            const llvm::StructLayout* layout = dataLayout.getStructLayout(structType);
+            std::vector<std::pair<llvm::MDNode*, uint64_t>> fields;
+            for (size_t i = 0; i < stc->getMemberCount(); ++i) {
+                // Bit-fields are accessed through char-typed storage units and get no field of their own
+                if (true == stc->isBitField(static_cast<int>(i)))
+                    continue;
+                llvm::MDNode* fieldNode = getTBAATypeNode(stc->getMemberTypeIdx(static_cast<int>(i)));
+                if (nullptr == fieldNode) {
+                    fields.clear();
+                    break;
+                }
+                fields.emplace_back(fieldNode, layout->getElementOffset(stc->getElementIndex(static_cast<int>(i))));
+            }
+            if (false == fields.empty())
+                node = mdBuilder.createTBAAStructTypeNode(stc->getName(), fields);
+        }
+    }
+
+    tbaaTypeNodes_[idx] = node;
+    return node;
+}
+
+llvm::MDNode* TypeManager::getTBAAAccessTag(TypeIdx accessIdx, llvm::Value* address) {
+    const TypeCodegen* tc = get(unqualify(accessIdx));
+    if (nullptr == tc || dynamic_cast<const StructTypeCodegen*>(tc) || dynamic_cast<const ArrayTypeCodegen*>(tc))
+        return nullptr;
+    llvm::MDNode* accessNode = getTBAATypeNode(accessIdx);
+    if (nullptr == accessNode)
+        return nullptr;
+
+    llvm::MDBuilder mdBuilder(context);
+
+    // A direct `object.field` address keeps the enclosing struct as the base of the access path
+    auto* gep = llvm::dyn_cast<llvm::GEPOperator>(address);
+    auto* structType = gep ? llvm::dyn_cast<llvm::StructType>(gep->getSourceElementType()) : nullptr;
+    if (nullptr != structType && structType->hasName() && 3 == gep->getNumOperands()) {
+        auto* first = llvm::dyn_cast<llvm::ConstantInt>(gep->getOperand(1));
+        auto* field = llvm::dyn_cast<llvm::ConstantInt>(gep->getOperand(2));
+        TypeIdx recordIdx = findRecordIdx(structType);
+        auto* stc = dynamic_cast<const StructTypeCodegen*>(get(recordIdx));
+        // Reading a union through any of its members is allowed to reinterpret what another member stored
+        if (nullptr != stc && true == stc->isUnion()) {
+            llvm::MDNode* charNode = getTBAATypeNode(getPrimitiveIdx(VAR_TYPE_CHAR));
+            return mdBuilder.createTBAAStructTagNode(charNode, charNode, 0);
+        }
+        if (nullptr != first && true == first->isZero() && nullptr != field && nullptr != stc) {
+            int memberIndex = stc->getMemberIndexForElement(static_cast<unsigned>(field->getZExtValue()));
+            llvm::MDNode* baseNode = getTBAATypeNode(recordIdx);
+            if (nullptr != baseNode && -1 != memberIndex &&
+                accessNode == getTBAATypeNode(stc->getMemberTypeIdx(memberIndex))) {
+                llvm::DataLayout dataLayout(&module);
+                uint64_t offset = dataLayout.getStructLayout(structType)->getElementOffset(field->getZExtValue());
+                return mdBuilder.createTBAAStructTagNode(baseNode, accessNode, offset);
+            }
+        }
+    }
+    return mdBuilder.createTBAAStructTagNode(accessNode, accessNode, 0);
+}
+
@@ -39,6 +39,11 @@ toyc::semantic::ParserActions *parser_actions = nullptr;
 	toyc::ast::NStructDeclaration *struct_declaration;
 	toyc::ast::NInitializerList *initializer_list;
 	toyc::ast::BineryOperator bop;
+	toyc::ast::GnuAttributeList *attributes;
+	toyc::ast::GnuAttribute *attribute;
+	toyc::ast::LoopHints *loop_hints;
+	std::vector<toyc::ast::AsmOperand> *asm_operands;
+	std::vector<std::string> *strings;
 	std::string *string;
 	int token;
 	int integer;
@@ -46,7 +51,7 @@ toyc::semantic::ParserActions *parser_actions = nullptr;
 
 %define parse.error verbose
 
-%token	<string> IDENTIFIER I_CONSTANT F_CONSTANT C_CONSTANT STRING_LITERAL TYPEDEF_NAME
+%token	<string> IDENTIFIER I_CONSTANT F_CONSTANT C_CONSTANT STRING_LITERAL TYPEDEF_NAME PRAGMA
 %token	INC_OP DEC_OP LEFT_OP RIGHT_OP LE_OP GE_OP EQ_OP NE_OP PTR_OP AND_OP OR_OP
 %token	MUL_ASSIGN DIV_ASSIGN MOD_ASSIGN ADD_ASSIGN
 %token	SUB_ASSIGN LEFT_ASSIGN RIGHT_ASSIGN AND_ASSIGN
@@ -54,8 +59,8 @@ toyc::semantic::ParserActions *parser_actions = nullptr;
 
 %token	TYPEDEF SIZEOF
 %token	BOOL CHAR SHORT INT LONG FLOAT DOUBLE VOID
-%token	SIGNED UNSIGNED CONST VOLATILE STATIC
-%token	STRUCT UNION ENUM ELLIPSIS
+%token	SIGNED UNSIGNED CONST VOLATILE RESTRICT ATOMIC STATIC EXTERN INLINE THREAD_LOCAL
+%token	STRUCT UNION ENUM ELLIPSIS ATTRIBUTE ASM
 
 %token	CASE DEFAULT IF ELSE SWITCH WHILE DO FOR GOTO CONTINUE BREAK RETURN
 
@@ -66,7 +71,7 @@ toyc::semantic::ParserActions *parser_actions = nullptr;
 %type   <type_specifier> type_specifier struct_specifier type_name
 %type   <struct_declaration> struct_declaration struct_declaration_list
 %type	<bop> relational_expression_op
-%type   <declarator> init_declarator init_declarator_list struct_declarator_list declarator direct_declarator
+%type   <declarator> init_declarator init_declarator_list struct_declarator_list struct_declarator declarator direct_declarator
 %type   <parameter> parameter_list parameter_declaration
 %type   <declaration_specifiers> declaration_specifiers
 %type   <statement> statement statement_list expression_statement jump_statement for_statement_init_declaration
@@ -74,7 +79,17 @@ toyc::semantic::ParserActions *parser_actions = nullptr;
 %type   <block> compound_statement
 %type   <external_declaration> program external_declaration external_declaration_list function_definition
 %type   <arguments> argument_expression_list
-%type   <integer> pointer_qualifier
+%type   <integer> pointer_qualifier pointer_type_qualifier_list pointer_type_qualifier struct_or_union
+%type   <external_declaration> attributed_function_definition
+%type   <attributes> attribute_specifiers attribute_specifier attribute_list
+%type   <attribute> attribute
+%type   <strings> attribute_argument_list
+%type   <string> attribute_argument
+%type   <loop_hints> loop_pragmas
+%type   <statement> loop_statement asm_statement
+%type   <integer> asm_qualifiers
+%type   <asm_operands> asm_operands asm_operand_list
+%type   <strings> asm_clobbers asm_clobber_list
 
 %start program
 %%
@@ -98,11 +113,38 @@ external_declaration
 	: function_definition {
 		$$ = $1;
 	}
+	| STATIC attributed_function_definition {
+		$$ = parser_actions->handleFunctionSpecifiers($2, toyc::ast::STORAGE_STATIC, false);
+	}
+	| EXTERN attributed_function_definition {
+		$$ = parser_actions->handleFunctionSpecifiers($2, toyc::ast::STORAGE_EXTERN, false);
+	}
+	| INLINE attributed_function_definition {
+		$$ = parser_actions->handleFunctionSpecifiers($2, toyc::ast::STORAGE_NONE, true);
+	}
+	| STATIC INLINE attributed_function_definition {
+		$$ = parser_actions->handleFunctionSpecifiers($3, toyc::ast::STORAGE_STATIC, true);
+	}
+	| INLINE STATIC attributed_function_definition {
+		$$ = parser_actions->handleFunctionSpecifiers($3, toyc::ast::STORAGE_STATIC, true);
+	}
+	| attribute_specifier external_declaration {
+		$$ = parser_actions->handleDeclarationAttributes($2, $1);
+	}
 	| declaration_specifiers {
 		$$ = $1;
 	}
 	;
 
+attributed_function_definition
+	: function_definition {
+		$$ = $1;
+	}
+	| attribute_specifier attributed_function_definition {
+		$$ = parser_actions->handleDeclarationAttributes($2, $1);
+	}
+	;
+
 function_definition
 	:  type_specifier IDENTIFIER '(' parameter_list ')' compound_statement {
 		$$ = parser_actions->handleFunctionDefinition($1, *$2, $4, $6, @$.first_line, @$.first_column);
@@ -116,6 +158,11 @@ function_definition
 		$$ = parser_actions->handleFunctionDeclaration($1, *$2, $4, @$.first_line, @$.first_column);
 		delete $2;
 	}
+	|  type_specifier IDENTIFIER '(' parameter_list ')' attribute_specifiers ';' {
+		$$ = parser_actions->handleDeclarationAttributes(
+			parser_actions->handleFunctionDeclaration($1, *$2, $4, @$.first_line, @$.first_column), $6);
+		delete $2;
+	}
 	|  type_specifier IDENTIFIER '(' VOID ')' compound_statement {
 		$$ = parser_actions->handleFunctionDefinition($1, *$2, nullptr, $6, @$.first_line, @$.first_column);
 		delete $2;
@@ -124,10 +171,85 @@ function_definition
 		$$ = parser_actions->handleFunctionDeclaration($1, *$2, nullptr, @$.first_line, @$.first_column);
 		delete $2;
 	}
+	|  type_specifier IDENTIFIER '(' VOID ')' attribute_specifiers ';' {
+		$$ = parser_actions->handleDeclarationAttributes(
+			parser_actions->handleFunctionDeclaration($1, *$2, nullptr, @$.first_line, @$.first_column), $6);
+		delete $2;
+	}
 	|  type_specifier IDENTIFIER '(' ')' ';' {
 		$$ = parser_actions->handleFunctionDeclaration($1, *$2, nullptr, @$.first_line, @$.first_column);
 		delete $2;
 	}
+	|  type_specifier IDENTIFIER '(' ')' attribute_specifiers ';' {
+		$$ = parser_actions->handleDeclarationAttributes(
+			parser_actions->handleFunctionDeclaration($1, *$2, nullptr, @$.first_line, @$.first_column), $5);
+		delete $2;
+	}
+	;
+
+attribute_specifiers
+	: attribute_specifier {
+		$$ = $1;
+	}
+	| attribute_specifiers attribute_specifier {
+		$$ = parser_actions->handleAttributeSpecifiers($1, $2);
+	}
+	;
+
+attribute_specifier
+	: ATTRIBUTE '(' '(' attribute_list ')' ')' {
+		$$ = $4;
+	}
+	;
+
+attribute_list
+	: attribute {
+		$$ = parser_actions->handleAttributeList(nullptr, $1);
+	}
+	| attribute_list ',' attribute {
+		$$ = parser_actions->handleAttributeList($1, $3);
+	}
+	;
+
+attribute
+	: %empty {
+		$$ = nullptr;
+	}
+	| IDENTIFIER {
+		$$ = parser_actions->handleAttribute(*$1, nullptr);
+		delete $1;
+	}
+	| CONST {
+		$$ = parser_actions->handleAttribute("const", nullptr);
+	}
+	| IDENTIFIER '(' attribute_argument_list ')' {
+		$$ = parser_actions->handleAttribute(*$1, $3);
+		delete $1;
+	}
+	;
+
+attribute_argument_list
+	: attribute_argument {
+		$$ = new std::vector<std::string>{*$1};
+		delete $1;
+	}
+	| attribute_argument_list ',' attribute_argument {
+		$$ = $1;
+		$$->push_back(*$3);
+		delete $3;
+	}
+	;
+
+attribute_argument
+	: I_CONSTANT {
+		$$ = $1;
+	}
+	| STRING_LITERAL {
+		$$ = $1;
+	}
+	| IDENTIFIER {
+		$$ = $1;
+	}
 	;
 
 parameter_list
@@ -157,6 +279,29 @@ compound_statement
 	}
 	;
 
+loop_pragmas
+	: PRAGMA {
+		$$ = parser_actions->handleLoopPragma(nullptr, *$1);
+		delete $1;
+	}
+	| loop_pragmas PRAGMA {
+		$$ = parser_actions->handleLoopPragma($1, *$2);
+		delete $2;
+	}
+	;
+
+loop_statement
+	: for_statement {
+		$$ = $1;
+	}
+	| while_statement {
+		$$ = $1;
+	}
+	| do_while_statement {
+		$$ = $1;
+	}
+	;
+
 statement_list
 	: statement statement_list {
 		$$ = parser_actions->handleStatementList($1, $2);
@@ -194,9 +339,15 @@ statement
 	| do_while_statement {
 		$$ = $1;
 	}
+	| loop_pragmas loop_statement {
+		$$ = parser_actions->handleLoopHints($1, $2);
+	}
 	| switch_statement {
 		$$ = $1;
 	}
+	| asm_statement {
+		$$ = $1;
+	}
 	;
 
 for_statement_init_declaration
@@ -240,6 +391,9 @@ labeled_statement
 	| CASE expression ':' {
 		$$ = parser_actions->handleCaseStatement($2);
 	}
+	| CASE expression ELLIPSIS expression ':' {
+		$$ = parser_actions->handleCaseStatement($2, $4);
+	}
 	| DEFAULT ':' {
 		$$ = parser_actions->handleDefaultStatement();
 	}
@@ -264,13 +418,119 @@ jump_statement
 	}
 	;
 
+asm_statement
+	: ASM asm_qualifiers '(' STRING_LITERAL ')' ';' {
+		$$ = parser_actions->handleAsmStatement($2, *$4, nullptr, nullptr, nullptr);
+		delete $4;
+	}
+	| ASM asm_qualifiers '(' STRING_LITERAL ':' asm_operands ')' ';' {
+		$$ = parser_actions->handleAsmStatement($2, *$4, $6, nullptr, nullptr);
+		delete $4;
+	}
+	| ASM asm_qualifiers '(' STRING_LITERAL ':' asm_operands ':' asm_operands ')' ';' {
+		$$ = parser_actions->handleAsmStatement($2, *$4, $6, $8, nullptr);
+		delete $4;
+	}
+	| ASM asm_qualifiers '(' STRING_LITERAL ':' asm_operands ':' asm_operands ':' asm_clobbers ')' ';' {
+		$$ = parser_actions->handleAsmStatement($2, *$4, $6, $8, $10);
+		delete $4;
+	}
+	;
+
+asm_qualifiers
+	: %empty {
+		$$ = 0;
+	}
+	| asm_qualifiers VOLATILE {
+		$$ = 1;
+	}
+	| asm_qualifiers INLINE {
+		$$ = $1;
+	}
+	;
+
+asm_operands
+	: %empty {
+		$$ = nullptr;
+	}
+	| asm_operand_list {
+		$$ = $1;
+	}
+	;
+
+asm_operand_list
+	: STRING_LITERAL '(' expression ')' {
+		$$ = parser_actions->handleAsmOperand(nullptr, "", *$1, $3);
+		delete $1;
+	}
+	| '[' IDENTIFIER ']' STRING_LITERAL '(' expression ')' {
+		$$ = parser_actions->handleAsmOperand(nullptr, *$2, *$4, $6);
+		delete $2;
+		delete $4;
+	}
+	| asm_operand_list ',' STRING_LITERAL '(' expression ')' {
+		$$ = parser_actions->handleAsmOperand($1, "", *$3, $5);
+		delete $3;
+	}
+	| asm_operand_list ',' '[' IDENTIFIER ']' STRING_LITERAL '(' expression ')' {
+		$$ = parser_actions->handleAsmOperand($1, *$4, *$6, $8);
+		delete $4;
+		delete $6;
+	}
+	;
+
+asm_clobbers
+	: %empty {
+		$$ = nullptr;
+	}
+	| asm_clobber_list {
+		$$ = $1;
+	}
+	;
+
+asm_clobber_list
+	: STRING_LITERAL {
+		$$ = new std::vector<std::string>{*$1};
+		delete $1;
+	}
+	| asm_clobber_list ',' STRING_LITERAL {
+		$$ = $1;
+		$$->push_back(*$3);
+		delete $3;
+	}
+	;
+
 declaration_specifiers
 	:  type_specifier init_declarator_list ';' {
 		$$ = parser_actions->handleDeclarationStatement($1, $2);
 	}
+	| STATIC type_specifier init_declarator_list ';' {
+		$$ = parser_actions->handleDeclarationStatement($2, $3, toyc::ast::STORAGE_STATIC);
+	}
+	| EXTERN type_specifier init_declarator_list ';' {
+		$$ = parser_actions->handleDeclarationStatement($2, $3, toyc::ast::STORAGE_EXTERN);
+	}
+	| THREAD_LOCAL type_specifier init_declarator_list ';' {
+		$$ = parser_actions->handleDeclarationStatement($2, $3, toyc::ast::STORAGE_NONE, true);
+	}
+	| STATIC THREAD_LOCAL type_specifier init_declarator_list ';' {
+		$$ = parser_actions->handleDeclarationStatement($3, $4, toyc::ast::STORAGE_STATIC, true);
+	}
+	| THREAD_LOCAL STATIC type_specifier init_declarator_list ';' {
+		$$ = parser_actions->handleDeclarationStatement($3, $4, toyc::ast::STORAGE_STATIC, true);
+	}
+	| EXTERN THREAD_LOCAL type_specifier init_declarator_list ';' {
+		$$ = parser_actions->handleDeclarationStatement($3, $4, toyc::ast::STORAGE_EXTERN, true);
+	}
+	| THREAD_LOCAL EXTERN type_specifier init_declarator_list ';' {
+		$$ = parser_actions->handleDeclarationStatement($3, $4, toyc::ast::STORAGE_EXTERN, true);
+	}
 	| type_specifier ';' {
 		$$ = parser_actions->handleEmptyDeclaration($1);
 	}
+	| TYPEDEF type_specifier init_declarator_list ';' {
+		$$ = parser_actions->handleTypedef($2, $3);
+	}
 	;
 
 init_declarator_list
@@ -290,6 +550,12 @@ init_declarator
 	| declarator '=' initializer {
 		$$ = parser_actions->handleInitDeclarator($1, $3);
 	}
+	| declarator attribute_specifiers {
+		$$ = parser_actions->handleDeclaratorAttributes($1, $2);
+	}
+	| declarator attribute_specifiers '=' initializer {
+		$$ = parser_actions->handleInitDeclarator(parser_actions->handleDeclaratorAttributes($1, $2), $4);
+	}
 	;
 
 declarator
@@ -320,29 +586,35 @@ pointer_qualifier
 	| '*' pointer_qualifier {
 		$$ = ($2 & toyc::ast::POINTER_LEVEL_MASK) + 1;
 	}
-	| '*' CONST {
-		$$ = 1 | toyc::ast::POINTER_CONST_BIT;
+	| '*' pointer_type_qualifier_list {
+		$$ = 1 | $2;
 	}
-	| '*' VOLATILE {
-		$$ = 1 | toyc::ast::POINTER_VOLATILE_BIT;
+	| '*' pointer_type_qualifier_list pointer_qualifier {
+		$$ = ($3 & toyc::ast::POINTER_LEVEL_MASK) + 1 | $2;
 	}
-	| '*' CONST VOLATILE {
-		$$ = 1 | toyc::ast::POINTER_CONST_BIT | toyc::ast::POINTER_VOLATILE_BIT;
+	;
+
+pointer_type_qualifier_list
+	: pointer_type_qualifier {
+		$$ = $1;
 	}
-	| '*' VOLATILE CONST {
-		$$ = 1 | toyc::ast::POINTER_CONST_BIT | toyc::ast::POINTER_VOLATILE_BIT;
+	| pointer_type_qualifier_list pointer_type_qualifier {
+		$$ = $1 | $2;
 	}
-	| '*' CONST pointer_qualifier {
-		$$ = ($3 & toyc::ast::POINTER_LEVEL_MASK) + 1 | toyc::ast::POINTER_CONST_BIT;
+	;
+
+pointer_type_qualifier
+	: CONST {
+		$$ = toyc::ast::POINTER_CONST_BIT;
 	}
-	| '*' VOLATILE pointer_qualifier {
-		$$ = ($3 & toyc::ast::POINTER_LEVEL_MASK) + 1 | toyc::ast::POINTER_VOLATILE_BIT;
+	| VOLATILE {
+		$$ = toyc::ast::POINTER_VOLATILE_BIT;
 	}
-	| '*' CONST VOLATILE pointer_qualifier {
-		$$ = ($4 & toyc::ast::POINTER_LEVEL_MASK) + 1 | toyc::ast::POINTER_CONST_BIT | toyc::ast::POINTER_VOLATILE_BIT;
+	| RESTRICT {
+		$$ = toyc::ast::POINTER_RESTRICT_BIT;
 	}
-	| '*' VOLATILE CONST pointer_qualifier {
-		$$ = ($4 & toyc::ast::POINTER_LEVEL_MASK) + 1 | toyc::ast::POINTER_CONST_BIT | toyc::ast::POINTER_VOLATILE_BIT;
+	| ATOMIC {
+		$$ = toyc::ast::POINTER_ATOMIC_BIT;
 	}
 	;
 
@@ -689,7 +961,8 @@ relational_expression_op
 
 type_specifier
 	: TYPEDEF_NAME {
-		$$ = toyc::ast::InvalidTypeIdx;
+		$$ = parser_actions->handleTypedefName(*$1);
+		delete $1;
 	}
 	| BOOL {
 		$$ = parser_actions->handlePrimitiveType("bool");
@@ -706,6 +979,45 @@ type_specifier
 	| LONG {
 		$$ = parser_actions->handlePrimitiveType("long");
 	}
+	| LONG LONG {
+		$$ = parser_actions->handlePrimitiveType("long long");
+	}
+	| SIGNED CHAR {
+		$$ = parser_actions->handlePrimitiveType("char");
+	}
+	| SIGNED SHORT {
+		$$ = parser_actions->handlePrimitiveType("short");
+	}
+	| SIGNED INT {
+		$$ = parser_actions->handlePrimitiveType("int");
+	}
+	| SIGNED {
+		$$ = parser_actions->handlePrimitiveType("int");
+	}
+	| SIGNED LONG {
+		$$ = parser_actions->handlePrimitiveType("long");
+	}
+	| SIGNED LONG LONG {
+		$$ = parser_actions->handlePrimitiveType("long long");
+	}
+	| UNSIGNED CHAR {
+		$$ = parser_actions->handlePrimitiveType("unsigned char");
+	}
+	| UNSIGNED SHORT {
+		$$ = parser_actions->handlePrimitiveType("unsigned short");
+	}
+	| UNSIGNED INT {
+		$$ = parser_actions->handlePrimitiveType("unsigned int");
+	}
+	| UNSIGNED {
+		$$ = parser_actions->handlePrimitiveType("unsigned int");
+	}
+	| UNSIGNED LONG {
+		$$ = parser_actions->handlePrimitiveType("unsigned long");
+	}
+	| UNSIGNED LONG LONG {
+		$$ = parser_actions->handlePrimitiveType("unsigned long long");
+	}
 	| FLOAT {
 		$$ = parser_actions->handlePrimitiveType("float");
 	}
@@ -724,22 +1036,51 @@ type_specifier
 	| VOLATILE type_specifier {
 		$$ = parser_actions->handleQualifiedType($2, toyc::ast::QUAL_VOLATILE);
 	}
+	| ATOMIC type_specifier {
+		$$ = parser_actions->handleQualifiedType($2, toyc::ast::QUAL_ATOMIC);
+	}
+	| ATOMIC '(' type_name ')' {
+		$$ = parser_actions->handleQualifiedType($3, toyc::ast::QUAL_ATOMIC);
+	}
 	;
 
 struct_specifier
-	: STRUCT IDENTIFIER '{' struct_declaration_list '}' {
-		$$ = parser_actions->handleStructSpecifier(*$2, $4);
+	: struct_or_union IDENTIFIER '{' struct_declaration_list '}' {
+		$$ = parser_actions->handleStructSpecifier($1, *$2, $4);
+		delete $2;
+	}
+	| struct_or_union IDENTIFIER '{' struct_declaration_list '}' attribute_specifiers {
+		$$ = parser_actions->handleStructSpecifier($1, *$2, $4, $6);
 		delete $2;
 	}
-	| STRUCT '{' struct_declaration_list '}' {
-		$$ = parser_actions->handleAnonymousStruct($3);
+	| struct_or_union attribute_specifiers IDENTIFIER '{' struct_declaration_list '}' {
+		$$ = parser_actions->handleStructSpecifier($1, *$3, $5, $2);
+		delete $3;
+	}
+	| struct_or_union '{' struct_declaration_list '}' {
+		$$ = parser_actions->handleAnonymousStruct($1, $3);
 	}
-	| STRUCT IDENTIFIER {
-		$$ = parser_actions->handleStructReference(*$2);
+	| struct_or_union '{' struct_declaration_list '}' attribute_specifiers {
+		$$ = parser_actions->handleAnonymousStruct($1, $3, $5);
+	}
+	| struct_or_union attribute_specifiers '{' struct_declaration_list '}' {
+		$$ = parser_actions->handleAnonymousStruct($1, $4, $2);
+	}
+	| struct_or_union IDENTIFIER {
+		$$ = parser_actions->handleStructReference($1, *$2);
 		delete $2;
 	}
 	;
 
+struct_or_union
+	: STRUCT {
+		$$ = 0;
+	}
+	| UNION {
+		$$ = 1;
+	}
+	;
+
 type_name
 	: type_specifier {
 		$$ = $1;
@@ -765,7 +1106,7 @@ struct_declaration_list
 		$$ = $1;
 		$$->next.reset($2);
 	}
-	| /* empty */ {
+	| %empty {
 		$$ = nullptr;
 	}
 	;
@@ -777,15 +1118,30 @@ struct_declaration
 	;
 
 struct_declarator_list
-	: declarator {
+	: struct_declarator {
 		$$ = $1;
 	}
-	| struct_declarator_list ',' declarator {
+	| struct_declarator ',' struct_declarator_list {
 		$$ = $1;
 		$$->next.reset($3);
 	}
 	;
 
+struct_declarator
+	: declarator {
+		$$ = $1;
+	}
+	| declarator attribute_specifiers {
+		$$ = parser_actions->handleDeclaratorAttributes($1, $2);
+	}
+	| declarator ':' constant_expression {
+		$$ = parser_actions->handleBitField($1, $3);
+	}
+	| ':' constant_expression {
+		$$ = parser_actions->handleBitField(nullptr, $2);
+	}
+	;
+
 %%
 #include <stdio.h>
 
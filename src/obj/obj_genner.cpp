@@ -1,3 +1,4 @@
+#include <llvm/Analysis/TargetLibraryInfo.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Module.h>
 #include <llvm/MC/TargetRegistry.h>
@@ -12,29 +13,45 @@
 
 namespace toyc::obj {
 
-bool ObjectGenner::generate(llvm::Module& module, const std::string& outputFileName) {
+std::unique_ptr<llvm::TargetMachine> ObjectGenner::createTargetMachine(const std::string& triple) {
     llvm::InitializeAllTargetInfos();
     llvm::InitializeAllTargets();
     llvm::InitializeAllTargetMCs();
     llvm::InitializeAllAsmParsers();
     llvm::InitializeAllAsmPrinters();
 
-    auto triple = llvm::sys::getDefaultTargetTriple();
-    module.setTargetTriple(triple);
-
     std::string error;
     auto target = llvm::TargetRegistry::lookupTarget(triple, error);
     if (!target) {
         llvm::errs() << "Failed to lookup target: " << error << "\n";
-        return false;
+        return nullptr;
     }
 
     auto CPU = "generic";
     auto Features = "";
 
     llvm::TargetOptions opt;
-    auto targetMachine = std::unique_ptr<llvm::TargetMachine>(
+    return std::unique_ptr<llvm::TargetMachine>(
         target->createTargetMachine(triple, CPU, Features, opt, llvm::Reloc::PIC_));
+}
+
+bool ObjectGenner::configureModule(llvm::Module& module) {
+    auto triple = llvm::sys::getDefaultTargetTriple();
+    auto targetMachine = createTargetMachine(triple);
+    if (!targetMachine) {
+        return false;
+    }
+    module.setDataLayout(targetMachine->createDataLayout());
+    module.setTargetTriple(triple);
+    return true;
+}
+
+bool ObjectGenner::generate(llvm::Module& module, const std::string& outputFileName, bool libraryBuiltins) {
+    auto triple = llvm::sys::getDefaultTargetTriple();
+    auto targetMachine = createTargetMachine(triple);
+    if (!targetMachine) {
+        return false;
+    }
     module.setDataLayout(targetMachine->createDataLayout());
     module.setTargetTriple(triple);
 
@@ -46,7 +63,14 @@ bool ObjectGenner::generate(llvm::Module& module, const std::string& outputFileN
         return false;
     }
 
+    // Describe the host C library, so the backend knows which library calls it may form and rely on
+    llvm::TargetLibraryInfoImpl libraryInfo(llvm::Triple(module.getTargetTriple()));
+    if (false == libraryBuiltins) {
+        libraryInfo.disableAllFunctions();
+    }
+
     llvm::legacy::PassManager pass;
+    pass.add(new llvm::TargetLibraryInfoWrapperPass(libraryInfo));
     if (targetMachine->addPassesToEmitFile(pass, dest, nullptr, llvm::CodeGenFileType::ObjectFile)) {
         llvm::errs() << "TargetMachine can't emit a file of this type\n";
         return false;
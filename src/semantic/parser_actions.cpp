@@ -1,5 +1,10 @@
 #include "semantic/parser_actions.hpp"
 
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
 #include <iostream>
 
 namespace toyc::semantic {
@@ -11,6 +16,46 @@ inline int decodePointerLevel(int encoded) {
 inline uint8_t decodePointerQuals(int encoded) {
     return static_cast<uint8_t>((encoded >> 16) & 0xFF);
 }
+
+// Splits a pragma line into identifiers, numbers and single punctuation characters
+std::vector<std::string> tokenizePragma(const std::string& pragma) {
+    std::vector<std::string> tokens;
+    for (size_t i = 0; i < pragma.size();) {
+        if (std::isspace(static_cast<unsigned char>(pragma[i]))) {
+            ++i;
+        } else if (std::isalnum(static_cast<unsigned char>(pragma[i])) || '_' == pragma[i]) {
+            size_t end = i;
+            while (end < pragma.size() && (std::isalnum(static_cast<unsigned char>(pragma[end])) || '_' == pragma[end]))
+                ++end;
+            tokens.push_back(pragma.substr(i, end - i));
+            i = end;
+        } else {
+            tokens.push_back(std::string(1, pragma[i++]));
+        }
+    }
+    return tokens;
+}
+
+// A positive loop count, or 0 when text is not one
+int parseLoopCount(const std::string& text) {
+    char* end = nullptr;
+    long value = std::strtol(text.c_str(), &end, 0);
+    return ('\0' == *end && value > 0 && value <= INT32_MAX) ? static_cast<int>(value) : 0;
+}
+
+// Appends the names of a comma-separated identifier list; false if the list is empty or malformed
+bool parseNameList(const std::vector<std::string>& tokens, size_t begin, std::vector<std::string>& names) {
+    for (size_t i = begin; i < tokens.size(); i += 2) {
+        if (false == (std::isalpha(static_cast<unsigned char>(tokens[i][0])) || '_' == tokens[i][0])) {
+            return false;
+        }
+        names.push_back(tokens[i]);
+        if (i + 1 < tokens.size() && "," != tokens[i + 1]) {
+            return false;
+        }
+    }
+    return begin < tokens.size() && "," != tokens.back();
+}
 }  // namespace
 
 ParserActions::ParserActions(ast::TypeManager* typeManager) : typeManager_(typeManager), errorOccurred(false) {}
@@ -39,6 +84,118 @@ ast::NFunctionDefinition* ParserActions::handleFunctionDeclaration(ast::TypeIdx
     return new ast::NFunctionDefinition(returnTypeIdx, name, params, nullptr);
 }
 
+ast::NExternalDeclaration* ParserActions::handleFunctionSpecifiers(ast::NExternalDeclaration* function,
+                                                                   ast::StorageClass storageClass, bool isInline) {
+    static_cast<ast::NFunctionDefinition*>(function)->setSpecifiers(storageClass, isInline);
+    return function;
+}
+
+// GNU Attributes
+ast::GnuAttribute* ParserActions::handleAttribute(const std::string& name, std::vector<std::string>* arguments) {
+    auto* attribute = new ast::GnuAttribute();
+    attribute->name = name;
+    // `__noinline__` and `noinline` name the same attribute
+    if (attribute->name.size() > 4 && 0 == attribute->name.compare(0, 2, "__") &&
+        0 == attribute->name.compare(attribute->name.size() - 2, 2, "__")) {
+        attribute->name = attribute->name.substr(2, attribute->name.size() - 4);
+    }
+    if (nullptr != arguments) {
+        attribute->arguments = std::move(*arguments);
+        delete arguments;
+    }
+    return attribute;
+}
+
+ast::GnuAttributeList* ParserActions::handleAttributeList(ast::GnuAttributeList* list, ast::GnuAttribute* attribute) {
+    if (nullptr == list) {
+        list = new ast::GnuAttributeList();
+    }
+    // `__attribute__(())` and trailing commas contribute empty entries
+    if (nullptr != attribute) {
+        list->push_back(std::move(*attribute));
+        delete attribute;
+    }
+    return list;
+}
+
+ast::GnuAttributeList* ParserActions::handleAttributeSpecifiers(ast::GnuAttributeList* list,
+                                                                ast::GnuAttributeList* more) {
+    list->insert(list->end(), std::make_move_iterator(more->begin()), std::make_move_iterator(more->end()));
+    delete more;
+    return list;
+}
+
+ast::NExternalDeclaration* ParserActions::handleDeclarationAttributes(ast::NExternalDeclaration* declaration,
+                                                                      ast::GnuAttributeList* attributes) {
+    if (nullptr != declaration && "FunctionDefinition" == declaration->getType()) {
+        static_cast<ast::NFunctionDefinition*>(declaration)->addAttributes(std::move(*attributes));
+    } else if (nullptr != declaration && "DeclarationStatement" == declaration->getType()) {
+        // A leading attribute applies to every declarator of the declaration
+        auto* statement = static_cast<ast::NDeclarationStatement*>(declaration);
+        for (ast::NDeclarator* declarator = statement->getDeclarators(); nullptr != declarator;
+             declarator = declarator->next.get()) {
+            handleDeclaratorAttributes(declarator, new ast::GnuAttributeList(*attributes));
+        }
+    } else {
+        for (const ast::GnuAttribute& attribute : *attributes) {
+            std::cerr << "Warning: attribute '" << attribute.name << "' ignored on a non-function declaration"
+                      << std::endl;
+        }
+    }
+    delete attributes;
+    return declaration;
+}
+
+ast::NDeclarator* ParserActions::handleDeclaratorAttributes(ast::NDeclarator* declarator,
+                                                           ast::GnuAttributeList* attributes) {
+    // vector_size changes the declared type rather than the layout; handleTypedef applies it
+    ast::GnuAttributeList layoutAttributes;
+    for (const ast::GnuAttribute& attribute : *attributes) {
+        if ("tls_model" == attribute.name) {
+            if (1 != attribute.arguments.size() ||
+                false == ast::parseTlsModel(attribute.arguments[0], declarator->tlsModel)) {
+                reportError("tls_model of '" + declarator->getName() +
+                            "' must be one of global-dynamic, local-dynamic, initial-exec or local-exec");
+            }
+        } else if ("vector_size" != attribute.name) {
+            layoutAttributes.push_back(attribute);
+        } else if (1 != attribute.arguments.size()) {
+            reportError("vector_size of '" + declarator->getName() + "' takes exactly one argument");
+        } else {
+            declarator->vectorSize = std::strtoull(attribute.arguments[0].c_str(), nullptr, 0);
+        }
+    }
+    uint64_t alignment = declarator->alignment;
+    bool packed = declarator->packed;
+    parseLayoutAttributes(layoutAttributes, "'" + declarator->getName() + "'", alignment, packed);
+    declarator->alignment = alignment;
+    declarator->packed = packed;
+    delete attributes;
+    return declarator;
+}
+
+void ParserActions::parseLayoutAttributes(const ast::GnuAttributeList& attributes, const std::string& subject,
+                                          uint64_t& alignment, bool& packed) {
+    for (const ast::GnuAttribute& attribute : attributes) {
+        if ("packed" == attribute.name) {
+            packed = true;
+        } else if ("aligned" == attribute.name) {
+            // Without an argument GCC uses the largest alignment the target ever needs
+            uint64_t requested = 16;
+            if (false == attribute.arguments.empty()) {
+                requested = std::strtoull(attribute.arguments[0].c_str(), nullptr, 0);
+            }
+            if (0 == requested || 0 != (requested & (requested - 1))) {
+                reportError("requested alignment of " + subject + " is not a power of two");
+                continue;
+            }
+            alignment = std::max(alignment, requested);
+        } else {
+            std::cerr << "Warning: attribute '" << attribute.name << "' ignored on " << subject << std::endl;
+        }
+    }
+}
+
 // Parameters
 ast::NParameter* ParserActions::handleParameterList(ast::NParameter* current, ast::NParameter* next, int line,
                                                     int column) {
@@ -118,8 +275,8 @@ ast::NLabelStatement* ParserActions::handleLabelStatement(const std::string& lab
     return new ast::NLabelStatement(label, statement);
 }
 
-ast::NCaseStatement* ParserActions::handleCaseStatement(ast::NExpression* value) {
-    return new ast::NCaseStatement(value);
+ast::NCaseStatement* ParserActions::handleCaseStatement(ast::NExpression* value, ast::NExpression* rangeEnd) {
+    return new ast::NCaseStatement(value, nullptr, rangeEnd);
 }
 
 ast::NCaseStatement* ParserActions::handleDefaultStatement() {
@@ -143,16 +300,206 @@ ast::NContinueStatement* ParserActions::handleContinueStatement() {
     return new ast::NContinueStatement();
 }
 
+// Loop Pragmas
+ast::LoopHints* ParserActions::handleLoopPragma(ast::LoopHints* hints, const std::string& pragma) {
+    if (nullptr == hints) {
+        hints = new ast::LoopHints();
+    }
+    std::vector<std::string> tokens = tokenizePragma(pragma);
+    // tokens[0] and tokens[1] are '#' and 'pragma'
+    auto at = [&tokens](size_t i) { return i < tokens.size() ? tokens[i] : std::string(); };
+
+    if ("GCC" == at(2) && "ivdep" == at(3)) {
+        hints->parallelAccesses = true;
+    } else if (("GCC" == at(2) && "unroll" == at(3)) || "unroll" == at(2)) {
+        // `#pragma GCC unroll 0` and `1` disable unrolling; a bare `#pragma unroll` unrolls fully
+        size_t countIndex = "unroll" == at(2) ? 3 : 4;
+        if ("(" == at(countIndex)) {
+            ++countIndex;  // `#pragma unroll(N)`
+        }
+        std::string count = at(countIndex);
+        if (true == count.empty() && "unroll" == at(2)) {
+            hints->unrollFull = true;
+        } else if ("0" == count || 1 == parseLoopCount(count)) {
+            hints->unrollDisable = true;
+        } else if (0 != parseLoopCount(count)) {
+            hints->unrollCount = parseLoopCount(count);
+        } else {
+            reportError("unroll count in '" + pragma + "' must be a non-negative integer");
+        }
+    } else if ("nounroll" == at(2)) {
+        hints->unrollDisable = true;
+    } else if ("clang" == at(2) && "loop" == at(3)) {
+        // A sequence of `option(argument)`
+        for (size_t i = 4; i < tokens.size(); i += 4) {
+            const std::string option = at(i);
+            const std::string argument = at(i + 2);
+            if ("(" != at(i + 1) || ")" != at(i + 3)) {
+                reportError("malformed loop hint '" + option + "' in '" + pragma + "'");
+                break;
+            }
+            if ("vectorize" == option && ("enable" == argument || "assume_safety" == argument)) {
+                hints->vectorizeEnable = true;
+                hints->parallelAccesses = hints->parallelAccesses || "assume_safety" == argument;
+            } else if ("vectorize" == option && "disable" == argument) {
+                hints->vectorizeDisable = true;
+            } else if ("vectorize_width" == option && 0 != parseLoopCount(argument)) {
+                hints->vectorizeWidth = parseLoopCount(argument);
+            } else if ("interleave" == option && "disable" == argument) {
+                hints->interleaveCount = 1;
+            } else if ("interleave_count" == option && 0 != parseLoopCount(argument)) {
+                hints->interleaveCount = parseLoopCount(argument);
+            } else if ("unroll" == option && "enable" == argument) {
+                hints->unrollEnable = true;
+            } else if ("unroll" == option && "full" == argument) {
+                hints->unrollFull = true;
+            } else if ("unroll" == option && "disable" == argument) {
+                hints->unrollDisable = true;
+            } else if (("unroll" == option || "unroll_count" == option) && 0 != parseLoopCount(argument)) {
+                hints->unrollCount = parseLoopCount(argument);
+            } else {
+                reportError("unsupported loop hint '" + option + "(" + argument + ")' in '" + pragma + "'");
+            }
+        }
+    } else if ("omp" == at(2) && "parallel" == at(3) && "for" == at(4)) {
+        hints->parallelFor = true;
+        // A sequence of `clause(arguments)`
+        for (size_t i = 5; i < tokens.size();) {
+            const std::string clause = at(i);
+            size_t close = i + 2;
+            while (close < tokens.size() && ")" != tokens[close]) {
+                ++close;
+            }
+            if ("(" != at(i + 1) || close == tokens.size()) {
+                reportError("malformed clause '" + clause + "' in '" + pragma + "'");
+                break;
+            }
+            std::vector<std::string> arguments(tokens.begin() + i + 2, tokens.begin() + close);
+            i = close + 1;
+
+            bool isValid = false;
+            if ("schedule" == clause) {
+                // schedule(static|dynamic[, N])
+                isValid = false == arguments.empty() && ("static" == arguments[0] || "dynamic" == arguments[0]) &&
+                          (1 == arguments.size() ||
+                           (3 == arguments.size() && "," == arguments[1] && 0 != parseLoopCount(arguments[2])));
+                if (true == isValid) {
+                    hints->schedule =
+                        "static" == arguments[0] ? ast::OMP_SCHEDULE_STATIC : ast::OMP_SCHEDULE_DYNAMIC;
+                    hints->chunkSize = 3 == arguments.size() ? parseLoopCount(arguments[2]) : 0;
+                }
+            } else if ("private" == clause) {
+                isValid = parseNameList(arguments, 0, hints->privateVars);
+            } else if ("reduction" == clause) {
+                isValid = arguments.size() > 2 && "+" == arguments[0] && ":" == arguments[1] &&
+                          parseNameList(arguments, 2, hints->reductionVars);
+            }
+            if (false == isValid) {
+                std::string text;
+                for (const std::string& argument : arguments) {
+                    text += argument;
+                }
+                reportError("unsupported clause '" + clause + "(" + text + ")' in '" + pragma + "'");
+            }
+        }
+    } else {
+        std::cerr << "Warning: ignoring '" << pragma << "'" << std::endl;
+    }
+    return hints;
+}
+
+ast::NStatement* ParserActions::handleLoopHints(ast::LoopHints* hints, ast::NStatement* loop) {
+    if (auto* forStatement = dynamic_cast<ast::NForStatement*>(loop)) {
+        forStatement->setLoopHints(*hints);
+    } else if (auto* whileStatement = dynamic_cast<ast::NWhileStatement*>(loop)) {
+        if (true == hints->parallelFor) {
+            reportError("'#pragma omp parallel for' must be followed by a for loop");
+        }
+        whileStatement->setLoopHints(*hints);
+    }
+    delete hints;
+    return loop;
+}
+
+// Asm statements
+std::vector<ast::AsmOperand>* ParserActions::handleAsmOperand(std::vector<ast::AsmOperand>* list,
+                                                              const std::string& name, const std::string& constraint,
+                                                              ast::NExpression* expr) {
+    if (nullptr == list) {
+        list = new std::vector<ast::AsmOperand>();
+    }
+    list->push_back(ast::AsmOperand{name, constraint, std::unique_ptr<ast::NExpression>(expr)});
+    return list;
+}
+
+ast::NAsmStatement* ParserActions::handleAsmStatement(bool isVolatile, const std::string& asmTemplate,
+                                                      std::vector<ast::AsmOperand>* outputs,
+                                                      std::vector<ast::AsmOperand>* inputs,
+                                                      std::vector<std::string>* clobbers) {
+    std::unique_ptr<std::vector<ast::AsmOperand>> outputList(outputs);
+    std::unique_ptr<std::vector<ast::AsmOperand>> inputList(inputs);
+    std::unique_ptr<std::vector<std::string>> clobberList(clobbers);
+    return new ast::NAsmStatement(asmTemplate, isVolatile,
+                                  nullptr != outputList ? std::move(*outputList) : std::vector<ast::AsmOperand>(),
+                                  nullptr != inputList ? std::move(*inputList) : std::vector<ast::AsmOperand>(),
+                                  nullptr != clobberList ? std::move(*clobberList) : std::vector<std::string>());
+}
+
 // Declarations
 ast::NDeclarationStatement* ParserActions::handleDeclarationStatement(ast::TypeIdx typeIdx,
-                                                                      ast::NDeclarator* declarator) {
-    return new ast::NDeclarationStatement(typeIdx, declarator);
+                                                                      ast::NDeclarator* declarator,
+                                                                      ast::StorageClass storageClass,
+                                                                      bool threadLocal) {
+    for (ast::NDeclarator* current = declarator; current != nullptr; current = current->next.get()) {
+        if (0 != current->vectorSize) {
+            std::cerr << "Warning: attribute 'vector_size' ignored on '" << current->getName()
+                      << "'; declare a vector typedef instead" << std::endl;
+        }
+    }
+    return new ast::NDeclarationStatement(typeIdx, declarator, storageClass, threadLocal);
 }
 
 ast::NDeclarationStatement* ParserActions::handleEmptyDeclaration(ast::TypeIdx typeIdx) {
     return new ast::NDeclarationStatement(typeIdx, nullptr);
 }
 
+ast::NDeclarationStatement* ParserActions::handleTypedef(ast::TypeIdx typeIdx, ast::NDeclarator* declarator) {
+    for (ast::NDeclarator* current = declarator; current != nullptr; current = current->next.get()) {
+        ast::TypeIdx aliasedIdx = typeManager_->getDeclaratorType(typeIdx, current);
+        if (0 != current->vectorSize) {
+            if (true == current->isPointer() || true == current->isArray()) {
+                reportError("vector_size of '" + current->getName() + "' needs a scalar arithmetic type");
+                continue;
+            }
+            aliasedIdx = getVectorTypeIdx(typeIdx, current->vectorSize, current->getName());
+        }
+        if (ast::InvalidTypeIdx != aliasedIdx) {
+            typedefs_[current->getName()] = aliasedIdx;
+        }
+    }
+    delete declarator;
+    return handleEmptyDeclaration(typeIdx);
+}
+
+ast::TypeIdx ParserActions::getVectorTypeIdx(ast::TypeIdx typeIdx, uint64_t vectorSize, const std::string& name) {
+    ast::TypeIdx elementIdx = typeManager_->unqualify(typeIdx);
+    bool isBool = elementIdx == typeManager_->getPrimitiveIdx(ast::VAR_TYPE_BOOL);
+    if (true == isBool || (false == typeManager_->isIntegerType(elementIdx) &&
+                           false == typeManager_->isFloatingPointType(elementIdx))) {
+        reportError("vector_size of '" + name + "' needs a scalar arithmetic type");
+        return ast::InvalidTypeIdx;
+    }
+    // Lanes are a power of two that exactly fill the requested size
+    uint64_t elementSize = typeManager_->realize(elementIdx)->getPrimitiveSizeInBits() / 8;
+    uint64_t lanes = vectorSize / elementSize;
+    if (0 != vectorSize % elementSize || 0 == lanes || 0 != (lanes & (lanes - 1))) {
+        reportError("vector_size(" + std::to_string(vectorSize) + ") of '" + name +
+                    "' is not a power-of-two multiple of its element size");
+        return ast::InvalidTypeIdx;
+    }
+    return typeManager_->getVectorIdx(elementIdx, static_cast<int>(lanes));
+}
+
 ast::NDeclarator* ParserActions::handleDeclaratorList(ast::NDeclarator* current, ast::NDeclarator* next) {
     if (current) {
         current->next.reset(next);
@@ -258,7 +605,32 @@ ast::NInteger* ParserActions::handleInteger(int value) {
 }
 
 ast::NInteger* ParserActions::handleIntegerFromString(const std::string& value) {
-    return new ast::NInteger(atoi(value.c_str()));
+    size_t suffixStart = value.find_first_of("uUlL");
+    std::string digits = value.substr(0, suffixStart);
+    std::string suffix = (std::string::npos == suffixStart) ? "" : value.substr(suffixStart);
+    bool isUnsignedSuffix = std::string::npos != suffix.find_first_of("uU");
+    bool isLongSuffix = std::string::npos != suffix.find_first_of("lL");
+    bool isDecimal = !(digits.size() > 1 && '0' == digits[0]);
+
+    errno = 0;
+    unsigned long long magnitude = strtoull(digits.c_str(), nullptr, 0);
+    if (ERANGE == errno) {
+        std::cerr << "Warning: integer literal " << value << " is too large; truncated to 64 bits" << std::endl;
+    }
+
+    // C11 6.4.4.1: the literal takes the first type in its candidate list that can represent its value.
+    // Decimal literals without a `u` suffix only ever go signed; hex and octal literals may go unsigned.
+    ast::VarType varType;
+    if (false == isLongSuffix && false == isUnsignedSuffix && magnitude <= INT32_MAX) {
+        varType = ast::VAR_TYPE_INT;
+    } else if (false == isLongSuffix && (isUnsignedSuffix || false == isDecimal) && magnitude <= UINT32_MAX) {
+        varType = ast::VAR_TYPE_UINT;
+    } else if (false == isUnsignedSuffix && magnitude <= INT64_MAX) {
+        varType = ast::VAR_TYPE_LONG;
+    } else {
+        varType = ast::VAR_TYPE_ULONG;
+    }
+    return new ast::NInteger(static_cast<int64_t>(magnitude), varType);
 }
 
 ast::NInteger* ParserActions::handleCharConstant(const std::string& value) {
@@ -304,7 +676,13 @@ ast::NInteger* ParserActions::handleCharConstant(const std::string& value) {
 }
 
 ast::NFloat* ParserActions::handleFloat(const std::string& value) {
-    return new ast::NFloat(atof(value.c_str()));
+    // An f/F suffix makes the literal a float, parsed at float precision so it is rounded only once.
+    // There is no long double type, so an l/L suffix keeps the literal a double.
+    char suffix = value.empty() ? '\0' : value.back();
+    if (suffix == 'f' || suffix == 'F') {
+        return new ast::NFloat(strtof(value.c_str(), nullptr), ast::VAR_TYPE_FLOAT);
+    }
+    return new ast::NFloat(strtod(value.c_str(), nullptr));
 }
 
 ast::NString* ParserActions::handleString(const std::string& value) {
@@ -353,6 +731,15 @@ ast::NExpression* ParserActions::handleCompoundAssignment(ast::NExpression* left
 }
 
 // Type Specifiers
+ast::TypeIdx ParserActions::handleTypedefName(const std::string& name) {
+    auto it = typedefs_.find(name);
+    if (it == typedefs_.end()) {
+        reportError("unknown type name '" + name + "'");
+        return ast::InvalidTypeIdx;
+    }
+    return it->second;
+}
+
 ast::TypeIdx ParserActions::handlePrimitiveType(const std::string& typeName) {
     if (typeName == "bool") {
         return typeManager_->getPrimitiveIdx(toyc::ast::VAR_TYPE_BOOL);
@@ -362,8 +749,17 @@ ast::TypeIdx ParserActions::handlePrimitiveType(const std::string& typeName) {
         return typeManager_->getPrimitiveIdx(toyc::ast::VAR_TYPE_SHORT);
     } else if (typeName == "int") {
         return typeManager_->getPrimitiveIdx(toyc::ast::VAR_TYPE_INT);
-    } else if (typeName == "long") {
+    } else if (typeName == "long" || typeName == "long long") {
+        // LP64: long long shares long's 64-bit representation
         return typeManager_->getPrimitiveIdx(toyc::ast::VAR_TYPE_LONG);
+    } else if (typeName == "unsigned char") {
+        return typeManager_->getPrimitiveIdx(toyc::ast::VAR_TYPE_UCHAR);
+    } else if (typeName == "unsigned short") {
+        return typeManager_->getPrimitiveIdx(toyc::ast::VAR_TYPE_USHORT);
+    } else if (typeName == "unsigned int") {
+        return typeManager_->getPrimitiveIdx(toyc::ast::VAR_TYPE_UINT);
+    } else if (typeName == "unsigned long" || typeName == "unsigned long long") {
+        return typeManager_->getPrimitiveIdx(toyc::ast::VAR_TYPE_ULONG);
     } else if (typeName == "float") {
         return typeManager_->getPrimitiveIdx(toyc::ast::VAR_TYPE_FLOAT);
     } else if (typeName == "double") {
@@ -387,11 +783,42 @@ ast::TypeIdx ParserActions::handlePointerType(ast::TypeIdx baseTypeIdx, int enco
 }
 
 ast::TypeIdx ParserActions::handleQualifiedType(ast::TypeIdx baseTypeIdx, uint8_t qualifiers) {
+    // Atomic accesses are single loads, stores and read-modify-writes, which LLVM only has for byte-sized
+    // integers, floating point and pointers
+    if (0 != (qualifiers & ast::QUAL_ATOMIC)) {
+        const ast::TypeCodegen* base = typeManager_->get(typeManager_->unqualify(baseTypeIdx));
+        auto* primitive = dynamic_cast<const ast::PrimitiveTypeCodegen*>(base);
+        bool scalar = nullptr != dynamic_cast<const ast::PointerTypeCodegen*>(base) ||
+                      (nullptr != primitive && ast::VAR_TYPE_VOID != primitive->getVarType() &&
+                       ast::VAR_TYPE_BOOL != primitive->getVarType());
+        if (false == scalar) {
+            reportError("_Atomic is only supported on integer, floating-point and pointer types");
+        }
+    }
     return typeManager_->getQualifiedIdx(baseTypeIdx, qualifiers);
 }
 
 // Struct
 ast::NStructDeclaration* ParserActions::handleStructDeclaration(ast::TypeIdx typeIdx, ast::NDeclarator* declarator) {
+    for (ast::NDeclarator* current = declarator; nullptr != current; current = current->next.get()) {
+        if (current->bitWidth < 0) {
+            continue;
+        }
+        std::string subject =
+            current->getName().empty() ? "unnamed bit-field" : "bit-field '" + current->getName() + "'";
+        ast::TypeIdx baseIdx = typeManager_->unqualify(typeIdx);
+        if (true == current->isPointer() || true == current->isArray() ||
+            false == typeManager_->isIntegerType(baseIdx)) {
+            reportError(subject + " must have an integer type");
+        } else if (true == typeManager_->isAtomicQualified(typeIdx)) {
+            reportError(subject + " cannot be _Atomic");
+        } else if (static_cast<unsigned>(current->bitWidth) >
+                   typeManager_->realize(baseIdx)->getIntegerBitWidth()) {
+            reportError("width of " + subject + " exceeds its type");
+        } else if (0 == current->bitWidth && false == current->getName().empty()) {
+            reportError("named " + subject + " has zero width");
+        }
+    }
     return new ast::NStructDeclaration(typeIdx, declarator);
 }
 
@@ -403,16 +830,53 @@ ast::NStructDeclaration* ParserActions::handleStructDeclarationList(ast::NStruct
     return current;
 }
 
-ast::TypeIdx ParserActions::handleStructSpecifier(const std::string& name, ast::NStructDeclaration* declarations) {
-    return typeManager_->getStructIdx(name, declarations);
+ast::NDeclarator* ParserActions::handleBitField(ast::NDeclarator* declarator, ast::NExpression* width) {
+    if (nullptr == declarator) {
+        declarator = new ast::NDeclarator("");
+    }
+    auto* constant = dynamic_cast<ast::NInteger*>(width);
+    if (nullptr == constant || constant->getValue() < 0) {
+        reportError("width of bit-field '" + declarator->getName() + "' must be a non-negative integer constant");
+    } else {
+        // Anything wider than 64 bits exceeds every type and is rejected along with the member declaration
+        declarator->bitWidth = static_cast<int>(std::min<int64_t>(constant->getValue(), 65));
+    }
+    delete width;
+    return declarator;
 }
 
-ast::TypeIdx ParserActions::handleAnonymousStruct(ast::NStructDeclaration* declarations) {
-    return typeManager_->getStructIdx("", declarations);
+ast::TypeIdx ParserActions::handleStructSpecifier(bool isUnion, const std::string& name,
+                                                  ast::NStructDeclaration* declarations,
+                                                  ast::GnuAttributeList* attributes) {
+    ast::TypeIdx idx = isUnion ? typeManager_->getUnionIdx(name, declarations)
+                               : typeManager_->getStructIdx(name, declarations);
+    if (nullptr != attributes) {
+        uint64_t alignment = 0;
+        bool packed = false;
+        parseLayoutAttributes(*attributes, (isUnion ? "union " : "struct ") + name, alignment, packed);
+        typeManager_->setStructLayoutAttributes(idx, packed, alignment);
+        delete attributes;
+    }
+    return idx;
+}
+
+ast::TypeIdx ParserActions::handleAnonymousStruct(bool isUnion, ast::NStructDeclaration* declarations,
+                                                  ast::GnuAttributeList* attributes) {
+    ast::TypeIdx idx =
+        isUnion ? typeManager_->getUnionIdx("", declarations) : typeManager_->getStructIdx("", declarations);
+    if (nullptr != attributes) {
+        uint64_t alignment = 0;
+        bool packed = false;
+        parseLayoutAttributes(*attributes, isUnion ? "an anonymous union" : "an anonymous struct", alignment,
+                              packed);
+        typeManager_->setStructLayoutAttributes(idx, packed, alignment);
+        delete attributes;
+    }
+    return idx;
 }
 
-ast::TypeIdx ParserActions::handleStructReference(const std::string& name) {
-    return typeManager_->getStructIdx(name, nullptr);
+ast::TypeIdx ParserActions::handleStructReference(bool isUnion, const std::string& name) {
+    return isUnion ? typeManager_->getUnionIdx(name, nullptr) : typeManager_->getStructIdx(name, nullptr);
 }
 
 ast::TypeIdx ParserActions::handleTypeNameWithPointer(ast::TypeIdx baseTypeIdx, int encoded) {
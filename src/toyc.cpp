@@ -21,6 +21,11 @@ extern toyc::semantic::ParserActions *parser_actions;
 
 #define TMP_FILE_NAME "%%%%TMP%%%%.o"
 
+// Work-sharing runtime for `#pragma omp parallel for`; the Makefile passes where it was built
+#ifndef TOYC_RUNTIME_LIB
+#define TOYC_RUNTIME_LIB "build/libtoycrt.a"
+#endif
+
 void help() {
     std::cout << "Usage: toyc <filename>" << std::endl;
     std::cout << "Options:" << std::endl;
@@ -30,6 +35,24 @@ void help() {
     std::cout << "  -E              Run only the preprocessor" << std::endl;
     std::cout << "  -D <macro>      Define a macro" << std::endl;
     std::cout << "  -I <path>       Add include path" << std::endl;
+    std::cout << "  -fno-strict-aliasing  Do not emit type-based alias analysis metadata" << std::endl;
+    std::cout << "  -fstruct-layout-report  Print the size, field offsets and padding of every struct" << std::endl;
+    std::cout << "  -fno-builtin    Call libc/libm functions such as memcpy and sqrt instead of lowering them"
+              << std::endl;
+    std::cout << "  -fno-builtin-<name>  Call the library function <name> instead of lowering it" << std::endl;
+    std::cout << "  -fPIC, -fpic    Generate code that may be linked into a shared object" << std::endl;
+    std::cout << "  -ftls-model=<model>  Access thread-local variables with global-dynamic, local-dynamic,"
+              << std::endl;
+    std::cout << "                  initial-exec or local-exec (default: initial-exec, global-dynamic with -fPIC)"
+              << std::endl;
+    std::cout << "  -ffast-math     Let floating-point math ignore NaNs, infinities, signed zeros and rounding"
+              << std::endl;
+    std::cout << "  -fassociative-math  Let floating-point additions and multiplications be reordered" << std::endl;
+    std::cout << "  -freciprocal-math   Let x / y be computed as x * (1 / y)" << std::endl;
+    std::cout << "  -ffp-contract=<mode>  Fuse a * b + c: off (default), on (within an expression) or fast"
+              << std::endl;
+    std::cout << "  -fno-math-errno  Lower sqrt to llvm.sqrt, which does not set errno (default: -fmath-errno)"
+              << std::endl;
 }
 
 int main(int argc, char *argv[]) {
@@ -42,13 +65,15 @@ int main(int argc, char *argv[]) {
     bool preprocessOnly = false;
     std::vector<std::pair<std::string, std::string>> macroDefines;
     std::vector<std::string> includePaths;
+    toyc::ast::CodegenOptions codegenOptions;
+    bool mathErrnoGiven = false;  // -fno-fast-math restores errno-setting sqrt unless it was chosen explicitly
 
     if (argc < 2) {
         help();
         return -1;
     }
 
-    while ((flag = getopt(argc, argv, "hlEo:D:I:")) != -1) {
+    while ((flag = getopt(argc, argv, "hlEo:D:I:f:")) != -1) {
         switch (flag) {
             case 'h':
                 help();
@@ -75,12 +100,75 @@ int main(int argc, char *argv[]) {
             case 'I':
                 includePaths.push_back(std::string(optarg));
                 break;
+            case 'f': {
+                std::string feature = std::string(optarg);
+                if (feature == "strict-aliasing") {
+                    codegenOptions.strictAliasing = true;
+                } else if (feature == "no-strict-aliasing") {
+                    codegenOptions.strictAliasing = false;
+                } else if (feature == "struct-layout-report") {
+                    codegenOptions.structLayoutReport = true;
+                } else if (feature == "builtin") {
+                    codegenOptions.libraryBuiltins = true;
+                } else if (feature == "no-builtin") {
+                    codegenOptions.libraryBuiltins = false;
+                } else if (0 == feature.rfind("no-builtin-", 0)) {
+                    codegenOptions.noBuiltinFunctions.insert(feature.substr(std::string("no-builtin-").size()));
+                } else if (feature == "PIC" || feature == "pic") {
+                    codegenOptions.positionIndependent = true;
+                } else if (feature == "no-PIC" || feature == "no-pic") {
+                    codegenOptions.positionIndependent = false;
+                } else if (0 == feature.rfind("tls-model=", 0)) {
+                    std::string model = feature.substr(std::string("tls-model=").size());
+                    if (false == toyc::ast::parseTlsModel(model, codegenOptions.tlsModel)) {
+                        std::cerr << "Unknown TLS model: " << model << std::endl;
+                        return -1;
+                    }
+                } else if (feature == "fast-math") {
+                    codegenOptions.fastMath.setFast();
+                    codegenOptions.fpContract = toyc::ast::FP_CONTRACT_FAST;
+                    codegenOptions.mathErrno = false;
+                } else if (feature == "no-fast-math") {
+                    codegenOptions.fastMath.clear();
+                    codegenOptions.fpContract = toyc::ast::FP_CONTRACT_OFF;
+                    if (false == mathErrnoGiven) {
+                        codegenOptions.mathErrno = true;
+                    }
+                } else if (feature == "associative-math" || feature == "no-associative-math") {
+                    codegenOptions.fastMath.setAllowReassoc(feature == "associative-math");
+                } else if (feature == "reciprocal-math" || feature == "no-reciprocal-math") {
+                    codegenOptions.fastMath.setAllowReciprocal(feature == "reciprocal-math");
+                } else if (feature == "math-errno" || feature == "no-math-errno") {
+                    codegenOptions.mathErrno = (feature == "math-errno");
+                    mathErrnoGiven = true;
+                } else if (0 == feature.rfind("fp-contract=", 0)) {
+                    std::string mode = feature.substr(std::string("fp-contract=").size());
+                    if (mode == "off") {
+                        codegenOptions.fpContract = toyc::ast::FP_CONTRACT_OFF;
+                    } else if (mode == "on") {
+                        codegenOptions.fpContract = toyc::ast::FP_CONTRACT_ON;
+                    } else if (mode == "fast") {
+                        codegenOptions.fpContract = toyc::ast::FP_CONTRACT_FAST;
+                    } else {
+                        std::cerr << "Unknown floating-point contraction mode: " << mode << std::endl;
+                        return -1;
+                    }
+                } else {
+                    std::cerr << "Unknown option: -f" << feature << std::endl;
+                    return -1;
+                }
+                break;
+            }
             case '?':
             default:
                 std::cerr << "Unknown option: " << static_cast<char>(flag) << std::endl;
                 return -1;
         }
     }
+    codegenOptions.fastMath.setAllowContract(toyc::ast::FP_CONTRACT_FAST == codegenOptions.fpContract);
+    if (true == codegenOptions.fastMath.isFast()) {
+        macroDefines.push_back({"__FAST_MATH__", "1"});
+    }
     inputFileName = argv[optind];
     outputFileName = outputFileName.empty() ? inputFileName.substr(0, inputFileName.find_last_of('.')) : outputFileName;
 
@@ -110,6 +198,11 @@ int main(int argc, char *argv[]) {
 
     // Create ASTContext early so TypeManager is available during parsing
     toyc::ast::ASTContext astContext;
+    astContext.options = codegenOptions;
+    if (false == toyc::obj::ObjectGenner::configureModule(astContext.module)) {
+        std::cerr << "Failed to configure the target for code generation." << std::endl;
+        return -1;
+    }
     parser_actions = new toyc::semantic::ParserActions(&astContext.getTypeManager());
 
     // Parse the file with preprocessor
@@ -126,6 +219,9 @@ int main(int argc, char *argv[]) {
         error_handler->logError();
         return -1;
     }
+    if (true == parserActionsOwner->hasError()) {
+        return -1;
+    }
 
     // Code generation
     for (auto *decl = programOwner.get(); decl != nullptr; decl = decl->next.get()) {
@@ -136,6 +232,12 @@ int main(int argc, char *argv[]) {
         }
     }
 
+    astContext.inferFunctionAttributes();
+
+    if (true == astContext.options.structLayoutReport) {
+        astContext.typeManager->printStructLayouts(std::cout);
+    }
+
     // llvm::legacy::PassManager passManager;
     // passManager.add(llvm::createPromoteMemoryToRegisterPass());
     // passManager.add(llvm::createInstructionNamerPass());
@@ -158,14 +260,18 @@ int main(int argc, char *argv[]) {
 
     // generate object file
     toyc::obj::ObjectGenner objectGenner;
-    isOutputFile = objectGenner.generate(astContext.module, TMP_FILE_NAME);
+    isOutputFile = objectGenner.generate(astContext.module, TMP_FILE_NAME, astContext.options.libraryBuiltins);
     if (!isOutputFile) {
         std::cerr << "Failed to generate object file." << std::endl;
         return -1;
     }
 
     // generate executable file
-    std::string command = "gcc -o " + outputFileName + " " TMP_FILE_NAME " -lm";
+    std::string command = "gcc -o " + outputFileName + " " TMP_FILE_NAME;
+    if (nullptr != astContext.module.getFunction("__toyc_omp_parallel_for")) {
+        command += " " TOYC_RUNTIME_LIB " -pthread";
+    }
+    command += " -lm";
     int ret = system(command.c_str());
     if (ret == -1) {
         std::cerr << "Failed to generate executable file." << std::endl;
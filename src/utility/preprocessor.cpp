@@ -21,6 +21,14 @@ Preprocessor::Preprocessor() : currentLine_(0), hasErrors_(false) {
     addPredefinedMacro("__STDC__", "1");
     addPredefinedMacro("__STDC_VERSION__", "199901L");
 
+    // __atomic 內建函式的記憶體順序，與 GCC 相同
+    addPredefinedMacro("__ATOMIC_RELAXED", "0");
+    addPredefinedMacro("__ATOMIC_CONSUME", "1");
+    addPredefinedMacro("__ATOMIC_ACQUIRE", "2");
+    addPredefinedMacro("__ATOMIC_RELEASE", "3");
+    addPredefinedMacro("__ATOMIC_ACQ_REL", "4");
+    addPredefinedMacro("__ATOMIC_SEQ_CST", "5");
+
     // 添加標準包含路徑
     addIncludePath("/usr/include");
     addIncludePath("/usr/local/include");
@@ -118,6 +126,11 @@ std::string Preprocessor::processLine(const std::string& line, const std::string
                 handleUndef(directive, lineNumber);
             }
             return "";
+        } else if (starts_with(directive, "pragma")) {
+            if (shouldIncludeCode()) {
+                return handlePragma(directive, lineNumber);
+            }
+            return "";
         } else if (starts_with(directive, "ifdef")) {
             handleIfdef(directive, lineNumber);
             return "";
@@ -265,6 +278,24 @@ void Preprocessor::handleUndef(const std::string& line, int lineNumber) {
     macros_.erase(macroName);
 }
 
+std::string Preprocessor::handlePragma(const std::string& line, int lineNumber) {
+    std::vector<std::string> tokens = tokenize(line);
+    std::string first = tokens.size() > 1 ? tokens[1].substr(0, tokens[1].find('(')) : "";  // unroll(4)
+    std::string second = tokens.size() > 2 ? tokens[2] : "";
+    std::string third = tokens.size() > 3 ? tokens[3] : "";
+
+    // 迴圈提示與 omp parallel for 原樣交給編譯器，由語法分析器附加到其後的迴圈
+    bool isLoopHint = ("clang" == first && "loop" == second) || "unroll" == first || "nounroll" == first ||
+                      ("GCC" == first && ("unroll" == second || "ivdep" == second)) ||
+                      ("omp" == first && "parallel" == second && "for" == third);
+    if (isLoopHint) {
+        return "#" + expandMacros(line);
+    }
+
+    warning("Ignoring unsupported #" + line, lineNumber);
+    return "";
+}
+
 void Preprocessor::handleIfdef(const std::string& line, int lineNumber) {
     std::vector<std::string> tokens = tokenize(line);
 
@@ -0,0 +1,34 @@
+int printf(char *format, ...);
+
+int lookup(int i) {
+    int table[16] = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5, 8, 9, 7, 9, 3};
+    return table[i];
+}
+
+int main() {
+    int zeros[8] = {0};
+    int partial[6] = {7, 8};
+    int grid[2][3] = {{1, 2, 3}, {4, 5}};
+    char letters[4] = {'a', 'b'};
+    double weights[3] = {0.5, 1.5};
+
+    int sum = 0;
+    for (int i = 0; i < 16; i = i + 1) {
+        sum = sum + lookup(i);
+    }
+    printf("%d\n", sum);
+
+    for (int i = 0; i < 8; i = i + 1) {
+        sum = sum + zeros[i];
+    }
+    printf("%d %d %d %d\n", partial[0], partial[1], partial[2], partial[5]);
+    printf("%d %d %d\n", grid[0][2], grid[1][1], grid[1][2]);
+    printf("%c%c %d\n", letters[0], letters[1], letters[3]);
+    printf("%f %f %f\n", weights[0], weights[1], weights[2]);
+
+    // Runtime values mixed with zero-filled tail
+    int n = sum;
+    int mixed[5] = {n, n + 1};
+    printf("%d %d %d\n", mixed[0], mixed[1], mixed[4]);
+    return 0;
+}
@@ -0,0 +1,49 @@
+int printf(char *format, ...);
+
+int sumScratch(int n) {
+    int total = 0;
+    // Each iteration allocates a fresh VLA; without releasing it at scope exit
+    // the stack would grow by roughly 4KB per iteration and overflow.
+    for (int round = 0; round < 100000; round = round + 1) {
+        int scratch[n];
+        for (int i = 0; i < n; i = i + 1) {
+            scratch[i] = i + round;
+        }
+        total = total + scratch[n - 1] % 7;
+        if (round % 3 == 0) {
+            continue;
+        }
+        if (round == 99990) {
+            break;
+        }
+    }
+    return total;
+}
+
+int gotoOutOfScope(int n) {
+    int count = 0;
+again:
+    {
+        int buf[n];
+        int fixed = n;
+        buf[0] = fixed;
+        count = count + buf[0];
+        if (count < 300000) {
+            goto again;
+        }
+    }
+    return count;
+}
+
+int main() {
+    printf("%d\n", sumScratch(1000));
+    printf("%d\n", gotoOutOfScope(1000));
+
+    int x = 1;
+    {
+        int y = 2;
+        x = x + y;
+    }
+    printf("%d\n", x);
+    return 0;
+}
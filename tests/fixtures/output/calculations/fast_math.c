@@ -0,0 +1,37 @@
+// 浮點運算：乘加、歸約與倒數，供 -ffast-math / -ffp-contract 檢查
+int printf(char *format, ...);
+double sqrt(double x);
+
+double dot(double *a, double *b, int n) {
+    double sum = 0.0;
+    for (int i = 0; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+double axpy_tail(double a, double x, double y) { return a * x + y; }
+
+double residual(double a, double x, double y) { return y - a * x; }
+
+double halve(double x) { return x / 2.0; }
+
+float accumulate(float total, float a, float b) {
+    total += a * b;
+    return total;
+}
+
+int main() {
+    double a[8];
+    double b[8];
+    for (int i = 0; i < 8; i++) {
+        a[i] = i + 1;
+        b[i] = 0.5 * i;
+    }
+    printf("%.2f\n", dot(a, b, 8));
+    printf("%.2f %.2f\n", axpy_tail(2.0, 3.0, 4.0), residual(2.0, 3.0, 10.0));
+    printf("%.3f\n", halve(5.0));
+    printf("%.2f\n", accumulate(1.0f, 1.5f, 4.0f));
+    printf("%.3f\n", sqrt(2.25));
+    return 0;
+}
@@ -0,0 +1,27 @@
+int printf(char *format, ...);
+
+float scale(float x) {
+    return x * 0.5f + 0.25f;
+}
+
+int main() {
+    float values[4] = {1.0f, 2.5f, -3.75f, 1e3f};
+    float sum = 0.0f;
+    int i;
+    for (i = 0; i < 4; i++) {
+        sum = sum + scale(values[i]);
+    }
+    printf("%f\n", sum);
+
+    float third = 1.0f / 3.0f;
+    double wide = 1.0 / 3.0;
+    printf("%.10f %.10f\n", third, wide);
+
+    double longSuffix = 2.5L;
+    printf("%f\n", longSuffix * 2.0F);
+
+    char letter = 'A';
+    short count = 7;
+    printf("%c %d\n", letter, count);
+    return 0;
+}
@@ -0,0 +1,32 @@
+int printf(char *format, ...);
+
+long long scale(long long x) {
+    return x * 3LL;
+}
+
+int main() {
+    long big = 5000000000;
+    printf("%ld\n", big);
+
+    unsigned int mask = 0xFFFFFFFFu;
+    printf("%u\n", mask);
+
+    int permissions = 0755;
+    printf("%d %o\n", permissions, permissions);
+
+    unsigned long long shifted = 1ULL << 40;
+    printf("%llu\n", shifted);
+
+    long long product = scale(3000000000);
+    printf("%lld\n", product);
+
+    long hexWide = 0x100000000;
+    printf("%ld\n", hexWide + 0x7fffffffL);
+
+    signed long long negative = -9000000000LL;
+    printf("%lld\n", negative / 2);
+
+    printf("%d\n", 0x7fffffff > 0);
+    printf("%d\n", 2147483648 > 0);
+    return 0;
+}
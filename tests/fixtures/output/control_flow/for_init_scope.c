@@ -0,0 +1,29 @@
+// for 迴圈初始化子句宣告的變數只屬於該迴圈
+int printf(char *format, ...);
+
+int main() {
+    int i = 100;
+    int total = 0;
+    for (int i = 0; i < 3; i++) {
+        total += i;
+    }
+    for (int i = 10; i < 13; i++) {
+        total += i;
+    }
+    for (long i = 5; i > 0; i -= 2) {
+        total += (int)i;
+    }
+    for (int i = 0, j = 4; i < j; i++, j--) {
+        total += i * j;
+    }
+    printf("%d %d\n", i, total);
+
+    int loops = 0;
+    for (int k = 0; k < 2; k++) {
+        for (int k = 0; k < 3; k++) {
+            loops++;
+        }
+    }
+    printf("%d\n", loops);
+    return 0;
+}
@@ -0,0 +1,56 @@
+// 迴圈提示：unroll、vectorize、interleave 與 ivdep
+int printf(char *format, ...);
+
+float dot(float *a, float *b, int n) {
+    float sum = 0.0f;
+#pragma clang loop vectorize(enable) vectorize_width(8) interleave_count(2)
+    for (int i = 0; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+void scale(float *restrict out, float *in, int n, float factor) {
+#pragma GCC ivdep
+    for (int i = 0; i < n; i++) {
+        out[i] = in[i] * factor;
+    }
+    return;
+}
+
+int checksum(int *values, int n) {
+    int total = 0;
+    int i = 0;
+#pragma GCC unroll 4
+    while (i < n) {
+        total = total * 31 + values[i];
+        i++;
+    }
+    int rounds = 0;
+#pragma clang loop unroll(full)
+    for (int k = 0; k < 4; k++) {
+        rounds += k;
+    }
+#pragma unroll 1
+    do {
+        rounds++;
+    } while (rounds < 10);
+    return total + rounds;
+}
+
+int main() {
+    float a[16];
+    float b[16];
+    int values[10];
+    for (int i = 0; i < 16; i++) {
+        a[i] = i;
+        b[i] = 2.0f;
+    }
+    for (int j = 0; j < 10; j++) {
+        values[j] = j * 7 % 5;
+    }
+    scale(b, a, 16, 0.5f);
+    printf("%d\n", (int)dot(a, b, 16));
+    printf("%d\n", checksum(values, 10));
+    return 0;
+}
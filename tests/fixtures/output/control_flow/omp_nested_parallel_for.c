@@ -0,0 +1,39 @@
+// 巢狀 OpenMP parallel for：內層迴圈使用外層函式與外層迴圈的值
+int printf(char *format, ...);
+
+void fill_table(int *table, int rows, int cols, int scale) {
+#pragma omp parallel for
+    for (int r = 0; r < rows; r++) {
+        int base = r * cols;
+#pragma omp parallel for schedule(static, 2)
+        for (int c = 0; c < cols; c++) {
+            table[base + c] = (r + 1) * (c + 1) * scale;
+        }
+    }
+    return;
+}
+
+int main() {
+    int table[48];
+    long rowSums[6];
+    long total = 0;
+
+    fill_table(table, 6, 8, 3);
+
+#pragma omp parallel for
+    for (int r = 0; r < 6; r++) {
+        long sum = 0;
+#pragma omp parallel for reduction(+: sum)
+        for (int c = 7; c >= 0; c -= 2) {
+            sum += table[r * 8 + c];
+        }
+        rowSums[r] = sum;
+    }
+
+    for (int r = 0; r < 6; r++) {
+        printf("row %d: %ld\n", r, rowSums[r]);
+        total += rowSums[r];
+    }
+    printf("table[0]=%d table[47]=%d total=%ld\n", table[0], table[47], total);
+    return 0;
+}
@@ -0,0 +1,75 @@
+// OpenMP parallel for：static/dynamic 排程、private 與 reduction
+int printf(char *format, ...);
+
+long sum_squares(int *values, int n) {
+    long total = 0;
+#pragma omp parallel for reduction(+: total)
+    for (int i = 0; i < n; i++) {
+        total += (long)values[i] * values[i];
+    }
+    return total;
+}
+
+void saxpy(float a, float *x, float *y, int n) {
+#pragma omp parallel for schedule(static, 16)
+    for (int i = 0; i < n; i += 1) {
+        y[i] = a * x[i] + y[i];
+    }
+    return;
+}
+
+void stride_fill(int *values, int n) {
+#pragma omp parallel for
+    for (int i = 0; i < n; i = i + 3) {
+        values[i] = 1;
+    }
+#pragma omp parallel for
+    for (int i = 1; i < n; i = 3 + i) {
+        values[i] = 2;
+    }
+#pragma omp parallel for
+    for (int i = n - 1; i >= 2; i = i - 3) {
+        values[i] = 3;
+    }
+    return;
+}
+
+int main() {
+    int values[1000];
+    float x[100];
+    float y[100];
+    int triangle[64];
+    double weights = 0.0;
+    int scratch = 0;
+    int count = 0;
+
+    for (int j = 0; j < 1000; j++) {
+        values[j] = j % 97 - 40;
+    }
+    for (int t = 0; t < 100; t++) {
+        x[t] = t;
+        y[t] = 1.0f;
+    }
+    printf("%ld\n", sum_squares(values, 1000));
+    saxpy(0.5f, x, y, 100);
+    printf("%d %d\n", (int)y[0], (int)y[99]);
+    stride_fill(values, 10);
+    printf("%d %d %d %d\n", values[0], values[4], values[8], values[9]);
+
+#pragma omp parallel for schedule(dynamic, 4) private(scratch) reduction(+: weights, count)
+    for (int k = 63; k >= 0; k--) {
+        scratch = 0;
+        for (int m = 0; m <= k; m++) {
+            scratch += m;
+        }
+        triangle[k] = scratch;
+        weights += k * 0.5;
+        if (scratch % 2 == 0) {
+            continue;
+        }
+        count++;
+    }
+    printf("%d %d %d %d\n", triangle[0], triangle[10], triangle[63], count);
+    printf("%d\n", (int)weights);
+    return 0;
+}
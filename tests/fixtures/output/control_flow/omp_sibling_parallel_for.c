@@ -0,0 +1,21 @@
+// 同一區塊中的兩個 parallel for 迴圈重複使用迴圈變數 i
+int printf(char *format, ...);
+
+int main() {
+    int squares[32];
+    long total = 0;
+
+#pragma omp parallel for
+    for (int i = 0; i < 32; i++) {
+        squares[i] = i * i;
+    }
+#pragma omp parallel for reduction(+: total)
+    for (int i = 0; i < 32; i += 2) {
+        total += squares[i];
+    }
+    for (int i = 0; i < 32; i += 8) {
+        printf("squares[%d]=%d\n", i, squares[i]);
+    }
+    printf("total=%ld\n", total);
+    return 0;
+}
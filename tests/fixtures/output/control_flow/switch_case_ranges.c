@@ -0,0 +1,73 @@
+int printf(char *format, ...);
+
+int classify(char c) {
+    switch (c) {
+        case '0' ... '9':
+            return 1;
+        case 'a' ... 'z':
+        case 'A' ... 'Z':
+            return 2;
+        case ' ':
+            return 3;
+        default:
+            break;
+    }
+    return 0;
+}
+
+int bucket(long value) {
+    switch (value) {
+        case 0:
+            return 0;
+        case 1 ... 99:
+            return 1;
+        case 100 ... 99999:
+            return 2;
+        case 100000 ... 2000000000:
+            return 3;
+        case -1000 ... -1:
+            return -1;
+    }
+    return 9;
+}
+
+int high_bit(unsigned int value) {
+    switch (value) {
+        case 0:
+            return 0;
+        case 1u ... 0x7FFFFFF0u:
+            return 1;
+        case 0x7FFFFFF1u ... 0x80000010u:
+            return 2;
+        case 0x80000011u ... 0xFFFFFFFFu:
+            return 3;
+    }
+    return 9;
+}
+
+int dispatch(int op) {
+    int acc = 0;
+    switch (__builtin_expect(op, 2)) {
+        case 1:
+            acc = acc + 10;
+        case 2:
+            acc = acc + 20;
+            break;
+        case 3 + 1:
+            acc = 40;
+            break;
+        case 9 ... 7:
+            acc = 99;
+            break;
+    }
+    return acc;
+}
+
+int main() {
+    printf("%d %d %d %d %d\n", classify('5'), classify('q'), classify('Q'), classify(' '), classify('#'));
+    printf("%d %d %d %d %d %d\n", bucket(0), bucket(42), bucket(1234), bucket(1500000000), bucket(-7), bucket(-5000));
+    printf("%d %d %d %d %d\n", high_bit(0), high_bit(5), high_bit(0x80000000u), high_bit(0x80000011u),
+           high_bit(0xFFFFFFFFu));
+    printf("%d %d %d %d %d\n", dispatch(1), dispatch(2), dispatch(4), dispatch(8), dispatch(5));
+    return 0;
+}
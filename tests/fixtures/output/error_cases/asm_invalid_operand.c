@@ -0,0 +1,6 @@
+// 錯誤：內嵌組語引用了不存在的運算元
+int main() {
+    int value = 1;
+    asm("incl %1" : "+r"(value));
+    return value;
+}
@@ -0,0 +1,11 @@
+// 錯誤：_Atomic 只能用於整數、浮點數與指標
+struct pair {
+    int first;
+    int second;
+};
+
+_Atomic struct pair shared;
+
+int main() {
+    return 0;
+}
@@ -0,0 +1,11 @@
+// 錯誤：不能對位元欄位取位址
+struct Flags {
+    unsigned int ready : 1;
+    unsigned int mode : 3;
+};
+
+int main() {
+    struct Flags flags = {1, 2};
+    unsigned int *mode = &flags.mode;
+    return *mode;
+}
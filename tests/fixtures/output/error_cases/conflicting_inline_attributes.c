@@ -0,0 +1,7 @@
+__attribute__((noinline, always_inline)) int twice(int x) {
+    return x * 2;
+}
+
+int main() {
+    return twice(21);
+}
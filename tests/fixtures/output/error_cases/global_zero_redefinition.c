@@ -0,0 +1,7 @@
+// 錯誤：全域變數以零初始化後又再次定義
+int count = 0;
+int count = 5;
+
+int main() {
+    return count;
+}
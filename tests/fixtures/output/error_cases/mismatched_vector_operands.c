@@ -0,0 +1,9 @@
+typedef int v4i __attribute__((vector_size(16)));
+typedef float v4f __attribute__((vector_size(16)));
+
+int main() {
+    v4i counts = {1, 2, 3, 4};
+    v4f weights = {0.5f, 0.5f, 0.5f, 0.5f};
+    v4f total = counts + weights;
+    return (int)total[0];
+}
@@ -0,0 +1,9 @@
+int first(int *values, int alignment) {
+    int *aligned = __builtin_assume_aligned(values, alignment);
+    return aligned[0];
+}
+
+int main() {
+    int values[4] = {1, 2, 3, 4};
+    return first(values, 16);
+}
@@ -0,0 +1,21 @@
+// 錯誤：omp parallel for 的迴圈本體不能以 break 提前離開
+int find(int *values, int n, int key) {
+    int found = -1;
+#pragma omp parallel for
+    for (int i = 0; i < n; i++) {
+        if (values[i] == key) {
+            found = i;
+            break;
+        }
+    }
+    return found;
+}
+
+int main() {
+    int values[4];
+    values[0] = 3;
+    values[1] = 1;
+    values[2] = 4;
+    values[3] = 1;
+    return find(values, 4, 4);
+}
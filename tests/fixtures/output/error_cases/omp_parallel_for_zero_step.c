@@ -0,0 +1,12 @@
+// 錯誤：omp parallel for 的步長不能是常數 0
+int printf(char *format, ...);
+
+int main() {
+    int values[8];
+#pragma omp parallel for
+    for (int i = 0; i < 8; i += 0) {
+        values[i] = i;
+    }
+    printf("%d\n", values[0]);
+    return 0;
+}
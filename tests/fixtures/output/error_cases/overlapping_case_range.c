@@ -0,0 +1,14 @@
+// 錯誤：case 值落在另一個 case 範圍之內
+int grade(int score) {
+    switch (score) {
+        case 0 ... 100:
+            return 1;
+        case 50:
+            return 2;
+    }
+    return 0;
+}
+
+int main() {
+    return grade(50);
+}
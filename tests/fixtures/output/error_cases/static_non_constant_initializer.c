@@ -0,0 +1,8 @@
+int seed() {
+    return 42;
+}
+
+int main() {
+    static int cached = seed();
+    return cached;
+}
@@ -0,0 +1,14 @@
+// 錯誤：target_clones 缺少 default 版本
+__attribute__((target_clones("avx2", "sse4.2")))
+int sum(int *values, int n) {
+    int total = 0;
+    for (int i = 0; i < n; i++) {
+        total += values[i];
+    }
+    return total;
+}
+
+int main() {
+    int values[4] = {1, 2, 3, 4};
+    return sum(values, 4);
+}
@@ -0,0 +1,10 @@
+// 錯誤：區塊內的 _Thread_local 變數必須同時宣告為 static 或 extern
+int counter(void) {
+    _Thread_local int count;
+    count++;
+    return count;
+}
+
+int main() {
+    return counter();
+}
@@ -0,0 +1,53 @@
+int printf(char *format, ...);
+
+int calls;
+_Atomic int ready = 1;
+
+static int square(int x) {
+    return x * x;
+}
+
+static inline int sum(const int *values, int n) {
+    int total = 0;
+    int i;
+    for (i = 0; i < n; i++) {
+        total += values[i];
+    }
+    return total;
+}
+
+void record(void) {
+    calls++;
+    return;
+}
+
+int wait_ready(void) {
+    while (ready == 0) {
+    }
+    return ready;
+}
+
+int peek_calls(void) {
+    return __atomic_load_n(&calls, __ATOMIC_ACQUIRE);
+}
+
+int factorial(int n, int acc) {
+    if (n <= 1) {
+        return acc;
+    }
+    return factorial(n - 1, acc * n);
+}
+
+__inline static int twice(int x) {
+    return square(x) + square(x);
+}
+
+int main() {
+    int values[4] = {3, 1, 4, 1};
+    record();
+    record();
+    printf("%d %d\n", square(7), sum(values, 4));
+    printf("%d %d %d\n", factorial(6, 1), twice(3), calls);
+    printf("%d %d\n", wait_ready(), peek_calls());
+    return 0;
+}
@@ -0,0 +1,47 @@
+int printf(char *format, ...);
+
+int table[4] = {2, 3, 5, 7};
+
+int scaled(int x) __attribute__((const));
+int lookup(int i) __attribute__((__pure__));
+
+int scaled(int x) {
+    return x * 10;
+}
+
+int lookup(int i) {
+    return table[i & 3];
+}
+
+__attribute__((cold, noinline)) void report(int code) {
+    printf("error %d\n", code);
+    return;
+}
+
+static inline __attribute__((always_inline)) int clamp(int x, int lo, int hi) {
+    if (x < lo) {
+        return lo;
+    }
+    if (x > hi) {
+        return hi;
+    }
+    return x;
+}
+
+__attribute__((hot)) __attribute__((flatten)) int kernel(int n) {
+    int total = 0;
+    int i;
+    for (i = 0; i < n; i++) {
+        total += clamp(scaled(lookup(i)), 0, 60);
+    }
+    return total;
+}
+
+int main() {
+    int result = kernel(8);
+    if (result != 320) {
+        report(result);
+    }
+    printf("%d\n", result);
+    return 0;
+}
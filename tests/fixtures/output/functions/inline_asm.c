@@ -0,0 +1,84 @@
+// GNU 內嵌組語：輸出、輸入、綁定運算元與 clobber
+int printf(char *format, ...);
+
+struct flags {
+    unsigned ready : 1;
+    unsigned count : 7;
+};
+
+unsigned long read_cycles() {
+    unsigned int low;
+    unsigned int high;
+    __asm__ __volatile__("rdtsc" : "=a"(low), "=d"(high));
+    return ((unsigned long)high << 32) | low;
+}
+
+int popcount(unsigned int value) {
+    unsigned int bits;
+    asm("popcnt %1, %0" : "=r"(bits) : "rm"(value) : "cc");
+    return bits;
+}
+
+unsigned long multiply_high(unsigned long a, unsigned long b) {
+    unsigned long low;
+    unsigned long high;
+    asm("mulq %3" : "=a"(low), "=d"(high) : "a"(a), "rm"(b) : "cc");
+    return high;
+}
+
+int add_in_place(int total, int step) {
+    asm("addl %[step], %[total]" : [total] "+r"(total) : [step] "ri"(step));
+    return total;
+}
+
+unsigned int swap_bytes(unsigned int value) {
+    asm("bswap %k0" : "=r"(value) : "0"(value));
+    return value;
+}
+
+void store_twice(int *slot, int value) {
+    asm volatile("movl %1, %0\n\t"
+                 "addl %1, %0"
+                 : "=m"(*slot)
+                 : "r"(value)
+                 : "memory");
+    return;
+}
+
+int count_down(int n) {
+    int loops = 0;
+    while (n > 0) {
+        asm volatile("pause");
+        asm("decl %0" : "+rm"(n));
+        loops++;
+    }
+    return loops;
+}
+
+int main() {
+    unsigned long first = read_cycles();
+    unsigned long second = read_cycles();
+    printf("%d\n", second >= first);
+    printf("%d %d\n", popcount(255), popcount(0x80000001));
+    printf("%lu\n", multiply_high(0x100000000, 0x300000000));
+    printf("%d\n", add_in_place(40, 2));
+    printf("%x\n", swap_bytes(0x11223344));
+
+    int slot = 0;
+    store_twice(&slot, 21);
+    printf("%d\n", slot);
+    printf("%d\n", count_down(5));
+
+    struct flags f;
+    f.ready = 0;
+    f.count = 3;
+    asm("incl %k0" : "+r"(f.count));
+    asm("movl $1, %k0" : "=r"(f.ready));
+    printf("%d %d\n", f.ready, f.count);
+
+    int label_a = 0;
+    int label_b = 0;
+    asm("movl $%c2, %0\n%=:\n\tmovl %0, %1" : "=r"(label_a), "=r"(label_b) : "i"(7));
+    printf("%d %d\n", label_a, label_b);
+    return 0;
+}
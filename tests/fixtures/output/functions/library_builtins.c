@@ -0,0 +1,36 @@
+// libc/libm 呼叫轉為 LLVM intrinsic
+int printf(char *format, ...);
+double sqrt(double x);
+double fabs(double x);
+double floor(double x);
+double fmin(double x, double y);
+double fmax(double x, double y);
+float sqrtf(float x);
+
+struct Pair {
+    int first;
+    int second;
+};
+
+double magnitude(double x) {
+    return fabs(x);
+}
+
+int main() {
+    struct Pair source = {3, 4};
+    struct Pair copy;
+    int digits[6] = {1, 2, 3, 4, 5, 6};
+    char buffer[8];
+
+    memcpy(&copy, &source, sizeof(struct Pair));
+    memmove(&digits[1], &digits[0], 4 * sizeof(int));
+    memset(buffer, 'x', 7);
+    buffer[7] = 0;
+
+    // The reference gcc build does not link libm, so libm functions only see constants it can fold
+    printf("%d %d %s\n", copy.first + copy.second, digits[1] + digits[4], buffer);
+    printf("%.1f %.1f %.1f\n", sqrt(25.0), magnitude(-2.5), floor(5.75));
+    printf("%.1f %.1f %.1f\n", fmin(5.0, 1.5), fmax(5.0, 1.5), __builtin_sqrt(16.0));
+    printf("%.1f\n", (double)sqrtf(2.25f));
+    return 0;
+}
@@ -0,0 +1,35 @@
+// 分支預測與最佳化提示 builtin
+int printf(char *format, ...);
+
+int sum_positive(int *values, int count) {
+    int *aligned = __builtin_assume_aligned(values, 16);
+    int total = 0;
+    for (int i = 0; i < count; i++) {
+        __builtin_prefetch(&aligned[i + 8]);
+        if (__builtin_expect(aligned[i] < 0, 0)) {
+            continue;
+        }
+        total += aligned[i];
+    }
+    return total;
+}
+
+int classify(int kind) {
+    switch (kind) {
+        case 0:
+            return 10;
+        case 1:
+            return 20;
+        default:
+            __builtin_unreachable();
+    }
+}
+
+int main() {
+    int values[16] __attribute__((aligned(16))) = {1, -2, 3, 4, -5, 6, 7, 8};
+    __builtin_prefetch(values, 1, 0);
+    long hint = __builtin_expect(values[0], 1);
+    printf("%d %d\n", sum_positive(values, 8), (int)hint);
+    printf("%d %d\n", classify(0), classify(1));
+    return 0;
+}
@@ -0,0 +1,55 @@
+// 函式多版本：target_clones 與 ifunc 執行期分派
+int printf(char *format, ...);
+
+__attribute__((target_clones("avx512f", "avx2", "default")))
+int dot(int *a, int *b, int n) {
+    int sum = 0;
+    for (int i = 0; i < n; i++) {
+        sum += a[i] * b[i];
+    }
+    return sum;
+}
+
+__attribute__((target_clones("default,sse4.2,popcnt")))
+static int factorial(int n) {
+    if (n <= 1) {
+        return 1;
+    }
+    return n * factorial(n - 1);
+}
+
+__attribute__((target("avx2,fma")))
+void scale(float *values, int n, float factor) {
+    for (int i = 0; i < n; i++) {
+        values[i] = values[i] * factor;
+    }
+    return;
+}
+
+int main() {
+    int a[64];
+    int b[64];
+    float f[8];
+    for (int i = 0; i < 64; i++) {
+        a[i] = i;
+        b[i] = 64 - i;
+    }
+    printf("%d\n", dot(a, b, 64));
+    printf("%d\n", factorial(10));
+
+    // 只在支援 AVX2 的 CPU 上呼叫 target("avx2") 函式
+    for (int j = 0; j < 8; j++) {
+        f[j] = j;
+    }
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) {
+        scale(f, 8, 2.0f);
+    } else {
+        for (int i = 0; i < 8; i++) {
+            f[i] = f[i] * 2.0f;
+        }
+    }
+    printf("%d\n", (int)f[7]);
+    printf("%d\n", __builtin_cpu_supports("sse2") != 0);
+    return 0;
+}
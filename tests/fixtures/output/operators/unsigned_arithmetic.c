@@ -0,0 +1,54 @@
+int printf(char *format, ...);
+
+unsigned int hash(unsigned int h, int c) {
+    h = h * 31 + c;
+    return h ^ (h >> 7);
+}
+
+int main() {
+    unsigned int big = 0;
+    big = big - 1;
+    printf("%u\n", big);
+    printf("%u %u\n", big / 16, big % 1000);
+    printf("%u\n", big >> 28);
+
+    int negative = -64;
+    printf("%d %d\n", negative >> 3, negative / 8);
+
+    unsigned int one = 1;
+    if (big > one) {
+        printf("unsigned compare\n");
+    }
+    if (negative < 0 && negative < one) {
+        printf("mixed compare\n");
+    } else {
+        printf("converted compare\n");
+    }
+
+    unsigned char byte = 250;
+    byte = byte + 10;
+    int widened = byte;
+    printf("%d\n", widened);
+
+    unsigned short half = 65535;
+    int sum = half + 1;
+    printf("%d\n", sum);
+
+    signed char small = -3;
+    unsigned long wide = big;
+    wide = wide * 3;
+    long mixed = small;
+    printf("%ld %lu\n", mixed, wide / 2);
+
+    unsigned h = 7;
+    int i;
+    for (i = 0; i < 5; i++) {
+        h = hash(h, i);
+    }
+    printf("%u\n", h);
+
+    double d = big;
+    unsigned int back = d / 2.0;
+    printf("%u\n", back);
+    return 0;
+}
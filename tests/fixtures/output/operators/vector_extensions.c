@@ -0,0 +1,46 @@
+// GCC 向量擴充型別：逐通道運算
+int printf(char *format, ...);
+
+typedef float v8f __attribute__((vector_size(32)));
+typedef int v4i __attribute__((vector_size(16)));
+typedef float v4f __attribute__((vector_size(16)));
+typedef int lane_t;
+
+v4f scale = {0.5f, 1.0f, 2.0f, 4.0f};
+
+v4f axpy(float a, v4f x, v4f y) {
+    return a * x + y;
+}
+
+int main() {
+    v8f x = {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f};
+    v8f y = {0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f, 0.5f};
+    v8f r = 2.0f * x + y;
+    r[3] = 100.0f;
+    r[4] += 1.0f;
+    float sum = 0.0f;
+    for (int i = 0; i < 8; i++) {
+        sum += r[i];
+    }
+    printf("%d\n", (int)sum);
+
+    v4i a = {1, -2, 3, -4};
+    v4i b = {4, 3, 2, 1};
+    v4i m = a < b;
+    v4i c = (a & m) | (b & ~m);
+    c = c * 3 - 1;
+    c = -c;
+    v4i d = {7};
+    d += a;
+    printf("%d %d %d %d\n", m[0], m[1], m[2], m[3]);
+    printf("%d %d %d %d\n", c[0], c[1], c[2], c[3]);
+    printf("%d %d %d %d\n", d[0], d[1], d[2], d[3]);
+    v4f zero = {0.0f};
+    v4f doubled = axpy(2.0f, scale, zero);
+    v4i big = doubled > 1.5f;
+    lane_t lanes = big[0] + big[1] + big[2] + big[3];
+    v4i bits = (v4i)scale;
+    printf("%d %d %d\n", lanes, bits[1], (int)doubled[3]);
+    printf("%d %d\n", (int)sizeof(v8f), (int)sizeof(a));
+    return 0;
+}
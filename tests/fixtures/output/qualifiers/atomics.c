@@ -0,0 +1,76 @@
+// _Atomic 物件與 __atomic/__sync 內建函式
+int printf(char *format, ...);
+
+_Atomic int counter = 0;
+_Atomic long total;
+
+int spin(int *lock) {
+    int spins = 0;
+    while (__sync_lock_test_and_set(lock, 1)) {
+        spins++;
+    }
+    return spins;
+}
+
+int main() {
+    _Atomic(unsigned char) small = 250;
+    int plain = 10;
+    int expected = 10;
+    int lock = 0;
+    int old = 0;
+    int updated = 0;
+    long *_Atomic cursor = 0;
+    _Atomic int half = -1;
+
+    counter++;
+    ++counter;
+    counter--;
+    counter += 5;
+    counter |= 8;
+    counter *= 3;
+    total = counter;
+    total -= 2;
+    total /= 4;
+    small += 10;
+    printf("%d %ld %d\n", counter, total, small);
+    old = counter++;
+    updated = --counter;
+    printf("%d %d\n", old, updated);
+    half += 0.5;
+    printf("%d\n", half);
+    half -= 2.75;
+    printf("%d\n", half);
+
+    __atomic_store_n(&plain, 20, __ATOMIC_RELEASE);
+    printf("%d\n", __atomic_load_n(&plain, __ATOMIC_ACQUIRE));
+    old = __atomic_fetch_add(&plain, 5, __ATOMIC_RELAXED);
+    printf("%d %d\n", old, plain);
+    updated = __atomic_sub_fetch(&plain, 3, __ATOMIC_SEQ_CST);
+    printf("%d %d\n", updated, plain);
+    old = __atomic_fetch_nand(&plain, 6, __ATOMIC_ACQ_REL);
+    printf("%d %d\n", old, plain);
+    printf("%d\n", __atomic_exchange_n(&plain, 7, __ATOMIC_SEQ_CST));
+
+    old = __atomic_compare_exchange_n(&plain, &expected, 1, 0, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED);
+    printf("%d %d %d\n", old, expected, plain);
+    old = __atomic_compare_exchange_n(&plain, &expected, 1, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+    printf("%d %d %d\n", old, expected, plain);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    __atomic_signal_fence(__ATOMIC_ACQUIRE);
+    __atomic_thread_fence(__ATOMIC_RELAXED);
+
+    old = __sync_fetch_and_or(&plain, 12);
+    updated = __sync_and_and_fetch(&plain, 6);
+    printf("%d %d\n", old, updated);
+    old = __sync_bool_compare_and_swap(&plain, 4, 9);
+    updated = __sync_val_compare_and_swap(&plain, 3, 0);
+    printf("%d %d %d\n", old, updated, plain);
+    __sync_synchronize();
+    printf("%d\n", spin(&lock));
+    __sync_lock_release(&lock);
+    printf("%d\n", lock);
+
+    cursor = &total;
+    printf("%ld\n", *cursor);
+    return 0;
+}
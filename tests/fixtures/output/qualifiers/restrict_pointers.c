@@ -0,0 +1,52 @@
+int printf(char *format, ...);
+
+void axpy(int n, double a, double *restrict x, double *__restrict y) {
+    int i;
+    for (i = 0; i < n; i = i + 1) {
+        y[i] = a * x[i] + y[i];
+    }
+    return;
+}
+
+int sum_into(int *__restrict__ out, int *restrict in, int n) {
+    int i;
+    for (i = 0; i < n; i = i + 1) {
+        *out = *out + in[i];
+    }
+    return *out;
+}
+
+// b is based on a, so both reach the same object
+int bump_through_copy(int *restrict a) {
+    int before = *a;
+    {
+        int *restrict b = a;
+        *b = *b + 10;
+    }
+    return *a - before;
+}
+
+int main() {
+    double x[4] = {1.0, 2.0, 3.0, 4.0};
+    double y[4] = {0.5, 0.5, 0.5, 0.5};
+    int values[5] = {3, 1, 4, 1, 5};
+    int total = 0;
+
+    axpy(4, 2.0, x, y);
+    printf("%f %f %f %f\n", y[0], y[1], y[2], y[3]);
+
+    double *restrict src = x;
+    double *restrict dst = y;
+    int i;
+    for (i = 0; i < 4; i = i + 1) {
+        dst[i] = src[i] * 3.0;
+    }
+    printf("%f %f\n", y[0], y[3]);
+
+    int *const restrict cursor = &values[2];
+    *cursor = 9;
+    printf("%d %d\n", sum_into(&total, values, 5), values[2]);
+    int bumped = bump_through_copy(&values[0]);
+    printf("%d %d\n", bumped, values[0]);
+    return 0;
+}
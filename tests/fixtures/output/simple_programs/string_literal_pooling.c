@@ -0,0 +1,17 @@
+int printf(char *format, ...);
+
+int main() {
+    char *newline = "\n";
+    char *empty = "";
+    char *greeting = "world";
+    char *full = "hello world";
+
+    printf("%d\n", 1);
+    printf("value %d\n", 2);
+    printf("%d\n", 3);
+    printf("%s%s", empty, newline);
+    printf("%s\n", greeting);
+    printf("%s\n", full);
+    printf("value %d\n", 4);
+    return 0;
+}
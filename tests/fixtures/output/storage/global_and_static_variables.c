@@ -0,0 +1,77 @@
+int printf(char *format, ...);
+
+struct Point {
+    int x;
+    int y;
+};
+
+extern int total;
+int total = 100;
+int uninitialized;
+static int hidden = 7;
+const int primes[8] = {2, 3, 5, 7, 11, 13, 17, 19};
+double scale = 1.5;
+int history[4];
+struct Point origin = {3, 4};
+int *cursor = &total;
+
+int nextId() {
+    static int counter = 0;
+    counter = counter + 1;
+    return counter;
+}
+
+int otherCounter() {
+    static int counter = 10;
+    counter = counter + 10;
+    return counter;
+}
+
+int lookupSquare(int i) {
+    static const int squares[6] = {0, 1, 4, 9, 16, 25};
+    return squares[i];
+}
+
+int readLate() {
+    extern int late;
+    return late;
+}
+
+int bumpTotal() {
+    extern int total;
+    total = total + 1;
+    return total;
+}
+
+int late = 42;
+
+void record(int i, int value) {
+    history[i] = value;
+    total = total + value;
+    return;
+}
+
+int main() {
+    nextId();
+    nextId();
+    otherCounter();
+    printf("%d %d\n", nextId(), otherCounter());
+
+    int sum = 0;
+    for (int i = 0; i < 8; i = i + 1) {
+        sum = sum + primes[i];
+    }
+    printf("%d %d\n", sum, lookupSquare(5));
+
+    record(0, 5);
+    record(3, 9);
+    printf("%d %d %d %d\n", total, history[0], history[1], history[3]);
+
+    uninitialized = uninitialized + hidden;
+    total = *cursor + 1;
+    printf("%d %d %f\n", uninitialized, total, scale * 2);
+    printf("%d %d\n", origin.x, origin.y);
+    sum = bumpTotal();
+    printf("%d %d %d\n", readLate(), sum, total);
+    return 0;
+}
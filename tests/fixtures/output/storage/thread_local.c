@@ -0,0 +1,29 @@
+// 執行緒區域儲存：_Thread_local 與 __thread 變數
+int printf(char *format, ...);
+
+_Thread_local int calls;
+__thread long scratch[4] = {1, 2, 3, 4};
+static _Thread_local double weight = 0.5;
+extern __thread int calls;
+__thread int fast __attribute__((tls_model("local-exec")));
+
+int next_id(void) {
+    static _Thread_local int id = 100;
+    calls++;
+    return id++;
+}
+
+int main() {
+    int first = next_id();
+    int second = next_id();
+    long sum = 0;
+    for (int i = 0; i < 4; i++) {
+        scratch[i] *= 10;
+        sum += scratch[i];
+    }
+    fast = 7;
+    weight *= 4;
+    printf("%d %d %d\n", first, second, calls);
+    printf("%ld %d %d\n", sum, fast, (int)weight);
+    return 0;
+}
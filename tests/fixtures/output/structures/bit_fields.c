@@ -0,0 +1,82 @@
+// 位元欄位：配置、符號延伸、複合指定與初始化
+int printf(char *format, ...);
+
+struct Flags {
+    unsigned int ready : 1;
+    unsigned int mode : 3;
+    int delta : 5;
+    unsigned int : 0;
+    unsigned int count : 12;
+    char tag;
+    long wide : 40;
+};
+
+struct Narrow {
+    char c;
+    int b : 8;
+};
+
+struct Straddle {
+    char c;
+    int b : 30;
+    char d;
+};
+
+struct Gap {
+    char x;
+    int : 3;
+    char y;
+};
+
+struct __attribute__((packed)) Wire {
+    char c;
+    int b : 31;
+    char d;
+};
+
+struct Halves {
+    long a : 33;
+    long b : 33;
+};
+
+struct Flags globalFlags = {1, 5, -3, 100, 'x', -12345678901};
+
+int main() {
+    struct Flags flags = {0, 2, 7};
+    struct Flags *view = &flags;
+    struct Wire wire = {1, -1000000, 3};
+    struct Halves halves = {-1, 4294967296};
+
+    printf("%d %d %d\n", (int)sizeof(struct Flags), (int)sizeof(struct Narrow), (int)sizeof(struct Straddle));
+    printf("%d %d %d\n", (int)sizeof(struct Gap), (int)sizeof(struct Wire), (int)sizeof(struct Halves));
+    printf("%d %d %d %d\n", flags.ready, flags.mode, flags.delta, flags.count);
+
+    flags.ready = 1;
+    flags.mode = 9;
+    flags.delta = -16;
+    flags.count = 4095;
+    flags.tag = 'q';
+    flags.wide = -5;
+    printf("%d %d %d %d %c %ld\n", flags.ready, flags.mode, flags.delta, flags.count, flags.tag, flags.wide);
+
+    flags.delta++;
+    flags.mode += 6;
+    flags.count--;
+    int old = flags.delta--;
+    printf("%d %d %d %d\n", flags.delta, flags.mode, flags.count, old);
+
+    int stored = (flags.mode = 15);
+    flags.delta = 15;
+    flags.delta += 1;
+    printf("%d %d\n", stored, flags.delta);
+
+    view->mode = 3;
+    printf("%d\n", view->mode + view->ready);
+    printf("%d %d %d %d %c %ld\n", globalFlags.ready, globalFlags.mode, globalFlags.delta, globalFlags.count,
+           globalFlags.tag, globalFlags.wide);
+
+    wire.b = 123456789;
+    printf("%d %d %d\n", wire.c, wire.b, wire.d);
+    printf("%ld %ld\n", halves.a, halves.b);
+    return 0;
+}
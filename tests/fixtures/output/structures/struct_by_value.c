@@ -0,0 +1,95 @@
+// struct 傳值與返回：小 struct 走暫存器，大 struct 走 byval/sret，struct 賦值用 memcpy
+int printf(char *format, ...);
+
+struct Pair {
+    int a;
+    int b;
+};
+
+struct Mixed {
+    int count;
+    double scale;
+};
+
+struct Floats {
+    float x;
+    float y;
+    float z;
+};
+
+struct Matrix {
+    long cells[6];
+};
+
+struct Pair swap(struct Pair p) {
+    struct Pair result;
+    result.a = p.b;
+    result.b = p.a;
+    return result;
+}
+
+double apply(struct Mixed m, struct Floats f) {
+    return m.count * m.scale + f.x + f.y + f.z;
+}
+
+struct Floats scaleFloats(struct Floats f, float k) {
+    f.x = f.x * k;
+    f.y = f.y * k;
+    f.z = f.z * k;
+    return f;
+}
+
+// 被呼叫端修改的是自己的副本
+long trace(struct Matrix m) {
+    long sum = 0;
+    for (int i = 0; i < 6; i++) {
+        sum += m.cells[i];
+        m.cells[i] = 0;
+    }
+    return sum;
+}
+
+struct Matrix identity(long k) {
+    struct Matrix m;
+    for (int i = 0; i < 6; i++) {
+        m.cells[i] = i * k;
+    }
+    return m;
+}
+
+// 整數暫存器用完之後，剩下的 struct 改放在堆疊上
+long spill(long a, long b, long c, long d, long e, struct Pair p, struct Pair q) {
+    return a + b + c + d + e + p.a * 10 + p.b * 100 + q.a * 1000 + q.b * 10000;
+}
+
+int main() {
+    struct Pair p;
+    p.a = 1;
+    p.b = 2;
+    struct Pair s = swap(p);
+    printf("swap: %d %d\n", s.a, s.b);
+
+    struct Mixed m;
+    m.count = 3;
+    m.scale = 1.5;
+    struct Floats f;
+    f.x = 1.0f;
+    f.y = 2.0f;
+    f.z = 4.0f;
+    printf("apply: %.2f\n", apply(m, f));
+    struct Floats g = scaleFloats(f, 0.5f);
+    printf("scale: %.2f %.2f %.2f (%.2f)\n", g.x, g.y, g.z, f.x);
+
+    struct Matrix id = identity(3);
+    printf("trace: %ld %ld\n", trace(id), id.cells[5]);
+    printf("nested: %ld\n", trace(identity(2)));
+
+    struct Matrix copy;
+    copy = id;
+    copy.cells[0] = 100;
+    printf("copy: %ld %ld %ld\n", copy.cells[0], copy.cells[4], id.cells[0]);
+
+    printf("spill: %ld\n", spill(1, 2, 3, 4, 5, p, swap(p)));
+    printf("member: %d\n", swap(s).b);
+    return 0;
+}
@@ -0,0 +1,29 @@
+struct Point {
+    int x;
+    int y;
+};
+
+struct Record {
+    int id;
+    double score;
+    char tag;
+};
+
+int printf(char *format, ...);
+
+int main() {
+    struct Point origin = {0};
+    struct Point p = {3, 4};
+    struct Record r = {7, 2.5};
+    struct Point partial = {9};
+
+    int base = p.x + p.y;
+    struct Point q = {base, base * 2};
+
+    printf("%d %d\n", origin.x, origin.y);
+    printf("%d %d\n", p.x, p.y);
+    printf("%d %f %d\n", r.id, r.score, r.tag);
+    printf("%d %d\n", partial.x, partial.y);
+    printf("%d %d\n", q.x, q.y);
+    return 0;
+}
@@ -0,0 +1,37 @@
+// packed 與 aligned 屬性對 struct 配置的影響
+struct Wire {
+    char tag;
+    int length;
+    short port;
+} __attribute__((packed));
+
+struct __attribute__((aligned(64))) Counter {
+    long hits;
+};
+
+struct Record {
+    char kind;
+    int value __attribute__((aligned(8)));
+    char flag;
+};
+
+int printf(char *format, ...);
+
+int samples[4] __attribute__((aligned(64)));
+
+int main() {
+    struct Wire wire = {'w', 1500, 8080};
+    struct Counter counters[2];
+    struct Record record = {'r', 7, 1};
+
+    counters[0].hits = 3;
+    counters[1].hits = 4;
+    wire.length = wire.length + 1;
+    samples[1] = wire.port;
+
+    printf("%d %d %d\n", sizeof(struct Wire), sizeof(struct Counter), sizeof(struct Record));
+    printf("%d %d %d\n", wire.tag, wire.length, samples[1]);
+    printf("%d %d\n", sizeof(counters), (int)(counters[0].hits + counters[1].hits));
+    printf("%d %d %d\n", record.kind, record.value, record.flag);
+    return 0;
+}
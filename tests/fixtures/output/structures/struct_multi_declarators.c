@@ -0,0 +1,38 @@
+// 同一成員宣告中的多個宣告子（含位元欄位）
+int printf(char *format, ...);
+
+struct Point3 {
+    int x, y, z;
+};
+
+struct Mixed {
+    char tag;
+    long a, *p, b;
+    unsigned ready : 1, busy : 1, error : 1, code : 5;
+    int last;
+};
+
+int main() {
+    struct Point3 pt;
+    struct Mixed m;
+    long target = 7;
+
+    pt.x = 1;
+    pt.y = 2;
+    pt.z = 3;
+    printf("sizeof(Point3)=%d sum=%d\n", (int)sizeof(struct Point3), pt.x + pt.y + pt.z);
+
+    m.tag = 'm';
+    m.a = 10;
+    m.p = &target;
+    m.b = 20;
+    m.ready = 1;
+    m.busy = 0;
+    m.error = 1;
+    m.code = 21;
+    m.last = 99;
+    printf("sizeof(Mixed)=%d\n", (int)sizeof(struct Mixed));
+    printf("a=%ld *p=%ld b=%ld last=%d\n", m.a, *m.p, m.b, m.last);
+    printf("ready=%u busy=%u error=%u code=%u\n", m.ready, m.busy, m.error, m.code);
+    return 0;
+}
@@ -0,0 +1,42 @@
+int printf(char *format, ...);
+
+struct Sample {
+    int count;
+    double total;
+};
+
+struct Counter {
+    int id;
+    long hits;
+};
+
+void accumulate(struct Sample *sample, int *counts, double *values, int n) {
+    int i;
+    for (i = 0; i < n; i = i + 1) {
+        sample->total = sample->total + values[i];
+        sample->count = sample->count + counts[i];
+    }
+    return;
+}
+
+int main() {
+    struct Sample sample;
+    int counts[3] = {1, 2, 3};
+    double values[3] = {0.5, 1.5, 2.5};
+
+    sample.count = 0;
+    sample.total = 0.0;
+    accumulate(&sample, counts, values, 3);
+    printf("%d %f\n", sample.count, sample.total);
+
+    struct Sample *alias = &sample;
+    alias->count = alias->count * 2;
+    printf("%d\n", sample.count);
+
+    struct Counter counter;
+    counter.id = 7;
+    counter.hits = 40;
+    counter.hits = counter.hits + counter.id;
+    printf("%d %ld\n", counter.id, counter.hits);
+    return 0;
+}
@@ -0,0 +1,55 @@
+// union：大小、對齊、成員重疊與初始化
+int printf(char *format, ...);
+
+union Value {
+    int i;
+    float f;
+    unsigned char bytes[4];
+    double d;
+};
+
+union Small {
+    char c;
+    short s;
+};
+
+union Name {
+    char text[5];
+    int code;
+};
+
+union Bits {
+    int low : 3;
+    char c;
+};
+
+struct Packet {
+    char kind;
+    union Value payload;
+    int seq : 7;
+};
+
+union Value globalValue = {0x41424344};
+
+int main() {
+    union Value value;
+    union Bits bits;
+    struct Packet packet = {'k', {7}, -2};
+
+    printf("%d %d %d\n", (int)sizeof(union Value), (int)sizeof(union Small), (int)sizeof(union Name));
+    printf("%d %d\n", (int)sizeof(union Bits), (int)sizeof(struct Packet));
+
+    value.f = 1.0f;
+    printf("%x\n", value.i);
+    value.d = 0.0;
+    value.bytes[3] = 0x40;
+    printf("%x\n", value.i);
+    printf("%d %d\n", globalValue.bytes[0], globalValue.bytes[3]);
+
+    bits.c = 0x7d;
+    printf("%d\n", bits.low);
+
+    packet.payload.f = 2.5f;
+    printf("%c %x %d\n", packet.kind, packet.payload.i, packet.seq);
+    return 0;
+}
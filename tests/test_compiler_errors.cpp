@@ -131,6 +131,163 @@ TEST_F(CompilerErrorTest, ConstIntIncrement) {
         << "Error output should mention const or increment. Got: " << errorOutput;
 }
 
+TEST_F(CompilerErrorTest, StaticNonConstantInitializer) {
+    std::string inputFile = "tests/fixtures/output/error_cases/static_non_constant_initializer.c";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+
+    auto [exitCode, errorOutput] = compileWithOutput(inputFile);
+
+    EXPECT_NE(exitCode, 0) << "Compiler should reject a static local initialized by a function call";
+    EXPECT_TRUE(errorOutput.find("compile-time constant") != std::string::npos)
+        << "Error output should mention the non-constant initializer. Got: " << errorOutput;
+}
+
+TEST_F(CompilerErrorTest, ConflictingInlineAttributes) {
+    std::string inputFile = "tests/fixtures/output/error_cases/conflicting_inline_attributes.c";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+
+    auto [exitCode, errorOutput] = compileWithOutput(inputFile);
+
+    EXPECT_NE(exitCode, 0) << "Compiler should reject a function that is both noinline and always_inline";
+    EXPECT_TRUE(errorOutput.find("mutually exclusive") != std::string::npos)
+        << "Error output should name the conflicting attributes. Got: " << errorOutput;
+}
+
+TEST_F(CompilerErrorTest, NonConstantBuiltinAlignment) {
+    std::string inputFile = "tests/fixtures/output/error_cases/non_constant_builtin_alignment.c";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+
+    auto [exitCode, errorOutput] = compileWithOutput(inputFile);
+
+    EXPECT_NE(exitCode, 0) << "Compiler should reject an alignment that is not a constant";
+    EXPECT_TRUE(errorOutput.find("must be a constant power of two") != std::string::npos)
+        << "Error output should explain the alignment requirement. Got: " << errorOutput;
+}
+
+TEST_F(CompilerErrorTest, MismatchedVectorOperands) {
+    std::string inputFile = "tests/fixtures/output/error_cases/mismatched_vector_operands.c";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+
+    auto [exitCode, errorOutput] = compileWithOutput(inputFile);
+
+    EXPECT_NE(exitCode, 0) << "Compiler should reject vector operands of different types";
+    EXPECT_TRUE(errorOutput.find("must have the same type") != std::string::npos)
+        << "Error output should name the vector type mismatch. Got: " << errorOutput;
+}
+
+TEST_F(CompilerErrorTest, BreakInParallelFor) {
+    std::string inputFile = "tests/fixtures/output/error_cases/omp_parallel_for_break.c";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+
+    auto [exitCode, errorOutput] = compileWithOutput(inputFile);
+
+    EXPECT_NE(exitCode, 0) << "Compiler should reject break out of an omp parallel for body";
+    EXPECT_TRUE(errorOutput.find("Break statement not supported") != std::string::npos)
+        << "Error output should reject the break. Got: " << errorOutput;
+}
+
+TEST_F(CompilerErrorTest, ZeroStepParallelFor) {
+    std::string inputFile = "tests/fixtures/output/error_cases/omp_parallel_for_zero_step.c";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+
+    auto [exitCode, errorOutput] = compileWithOutput(inputFile);
+
+    EXPECT_NE(exitCode, 0) << "Compiler should reject an omp parallel for whose step is 0";
+    EXPECT_TRUE(errorOutput.find("needs a nonzero step") != std::string::npos)
+        << "Error output should name the zero step. Got: " << errorOutput;
+}
+
+TEST_F(CompilerErrorTest, AtomicStruct) {
+    std::string inputFile = "tests/fixtures/output/error_cases/atomic_struct.c";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+
+    auto [exitCode, errorOutput] = compileWithOutput(inputFile);
+
+    EXPECT_NE(exitCode, 0) << "Compiler should reject an _Atomic struct";
+    EXPECT_TRUE(errorOutput.find("_Atomic is only supported on") != std::string::npos)
+        << "Error output should name the _Atomic restriction. Got: " << errorOutput;
+}
+
+TEST_F(CompilerErrorTest, AutomaticThreadLocal) {
+    std::string inputFile = "tests/fixtures/output/error_cases/thread_local_automatic.c";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+
+    auto [exitCode, errorOutput] = compileWithOutput(inputFile);
+
+    EXPECT_NE(exitCode, 0) << "Compiler should reject a block-scope _Thread_local without static or extern";
+    EXPECT_TRUE(errorOutput.find("must be static or extern: count") != std::string::npos)
+        << "Error output should name the variable. Got: " << errorOutput;
+}
+
+TEST_F(CompilerErrorTest, BitFieldAddress) {
+    std::string inputFile = "tests/fixtures/output/error_cases/bit_field_address.c";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+
+    auto [exitCode, errorOutput] = compileWithOutput(inputFile);
+
+    EXPECT_NE(exitCode, 0) << "Compiler should reject taking the address of a bit-field";
+    EXPECT_TRUE(errorOutput.find("address of a bit-field") != std::string::npos)
+        << "Error output should name the bit-field. Got: " << errorOutput;
+}
+
+TEST_F(CompilerErrorTest, AsmInvalidOperand) {
+    std::string inputFile = "tests/fixtures/output/error_cases/asm_invalid_operand.c";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+
+    auto [exitCode, errorOutput] = compileWithOutput(inputFile);
+
+    EXPECT_NE(exitCode, 0) << "Compiler should reject an asm template naming a missing operand";
+    EXPECT_TRUE(errorOutput.find("Invalid operand number 1 in asm template") != std::string::npos)
+        << "Error output should name the operand. Got: " << errorOutput;
+}
+
+TEST_F(CompilerErrorTest, TargetClonesWithoutDefault) {
+    std::string inputFile = "tests/fixtures/output/error_cases/target_clones_without_default.c";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+
+    auto [exitCode, errorOutput] = compileWithOutput(inputFile);
+
+    EXPECT_NE(exitCode, 0) << "Compiler should reject target_clones without a 'default' version";
+    EXPECT_TRUE(errorOutput.find("target_clones needs a 'default' version") != std::string::npos)
+        << "Error output should ask for the default version. Got: " << errorOutput;
+}
+
+TEST_F(CompilerErrorTest, GlobalZeroRedefinition) {
+    std::string inputFile = "tests/fixtures/output/error_cases/global_zero_redefinition.c";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+
+    auto [exitCode, errorOutput] = compileWithOutput(inputFile);
+
+    EXPECT_NE(exitCode, 0) << "Compiler should reject a second initialized definition, even after `= 0`";
+    EXPECT_TRUE(errorOutput.find("Redefinition of global variable: count") != std::string::npos)
+        << "Error output should name the variable. Got: " << errorOutput;
+}
+
+TEST_F(CompilerErrorTest, OverlappingCaseRange) {
+    std::string inputFile = "tests/fixtures/output/error_cases/overlapping_case_range.c";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+
+    auto [exitCode, errorOutput] = compileWithOutput(inputFile);
+
+    EXPECT_NE(exitCode, 0) << "Compiler should reject a case value inside a wide case range";
+    EXPECT_TRUE(errorOutput.find("Duplicate (or overlapping) case value: 50 overlaps the range 0 ... 100") !=
+                std::string::npos)
+        << "Error output should name the value and the range. Got: " << errorOutput;
+}
+
 TEST_F(CompilerErrorTest, NonExistentFile) {
     std::string inputFile = "non_existent_file.c";
 
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <string>
 #include <cstdlib>
 #include <filesystem>
@@ -74,8 +75,8 @@ protected:
     }
 
     // 輔助方法：編譯 C 檔案生成 LLVM IR
-    bool generateLLVMIR(const std::string& inputFile, const std::string& llvmFile) {
-        std::string command = "./toyc " + inputFile + " -l -o " + llvmFile;
+    bool generateLLVMIR(const std::string& inputFile, const std::string& llvmFile, const std::string& flags = "") {
+        std::string command = "./toyc " + flags + (flags.empty() ? "" : " ") + inputFile + " -l -o " + llvmFile;
         int result = system(command.c_str());
         return WEXITSTATUS(result) == 0;
     }
@@ -116,8 +117,8 @@ protected:
         std::string gccExec = test_output_dir + "/gcc_exec";
         std::string outputFile = test_output_dir + "/gcc_output.txt";
 
-        // 使用 gcc 編譯
-        std::string compileCmd = "gcc -o " + gccExec + " " + inputFile + " 2>/dev/null";
+        // 使用 gcc 編譯（浮點數的 _Atomic 複合指定需要 libatomic）
+        std::string compileCmd = "gcc -o " + gccExec + " " + inputFile + " -latomic 2>/dev/null";
         int compileResult = system(compileCmd.c_str());
 
         if (WEXITSTATUS(compileResult) != 0) {
@@ -166,6 +167,28 @@ protected:
         return content.find(pattern) != std::string::npos;
     }
 
+    // 輔助方法：取得函式定義所使用的屬性群組，例如 "attributes #3 = { nounwind }"
+    std::string functionAttributes(const std::string& llvmFile, const std::string& function) {
+        std::string content = readFile(llvmFile);
+        std::istringstream lines(content);
+        std::string line;
+        std::string group;
+        while (std::getline(lines, line)) {
+            if (line.rfind("define ", 0) == 0 && line.find(" @" + function + "(") != std::string::npos) {
+                size_t hash = line.rfind(" #");
+                if (hash != std::string::npos) {
+                    group = line.substr(hash + 1, line.find(' ', hash + 1) - hash - 1);
+                }
+                break;
+            }
+        }
+        size_t attributes = group.empty() ? std::string::npos : content.find("attributes " + group + " = {");
+        if (attributes == std::string::npos) {
+            return "";
+        }
+        return content.substr(attributes, content.find('\n', attributes) - attributes);
+    }
+
     // 輔助方法：驗證並編譯測試檔案
     bool validateAndCompile(const std::string& inputFile, const std::string& execFile) {
         if (!fileExists(inputFile)) {
@@ -333,6 +356,522 @@ TEST_F(OutputTest, ConstIntNoVolatileIR) {
         << "const int should not emit volatile loads";
 }
 
+// ============================================================================
+// Stack lifetime LLVM IR tests
+// ============================================================================
+
+TEST_F(OutputTest, ScopedVLARestoresStackAndMarksLifetimes) {
+    std::string inputFile = "tests/fixtures/output/arrays/vla_scoped_lifetime.c";
+    std::string llvmFile = test_output_dir + "/vla_scoped_lifetime.ll";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+    ASSERT_TRUE(generateLLVMIR(inputFile, llvmFile)) << "LLVM IR generation failed";
+
+    EXPECT_TRUE(llvmIRContains(llvmFile, "@llvm.stacksave"))
+        << "a VLA inside a block should save the stack pointer before allocating";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "@llvm.stackrestore"))
+        << "leaving a VLA scope should restore the stack pointer";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "@llvm.lifetime.start"))
+        << "fixed-size locals should start their lifetime at the declaration";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "@llvm.lifetime.end"))
+        << "fixed-size locals should end their lifetime at scope exit";
+}
+
+TEST_F(OutputTest, ConstantArrayInitializerUsesMemcpyAndMemset) {
+    std::string inputFile = "tests/fixtures/output/arrays/array_constant_initializer.c";
+    std::string llvmFile = test_output_dir + "/array_constant_initializer.ll";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+    ASSERT_TRUE(generateLLVMIR(inputFile, llvmFile)) << "LLVM IR generation failed";
+
+    EXPECT_TRUE(llvmIRContains(llvmFile, "private unnamed_addr constant [16 x i32]"))
+        << "a constant lookup table should be emitted as read-only data";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "@llvm.memcpy.p0.p0.i64(ptr align 4 %table, ptr align 4 @__const.lookup.table, "
+                                         "i64 64, i1 false)"))
+        << "a constant initializer should be copied in with llvm.memcpy of a plain length";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "@llvm.memset.p0.i64(ptr align 4 %zeros, i8 0, i64 32, i1 false)"))
+        << "= {0} should zero the array with llvm.memset of a plain length";
+}
+
+TEST_F(OutputTest, StringLiteralsArePooled) {
+    std::string inputFile = "tests/fixtures/output/simple_programs/string_literal_pooling.c";
+    std::string llvmFile = test_output_dir + "/string_literal_pooling.ll";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+    ASSERT_TRUE(generateLLVMIR(inputFile, llvmFile)) << "LLVM IR generation failed";
+
+    EXPECT_TRUE(llvmIRContains(llvmFile, "private unnamed_addr constant [10 x i8] c\"value %d\\0A\\00\""))
+        << "repeated literals should share one private unnamed_addr global";
+    EXPECT_FALSE(llvmIRContains(llvmFile, "c\"%d\\0A\\00\""))
+        << "\"%d\\n\" is a suffix of \"value %d\\n\" and should point into its tail";
+    EXPECT_FALSE(llvmIRContains(llvmFile, "c\"world\\00\""))
+        << "\"world\" is a suffix of \"hello world\" and should point into its tail";
+}
+
+TEST_F(OutputTest, SwitchKeepsConditionWidthAndExpectWeights) {
+    std::string inputFile = "tests/fixtures/output/control_flow/switch_case_ranges.c";
+    std::string llvmFile = test_output_dir + "/switch_case_ranges.ll";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+    ASSERT_TRUE(generateLLVMIR(inputFile, llvmFile)) << "LLVM IR generation failed";
+
+    EXPECT_TRUE(llvmIRContains(llvmFile, "switch i64"))
+        << "a long switch condition should not be truncated to int";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "!\"branch_weights\", i32 1, i32 1, i32 2000, i32 1"))
+        << "__builtin_expect on the condition should mark the expected case as likely";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "i32 -2147483648, label %switch_case"))
+        << "an unsigned range crossing 0x80000000 should be enumerated, not treated as empty";
+}
+
+TEST_F(OutputTest, RestrictPointersAreNoAlias) {
+    std::string inputFile = "tests/fixtures/output/qualifiers/restrict_pointers.c";
+    std::string llvmFile = test_output_dir + "/restrict_pointers.ll";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+    ASSERT_TRUE(generateLLVMIR(inputFile, llvmFile)) << "LLVM IR generation failed";
+
+    EXPECT_TRUE(llvmIRContains(llvmFile, "ptr noalias nocapture %x, ptr noalias nocapture %y"))
+        << "restrict-qualified pointer parameters should be marked noalias";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "define i32 @bump_through_copy(ptr noalias %a)"))
+        << "a restrict parameter stays noalias when a restrict local is derived from it";
+    EXPECT_FALSE(llvmIRContains(llvmFile, "!noalias"))
+        << "a restrict pointer may be based on another, so accesses must not be marked as disjoint";
+    EXPECT_FALSE(llvmIRContains(llvmFile, "!alias.scope")) << "restrict locals get no function-wide alias scope";
+}
+
+TEST_F(OutputTest, MemoryAccessesCarryTBAA) {
+    std::string inputFile = "tests/fixtures/output/structures/tbaa_mixed_access.c";
+    std::string llvmFile = test_output_dir + "/tbaa_mixed_access.ll";
+    std::string plainFile = test_output_dir + "/tbaa_mixed_access_no_strict.ll";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+    ASSERT_TRUE(generateLLVMIR(inputFile, llvmFile)) << "LLVM IR generation failed";
+
+    EXPECT_TRUE(llvmIRContains(llvmFile, "!{!\"int\", !")) << "int accesses should have a scalar TBAA type";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "!{!\"double\", !")) << "double accesses should have a scalar TBAA type";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "!{!\"Sample\", !")) << "struct fields should use a struct-path TBAA type";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "!{!\"Sample\", !5, i64 0, !7, i64 8}")) << "double is 8-byte aligned";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "!{!\"Counter\", !5, i64 0, !13, i64 8}"))
+        << "long should follow int at its target offset 8, not 4";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "i64 8}")) << "the double field should be tagged at its offset";
+
+    ASSERT_TRUE(generateLLVMIR(inputFile, plainFile, "-fno-strict-aliasing")) << "LLVM IR generation failed";
+    EXPECT_FALSE(llvmIRContains(plainFile, "!tbaa")) << "-fno-strict-aliasing should drop TBAA metadata";
+}
+
+TEST_F(OutputTest, IntegerOpcodesFollowSignedness) {
+    std::string inputFile = "tests/fixtures/output/operators/unsigned_arithmetic.c";
+    std::string llvmFile = test_output_dir + "/unsigned_arithmetic.ll";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+    ASSERT_TRUE(generateLLVMIR(inputFile, llvmFile)) << "LLVM IR generation failed";
+
+    EXPECT_TRUE(llvmIRContains(llvmFile, "udiv i32")) << "unsigned division should use udiv";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "urem i32")) << "unsigned remainder should use urem";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "lshr i32")) << "unsigned right shift should be logical";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "ashr i32")) << "signed right shift should be arithmetic";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "icmp ugt i32")) << "unsigned comparison should use an unsigned predicate";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "add nsw i32")) << "signed int arithmetic should be marked nsw";
+}
+
+TEST_F(OutputTest, FloatSuffixKeepsSinglePrecision) {
+    std::string inputFile = "tests/fixtures/output/calculations/float_literal_precision.c";
+    std::string llvmFile = test_output_dir + "/float_literal_precision.ll";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+    ASSERT_TRUE(generateLLVMIR(inputFile, llvmFile)) << "LLVM IR generation failed";
+
+    EXPECT_TRUE(llvmIRContains(llvmFile, "fmul float")) << "float * float literal should stay in single precision";
+    EXPECT_FALSE(llvmIRContains(llvmFile, "fptrunc")) << "float results should never round-trip through double";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "fpext float")) << "float variadic arguments should be promoted to double";
+}
+
+TEST_F(OutputTest, IntegerLiteralsTakeTheirCType) {
+    std::string inputFile = "tests/fixtures/output/calculations/integer_literal_typing.c";
+    std::string llvmFile = test_output_dir + "/integer_literal_typing.ll";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+    ASSERT_TRUE(generateLLVMIR(inputFile, llvmFile)) << "LLVM IR generation failed";
+
+    EXPECT_TRUE(llvmIRContains(llvmFile, "i64 5000000000")) << "decimal literals above INT_MAX should become long";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "i64 3000000000")) << "literal arguments should keep their 64-bit value";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "i32 493")) << "octal literals should be parsed in base 8";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "define i64 @scale(i64")) << "long long should map to a 64-bit integer";
+}
+
+TEST_F(OutputTest, FunctionAttributesAreInferred) {
+    std::string inputFile = "tests/fixtures/output/functions/function_attributes.c";
+    std::string llvmFile = test_output_dir + "/function_attributes.ll";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+    ASSERT_TRUE(generateLLVMIR(inputFile, llvmFile)) << "LLVM IR generation failed";
+
+    EXPECT_TRUE(llvmIRContains(llvmFile, "define internal i32 @square(")) << "static functions should be internal";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "define internal i32 @sum(ptr nocapture %values"))
+        << "a pointer parameter that is only read through should be nocapture";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "tail call i32 @factorial(")) << "a call in return position should be tail";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "inlinehint")) << "inline functions should carry an inlining hint";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "nounwind memory(none)")) << "square touches no memory";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "nounwind memory(read)")) << "sum only reads its argument";
+
+    std::string waitAttributes = functionAttributes(llvmFile, "wait_ready");
+    std::string peekAttributes = functionAttributes(llvmFile, "peek_calls");
+    ASSERT_FALSE(waitAttributes.empty()) << "wait_ready should have an attribute group";
+    ASSERT_FALSE(peekAttributes.empty()) << "peek_calls should have an attribute group";
+    EXPECT_EQ(waitAttributes.find("memory("), std::string::npos)
+        << "an _Atomic load synchronizes, so wait_ready must not be memory(read): " << waitAttributes;
+    EXPECT_EQ(peekAttributes.find("memory("), std::string::npos)
+        << "__atomic_load_n synchronizes, so peek_calls must not be memory(read): " << peekAttributes;
+}
+
+TEST_F(OutputTest, GnuFunctionAttributesMapToLLVM) {
+    std::string inputFile = "tests/fixtures/output/functions/gnu_attributes.c";
+    std::string llvmFile = test_output_dir + "/gnu_attributes.ll";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+    ASSERT_TRUE(generateLLVMIR(inputFile, llvmFile)) << "LLVM IR generation failed";
+
+    EXPECT_TRUE(llvmIRContains(llvmFile, "cold noinline nounwind")) << "cold and noinline should reach the function";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "alwaysinline inlinehint")) << "always_inline should force inlining";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "hot nounwind")) << "hot should mark the function for the hot path";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "= { alwaysinline }")) << "flatten should inline every call site";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "nounwind memory(none)")) << "const functions should not access memory";
+}
+
+TEST_F(OutputTest, StructLayoutAttributesShapeTheLayout) {
+    std::string inputFile = "tests/fixtures/output/structures/struct_layout_attributes.c";
+    std::string llvmFile = test_output_dir + "/struct_layout_attributes.ll";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+    ASSERT_TRUE(generateLLVMIR(inputFile, llvmFile)) << "LLVM IR generation failed";
+
+    EXPECT_TRUE(llvmIRContains(llvmFile, "%Wire = type <{ i8, i32, i16 }>")) << "packed struct should have no padding";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "%Counter = type <{ i64, [56 x i8] }>"))
+        << "aligned(64) struct should be padded to a full cache line";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "alloca [2 x %Counter], align 64")) << "locals should honor the alignment";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "@samples = global [4 x i32] zeroinitializer, align 64"))
+        << "aligned variables should honor the alignment";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "load i32, ptr %member_ptr4, align 1"))
+        << "packed fields should be accessed unaligned";
+}
+
+TEST_F(OutputTest, BitFieldsAndUnionsShareStorage) {
+    std::string bitFieldFile = "tests/fixtures/output/structures/bit_fields.c";
+    std::string unionFile = "tests/fixtures/output/structures/unions.c";
+    std::string bitFieldIR = test_output_dir + "/bit_fields.ll";
+    std::string unionIR = test_output_dir + "/unions.ll";
+
+    ASSERT_TRUE(fileExists(bitFieldFile)) << "Test file not found: " << bitFieldFile;
+    ASSERT_TRUE(fileExists(unionFile)) << "Test file not found: " << unionFile;
+    ASSERT_TRUE(generateLLVMIR(bitFieldFile, bitFieldIR)) << "LLVM IR generation failed";
+    ASSERT_TRUE(generateLLVMIR(unionFile, unionIR)) << "LLVM IR generation failed";
+
+    EXPECT_TRUE(llvmIRContains(bitFieldIR, "%Flags = type <{ [6 x i8], i8, [1 x i8], [5 x i8], [3 x i8] }>"))
+        << "consecutive bit-fields should share one byte array";
+    EXPECT_TRUE(llvmIRContains(bitFieldIR, "@globalFlags = global %Flags <{ [6 x i8] c\"\\DB\\01\\00\\00d\\00\""))
+        << "constant bit-fields should be folded into their bytes";
+    EXPECT_TRUE(llvmIRContains(bitFieldIR, "%bitfield_top = shl i16 %bitfield_unit"))
+        << "a signed bit-field should be shifted against the top bit";
+    EXPECT_TRUE(llvmIRContains(bitFieldIR, "ashr i16 %bitfield_top, 11")) << "and sign-extended back down";
+    EXPECT_TRUE(llvmIRContains(bitFieldIR, "%bitfield_kept = and i8 %bitfield_unit"))
+        << "a store should keep the neighbouring bits";
+
+    EXPECT_TRUE(llvmIRContains(unionIR, "%union.Value = type <{ i32, [4 x i8] }>"))
+        << "a union should hold its first member padded to the largest";
+    EXPECT_TRUE(llvmIRContains(
+        unionIR, "@globalValue = global %union.Value <{ i32 1094861636, [4 x i8] zeroinitializer }>, align 8"))
+        << "a union initializer should set the first member";
+    EXPECT_TRUE(llvmIRContains(unionIR, "store float 1.000000e+00, ptr %member_ptr, align 4, !tbaa !0"))
+        << "union members should be accessed through a char tag";
+    EXPECT_TRUE(llvmIRContains(unionIR, "!1 = !{!\"omnipotent char\""))
+        << "union members should alias like char";
+}
+
+TEST_F(OutputTest, StructsArePassedByTheSysVABI) {
+    std::string inputFile = "tests/fixtures/output/structures/struct_by_value.c";
+    std::string llvmFile = test_output_dir + "/struct_by_value.ll";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+    ASSERT_TRUE(generateLLVMIR(inputFile, llvmFile)) << "LLVM IR generation failed";
+
+    EXPECT_TRUE(llvmIRContains(llvmFile, "define i64 @swap(i64 %p.coerce0)"))
+        << "an 8-byte struct of ints should travel in one integer register";
+    EXPECT_TRUE(llvmIRContains(llvmFile,
+                               "define double @apply(i64 %m.coerce0, double %m.coerce1, <2 x float> %f.coerce0, "
+                               "float %f.coerce1)"))
+        << "each eightbyte should be classified as INTEGER or SSE";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "define { <2 x float>, float } @scaleFloats("))
+        << "a small struct should be returned in registers";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "define i64 @trace(ptr byval(%Matrix) align 8 %m)"))
+        << "a struct over 16 bytes should be passed byval";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "define void @identity(ptr noalias sret(%Matrix) %result_slot, i64 %k)"))
+        << "a struct over 16 bytes should be returned through an sret pointer";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "i64 %p.coerce0, ptr byval(%Pair) align 8 %q)"))
+        << "a struct that no longer fits in the integer registers should go on the stack";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "call void @llvm.memcpy.p0.p0.i64(ptr align 8 %copy, ptr align 8 %id, i64 48"))
+        << "struct assignment should be a memcpy";
+    EXPECT_FALSE(llvmIRContains(llvmFile, "load %Matrix")) << "no whole-struct loads should be left";
+}
+
+TEST_F(OutputTest, InlineAsmIsLoweredToInlineAsmCalls) {
+    std::string inputFile = "tests/fixtures/output/functions/inline_asm.c";
+    std::string llvmFile = test_output_dir + "/inline_asm.ll";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+    ASSERT_TRUE(generateLLVMIR(inputFile, llvmFile)) << "LLVM IR generation failed";
+
+    EXPECT_TRUE(llvmIRContains(llvmFile, "call { i32, i32 } asm sideeffect \"rdtsc\", \"={ax},={dx},"))
+        << "asm volatile with two register outputs should return a struct";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "asm \"popcnt $1, $0\", \"=r,rm,~{dirflag},~{fpsr},~{flags}\""))
+        << "an asm with outputs and no volatile should not have side effects";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "asm \"addl $1, $0\", \"=r,ri,0,"))
+        << "a '+' output should become an output plus a tied input after the other inputs";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "asm \"bswap ${0:k}\""))
+        << "operand modifiers should be carried over";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "\"=*m,r,~{memory},"))
+        << "a memory output should be passed by address";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "(ptr elementtype(i32) %slot"))
+        << "an indirect operand should carry its element type";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "\"movl $$${2:c}, $0\0A${:uid}:"))
+        << "'$', '%c2' and '%=' should be rewritten for LLVM";
+}
+
+TEST_F(OutputTest, TargetClonesDispatchThroughAnIfunc) {
+    std::string inputFile = "tests/fixtures/output/functions/target_clones.c";
+    std::string llvmFile = test_output_dir + "/target_clones.ll";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+    ASSERT_TRUE(generateLLVMIR(inputFile, llvmFile)) << "LLVM IR generation failed";
+
+    EXPECT_TRUE(llvmIRContains(llvmFile, "@dot = ifunc i32 (ptr, ptr, i32), ptr @dot.resolver"))
+        << "callers should reach the clones through an ifunc named after the function";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "@factorial = internal ifunc")) << "a static function keeps its linkage";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "define internal i32 @dot.avx512f("))
+        << "each target should get its own internal clone";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "call void @__cpu_indicator_init()"))
+        << "the resolver should initialize the CPU model before testing it";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "select i1 %has_avx512f, ptr @dot.avx512f, ptr %version"))
+        << "the highest-priority feature should be tested last so it wins";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "\"target-features\"=\"+avx2,+fma\""))
+        << "target() should set the function's target features";
+}
+
+TEST_F(OutputTest, FastMathFlagsAreOptIn) {
+    std::string inputFile = "tests/fixtures/output/calculations/fast_math.c";
+    std::string strictFile = test_output_dir + "/fast_math_strict.ll";
+    std::string fastFile = test_output_dir + "/fast_math_fast.ll";
+    std::string contractFile = test_output_dir + "/fast_math_contract.ll";
+    std::string partialFile = test_output_dir + "/fast_math_partial.ll";
+    std::string undoneFile = test_output_dir + "/fast_math_undone.ll";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+    ASSERT_TRUE(generateLLVMIR(inputFile, strictFile)) << "LLVM IR generation failed";
+    ASSERT_TRUE(generateLLVMIR(inputFile, fastFile, "-ffast-math")) << "LLVM IR generation failed with -ffast-math";
+    ASSERT_TRUE(generateLLVMIR(inputFile, contractFile, "-ffp-contract=on"))
+        << "LLVM IR generation failed with -ffp-contract=on";
+    ASSERT_TRUE(generateLLVMIR(inputFile, partialFile, "-fassociative-math -freciprocal-math"))
+        << "LLVM IR generation failed with -fassociative-math";
+    ASSERT_TRUE(generateLLVMIR(inputFile, undoneFile, "-ffast-math -fno-fast-math"))
+        << "LLVM IR generation failed with -fno-fast-math";
+
+    EXPECT_TRUE(llvmIRContains(strictFile, "%add = fadd double %mul, %y")) << "strict IEEE math by default";
+    EXPECT_FALSE(llvmIRContains(strictFile, "fmuladd")) << "no contraction by default";
+    EXPECT_FALSE(llvmIRContains(strictFile, "unsafe-fp-math")) << "no fast-math attributes by default";
+
+    EXPECT_TRUE(llvmIRContains(fastFile, "%add = fadd fast double %compound_lhs, %mul"))
+        << "-ffast-math should make a reduction reorderable";
+    EXPECT_TRUE(llvmIRContains(fastFile, "%div = fdiv fast double")) << "-ffast-math should cover division";
+    EXPECT_TRUE(llvmIRContains(fastFile, "\"unsafe-fp-math\"=\"true\"")) << "the backend should be told as well";
+
+    EXPECT_TRUE(llvmIRContains(contractFile, "call double @llvm.fmuladd.f64(double %a"))
+        << "-ffp-contract=on should fuse a * x + y";
+    EXPECT_TRUE(llvmIRContains(contractFile, "@llvm.fmuladd.f64(double %neg")) << "y - a * x negates a factor";
+    EXPECT_TRUE(llvmIRContains(contractFile, "call float @llvm.fmuladd.f32(")) << "total += a * b should be fused";
+    EXPECT_TRUE(llvmIRContains(contractFile, "call double @sqrt(")) << "sqrt should stay a call by default";
+    EXPECT_TRUE(llvmIRContains(fastFile, "call fast double @llvm.sqrt.f64(")) << "-ffast-math implies -fno-math-errno";
+
+    EXPECT_TRUE(llvmIRContains(partialFile, "fadd reassoc arcp double")) << "only the requested flags are set";
+    EXPECT_FALSE(llvmIRContains(partialFile, "unsafe-fp-math")) << "two flags alone are not unsafe-fp-math";
+
+    EXPECT_TRUE(llvmIRContains(undoneFile, "call double @sqrt(")) << "-fno-fast-math should restore -fmath-errno";
+    EXPECT_FALSE(llvmIRContains(undoneFile, "fadd fast")) << "-fno-fast-math should clear the fast flags";
+}
+
+TEST_F(OutputTest, GlobalVariablesKeepLinkageAndConstness) {
+    std::string inputFile = "tests/fixtures/output/storage/global_and_static_variables.c";
+    std::string llvmFile = test_output_dir + "/global_and_static_variables.ll";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+    ASSERT_TRUE(generateLLVMIR(inputFile, llvmFile)) << "LLVM IR generation failed";
+
+    EXPECT_TRUE(llvmIRContains(llvmFile, "@total = global i32 100")) << "extern then defined should be one global";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "@uninitialized = global i32 0")) << "a tentative definition is zeroed";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "@hidden = internal global i32 7")) << "static globals have internal linkage";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "@primes = constant [8 x i32]")) << "const globals are constant";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "@nextId.counter = internal global i32 0"))
+        << "static locals are function-qualified internal globals";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "@lookupSquare.squares = internal constant [6 x i32]"))
+        << "static const locals are internal constants";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "@cursor = global ptr @total")) << "addresses of globals are constants";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "@late = global i32 42"))
+        << "a block-scope extern names the file-scope object";
+    EXPECT_FALSE(llvmIRContains(llvmFile, "@readLate.late")) << "a block-scope extern is not function-qualified";
+}
+
+TEST_F(OutputTest, OptimizerHintBuiltinsAreLowered) {
+    std::string inputFile = "tests/fixtures/output/functions/optimizer_builtins.c";
+    std::string llvmFile = test_output_dir + "/optimizer_builtins.ll";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+    ASSERT_TRUE(generateLLVMIR(inputFile, llvmFile)) << "LLVM IR generation failed";
+
+    EXPECT_TRUE(llvmIRContains(llvmFile, "!{!\"branch_weights\", i32 1, i32 2000}"))
+        << "__builtin_expect should weight the unlikely branch";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "call void @llvm.assume(i1 true) [ \"align\"("))
+        << "__builtin_assume_aligned should emit an alignment assumption";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "@llvm.prefetch.p0(ptr %values_decay, i32 1, i32 0, i32 1)"))
+        << "__builtin_prefetch should pass rw and locality through";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "unreachable")) << "__builtin_unreachable should end the block";
+}
+
+TEST_F(OutputTest, LibraryCallsBecomeIntrinsics) {
+    std::string inputFile = "tests/fixtures/output/functions/library_builtins.c";
+    std::string llvmFile = test_output_dir + "/library_builtins.ll";
+    std::string noErrnoFile = test_output_dir + "/library_builtins_no_errno.ll";
+    std::string noBuiltinFile = test_output_dir + "/library_builtins_no_builtin.ll";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+    ASSERT_TRUE(generateLLVMIR(inputFile, llvmFile)) << "LLVM IR generation failed";
+
+    EXPECT_TRUE(llvmIRContains(llvmFile, "call void @llvm.memcpy.p0.p0.i64(ptr %copy, ptr %source, i64 8, i1 false)"))
+        << "a fixed-size memcpy should become llvm.memcpy";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "call void @llvm.memmove.p0.p0.i64(")) << "memmove should become llvm.memmove";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "call void @llvm.memset.p0.i64(ptr %buffer_decay, i8 120, i64 7"))
+        << "memset should become llvm.memset";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "call double @sqrt(double 2.500000e+01)"))
+        << "sqrt may set errno, so it should stay a call by default";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "call float @sqrtf(")) << "sqrtf should stay a call by default";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "call double @llvm.sqrt.f64(double 1.600000e+01)"))
+        << "__builtin_sqrt should always become llvm.sqrt";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "call double @llvm.fabs.f64(")) << "fabs should become llvm.fabs";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "call double @llvm.minnum.f64(")) << "fmin should become llvm.minnum";
+
+    ASSERT_TRUE(generateLLVMIR(inputFile, noErrnoFile, "-fno-math-errno")) << "LLVM IR generation failed";
+    EXPECT_TRUE(llvmIRContains(noErrnoFile, "call double @llvm.sqrt.f64(double 2.500000e+01)"))
+        << "-fno-math-errno should lower sqrt to llvm.sqrt";
+    EXPECT_TRUE(llvmIRContains(noErrnoFile, "call float @llvm.sqrt.f32(")) << "sqrtf should become llvm.sqrt.f32";
+
+    ASSERT_TRUE(generateLLVMIR(inputFile, noBuiltinFile, "-fno-math-errno -fno-builtin-sqrt"))
+        << "LLVM IR generation failed";
+    EXPECT_TRUE(llvmIRContains(noBuiltinFile, "call double @sqrt(")) << "-fno-builtin-sqrt should keep the call";
+    EXPECT_TRUE(llvmIRContains(noBuiltinFile, "\"no-builtin-sqrt\"")) << "the optimizer should be told as well";
+    EXPECT_TRUE(llvmIRContains(noBuiltinFile, "call double @llvm.floor.f64("))
+        << "-fno-builtin-sqrt should leave other functions lowered";
+}
+
+TEST_F(OutputTest, VectorExtensionsAreLaneWise) {
+    std::string inputFile = "tests/fixtures/output/operators/vector_extensions.c";
+    std::string llvmFile = test_output_dir + "/vector_extensions.ll";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+    ASSERT_TRUE(generateLLVMIR(inputFile, llvmFile)) << "LLVM IR generation failed";
+
+    EXPECT_TRUE(llvmIRContains(llvmFile, "define <4 x float> @axpy(float %a, <4 x float> %x, <4 x float> %y)"))
+        << "vector typedefs should realize to LLVM vectors";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "fmul <4 x float> %splat.splat, %x")) << "a scalar operand should splat";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "fadd <8 x float>")) << "arithmetic should be lane-wise";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "%mask = sext <4 x i1>")) << "comparisons should yield lane masks";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "insertelement <8 x float> %vector, float 1.000000e+02, i32 3"))
+        << "a lane store should insert into the vector";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "extractelement <8 x float>")) << "a lane read should extract";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "alloca <8 x float>, align 32")) << "vectors should be naturally aligned";
+}
+
+TEST_F(OutputTest, LoopPragmasBecomeLoopMetadata) {
+    std::string inputFile = "tests/fixtures/output/control_flow/loop_pragmas.c";
+    std::string llvmFile = test_output_dir + "/loop_pragmas.ll";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+    ASSERT_TRUE(generateLLVMIR(inputFile, llvmFile)) << "LLVM IR generation failed";
+
+    EXPECT_TRUE(llvmIRContains(llvmFile, "br label %for_condition, !llvm.loop"))
+        << "the latch branch should carry the loop ID";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "!{!\"llvm.loop.vectorize.width\", i32 8}")) << "vectorize_width(8)";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "!{!\"llvm.loop.vectorize.enable\", i1 true}")) << "vectorize(enable)";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "!{!\"llvm.loop.interleave.count\", i32 2}")) << "interleave_count(2)";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "!{!\"llvm.loop.unroll.count\", i32 4}")) << "GCC unroll 4";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "!{!\"llvm.loop.unroll.full\"}")) << "unroll(full)";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "!{!\"llvm.loop.unroll.disable\"}")) << "unroll 1 should disable unrolling";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "!\"llvm.loop.parallel_accesses\"")) << "GCC ivdep";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "!llvm.access.group")) << "ivdep loop accesses should join an access group";
+}
+
+TEST_F(OutputTest, ParallelForIsOutlined) {
+    std::string inputFile = "tests/fixtures/output/control_flow/omp_parallel_for.c";
+    std::string llvmFile = test_output_dir + "/omp_parallel_for.ll";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+    ASSERT_TRUE(generateLLVMIR(inputFile, llvmFile)) << "LLVM IR generation failed";
+
+    EXPECT_TRUE(
+        llvmIRContains(llvmFile, "define internal void @sum_squares.omp_outlined(i64 %lower, i64 %upper, ptr %context)"))
+        << "the loop body should be outlined into a chunk function";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "call void @__toyc_omp_parallel_for(i64 %omp_trip_count, i32 0, i64 0, "
+                                         "ptr @sum_squares.omp_outlined"))
+        << "the enclosing function should hand the trip count to the runtime";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "i32 0, i64 16, ptr @saxpy.omp_outlined")) << "schedule(static, 16)";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "i32 1, i64 4, ptr @main.omp_outlined")) << "schedule(dynamic, 4)";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "ptr @stride_fill.omp_outlined.2,")) << "i = i - step is canonical too";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "call void @__toyc_omp_reduce_begin()"))
+        << "reduction copies should be merged under the runtime's lock";
+}
+
+TEST_F(OutputTest, AtomicsLowerToAtomicInstructions) {
+    std::string inputFile = "tests/fixtures/output/qualifiers/atomics.c";
+    std::string llvmFile = test_output_dir + "/atomics.ll";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+    ASSERT_TRUE(generateLLVMIR(inputFile, llvmFile)) << "LLVM IR generation failed";
+
+    EXPECT_TRUE(llvmIRContains(llvmFile, "load atomic i32, ptr @counter seq_cst"))
+        << "reading an _Atomic object should be a seq_cst atomic load";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "store atomic i64")) << "writing an _Atomic object should be atomic";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "atomicrmw add ptr @counter, i32 5 seq_cst"))
+        << "+= on an _Atomic integer should be one atomicrmw";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "cmpxchg ptr @counter")) << "*= should retry a cmpxchg";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "cmpxchg ptr %half")) << "+= of a double should be computed in double";
+    EXPECT_FALSE(llvmIRContains(llvmFile, "atomicrmw add ptr %half")) << "0.5 must not be truncated to 0 first";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "store atomic i32 20, ptr %plain release"))
+        << "__atomic_store_n should keep its memory order";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "atomicrmw add ptr %plain, i32 5 monotonic")) << "__ATOMIC_RELAXED";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "acq_rel acquire")) << "__atomic_compare_exchange_n orders";
+    EXPECT_TRUE(llvmIRContains(llvmFile, "fence seq_cst"));
+    EXPECT_TRUE(llvmIRContains(llvmFile, "fence syncscope(\"singlethread\") acquire"));
+}
+
+TEST_F(OutputTest, ThreadLocalVariablesPickTlsModel) {
+    std::string inputFile = "tests/fixtures/output/storage/thread_local.c";
+    std::string executableFile = test_output_dir + "/thread_local.ll";
+    std::string sharedFile = test_output_dir + "/thread_local_pic.ll";
+    std::string chosenFile = test_output_dir + "/thread_local_chosen.ll";
+
+    ASSERT_TRUE(fileExists(inputFile)) << "Test file not found: " << inputFile;
+    ASSERT_TRUE(generateLLVMIR(inputFile, executableFile)) << "LLVM IR generation failed";
+    ASSERT_TRUE(generateLLVMIR(inputFile, sharedFile, "-fPIC")) << "LLVM IR generation failed with -fPIC";
+    ASSERT_TRUE(generateLLVMIR(inputFile, chosenFile, "-ftls-model=local-dynamic"))
+        << "LLVM IR generation failed with -ftls-model";
+
+    EXPECT_TRUE(llvmIRContains(executableFile, "@calls = thread_local(initialexec) global i32 0"))
+        << "executables should use initial-exec";
+    EXPECT_TRUE(llvmIRContains(executableFile, "@next_id.id = internal thread_local(initialexec) global i32 100"))
+        << "static _Thread_local locals are thread-local globals too";
+    EXPECT_TRUE(llvmIRContains(executableFile, "@fast = thread_local(localexec)"))
+        << "tls_model on the variable should win";
+    EXPECT_TRUE(llvmIRContains(sharedFile, "@calls = thread_local global i32 0")) << "-fPIC should use global-dynamic";
+    EXPECT_TRUE(llvmIRContains(chosenFile, "@calls = thread_local(localdynamic)")) << "-ftls-model=local-dynamic";
+    EXPECT_TRUE(llvmIRContains(chosenFile, "@fast = thread_local(localexec)"));
+}
+
 // ============================================================================
 // 參數化測試：程式執行結果測試
 // ============================================================================
@@ -225,6 +225,32 @@ TEST_F(TypeManagerTest, ArrayTypeNDDeduplication) {
     EXPECT_NE(a, c);
 }
 
+// ==================== VectorType ====================
+
+TEST_F(TypeManagerTest, VectorTypeDeduplication) {
+    TypeIdx floatIdx = tm->getPrimitiveIdx(VAR_TYPE_FLOAT);
+
+    TypeIdx v8a = tm->getVectorIdx(floatIdx, 8);
+    TypeIdx v8b = tm->getVectorIdx(floatIdx, 8);
+    EXPECT_EQ(v8a, v8b);
+    EXPECT_NE(v8a, tm->getVectorIdx(floatIdx, 4));
+    EXPECT_NE(v8a, tm->getArrayIdx(floatIdx, {8}));
+}
+
+TEST_F(TypeManagerTest, VectorTypeRealizeLLVMType) {
+    TypeIdx floatIdx = tm->getPrimitiveIdx(VAR_TYPE_FLOAT);
+    TypeIdx vec = tm->getVectorIdx(floatIdx, 8);
+    llvm::Type* type = tm->realize(vec);
+    ASSERT_NE(type, nullptr);
+    ASSERT_TRUE(llvm::isa<llvm::FixedVectorType>(type));
+    auto* vecType = llvm::cast<llvm::FixedVectorType>(type);
+    EXPECT_EQ(vecType->getNumElements(), 8u);
+    EXPECT_EQ(vecType->getElementType(), llvm::Type::getFloatTy(ctx));
+    EXPECT_TRUE(tm->isVectorType(vec));
+    EXPECT_EQ(tm->getScalarTypeIdx(vec), floatIdx);
+    EXPECT_FALSE(tm->isFloatingPointType(vec));
+}
+
 // ==================== StructType ====================
 
 TEST_F(TypeManagerTest, StructTypeForwardDeclaration) {
@@ -295,6 +321,134 @@ TEST_F(TypeManagerTest, StructTypeUnknownMember) {
     EXPECT_EQ(tc->getMemberTypeIdx(999), InvalidTypeIdx);
 }
 
+TEST_F(TypeManagerTest, StructTypePackedLayout) {
+    TypeIdx charIdx = tm->getPrimitiveIdx(VAR_TYPE_CHAR);
+    TypeIdx intIdx = tm->getPrimitiveIdx(VAR_TYPE_INT);
+
+    // struct Wire { char tag; int length; } __attribute__((packed));
+    auto* member = new NStructDeclaration(charIdx, new NDeclarator("tag"));
+    member->next.reset(new NStructDeclaration(intIdx, new NDeclarator("length")));
+    TypeIdx idx = tm->getStructIdx("Wire", member);
+    tm->setStructLayoutAttributes(idx, true, 0);
+
+    auto* st = llvm::dyn_cast<llvm::StructType>(tm->realize(idx));
+    ASSERT_NE(st, nullptr);
+    EXPECT_TRUE(st->isPacked());
+    EXPECT_EQ(module->getDataLayout().getTypeAllocSize(st), 5u);
+    EXPECT_EQ(tm->getAlignment(idx), 1u);
+}
+
+TEST_F(TypeManagerTest, StructTypeAlignedFieldInsertsPadding) {
+    TypeIdx charIdx = tm->getPrimitiveIdx(VAR_TYPE_CHAR);
+
+    // struct Tagged { char kind; char value __attribute__((aligned(8))); };
+    auto* value = new NDeclarator("value");
+    value->alignment = 8;
+    auto* member = new NStructDeclaration(charIdx, new NDeclarator("kind"));
+    member->next.reset(new NStructDeclaration(charIdx, value));
+    TypeIdx idx = tm->getStructIdx("Tagged", member);
+
+    auto* st = llvm::dyn_cast<llvm::StructType>(tm->realize(idx));
+    ASSERT_NE(st, nullptr);
+    const auto* tc = dynamic_cast<const StructTypeCodegen*>(tm->get(idx));
+    ASSERT_NE(tc, nullptr);
+    const llvm::StructLayout* layout = module->getDataLayout().getStructLayout(st);
+    EXPECT_EQ(layout->getElementOffset(tc->getElementIndex(1)), 8u);
+    EXPECT_EQ(layout->getSizeInBytes(), 16u);
+    EXPECT_EQ(tm->getAlignment(idx), 8u);
+    EXPECT_EQ(tc->getMemberIndexForElement(1), -1);  // the padding between the fields
+}
+
+TEST_F(TypeManagerTest, UnionTypeOverlapsMembers) {
+    TypeIdx charIdx = tm->getPrimitiveIdx(VAR_TYPE_CHAR);
+    TypeIdx doubleIdx = tm->getPrimitiveIdx(VAR_TYPE_DOUBLE);
+
+    // union Name { char text[5]; double value; };
+    auto* text = new NDeclarator("text");
+    text->addArrayDimension(new NInteger(5));
+    auto* member = new NStructDeclaration(charIdx, text);
+    member->next.reset(new NStructDeclaration(doubleIdx, new NDeclarator("value")));
+    TypeIdx idx = tm->getUnionIdx("Name", member);
+    EXPECT_NE(idx, tm->getStructIdx("Name", nullptr));
+
+    auto* st = llvm::dyn_cast<llvm::StructType>(tm->realize(idx));
+    ASSERT_NE(st, nullptr);
+    const auto* tc = dynamic_cast<const StructTypeCodegen*>(tm->get(idx));
+    ASSERT_NE(tc, nullptr);
+    EXPECT_TRUE(tc->isUnion());
+    EXPECT_EQ(st->getName(), "union.Name");
+    EXPECT_EQ(tc->getElementIndex(0), 0u);
+    EXPECT_EQ(tc->getElementIndex(1), 0u);
+    EXPECT_EQ(module->getDataLayout().getTypeAllocSize(st), 8u);
+    EXPECT_EQ(tm->getAlignment(idx), 8u);
+}
+
+TEST_F(TypeManagerTest, StructTypeBitFieldsShareStorage) {
+    TypeIdx charIdx = tm->getPrimitiveIdx(VAR_TYPE_CHAR);
+    TypeIdx intIdx = tm->getPrimitiveIdx(VAR_TYPE_INT);
+
+    // struct Bits { char c; int low : 6; int high : 30; };
+    auto* low = new NDeclarator("low");
+    low->bitWidth = 6;
+    auto* high = new NDeclarator("high");
+    high->bitWidth = 30;
+    auto* member = new NStructDeclaration(charIdx, new NDeclarator("c"));
+    member->next.reset(new NStructDeclaration(intIdx, low));
+    member->next->next.reset(new NStructDeclaration(intIdx, high));
+    TypeIdx idx = tm->getStructIdx("Bits", member);
+
+    auto* st = llvm::dyn_cast<llvm::StructType>(tm->realize(idx));
+    ASSERT_NE(st, nullptr);
+    const auto* tc = dynamic_cast<const StructTypeCodegen*>(tm->get(idx));
+    ASSERT_NE(tc, nullptr);
+    // low fits beside c in the first int; high would straddle it, so it starts the next one
+    EXPECT_EQ(module->getDataLayout().getTypeAllocSize(st), 8u);
+    EXPECT_EQ(tm->getAlignment(idx), 4u);
+    EXPECT_EQ(tc->getBitFieldStorage(1).slot.shift, 0u);
+    EXPECT_EQ(tc->getBitFieldStorage(1).slot.storageBits, 8u);
+    EXPECT_EQ(tc->getBitFieldStorage(2).slot.storageBits, 32u);
+    EXPECT_EQ(tc->getMemberIndexForElement(tc->getElementIndex(2)), -1);
+}
+
+TEST_F(TypeManagerTest, RecordArgumentsAreClassifiedByEightbyte) {
+    TypeIdx intIdx = tm->getPrimitiveIdx(VAR_TYPE_INT);
+    TypeIdx doubleIdx = tm->getPrimitiveIdx(VAR_TYPE_DOUBLE);
+    TypeIdx longIdx = tm->getPrimitiveIdx(VAR_TYPE_LONG);
+
+    // struct Mixed { int i; double d; };
+    auto* mixedMember = new NStructDeclaration(intIdx, new NDeclarator("i"));
+    mixedMember->next.reset(new NStructDeclaration(doubleIdx, new NDeclarator("d")));
+    TypeIdx mixedIdx = tm->getStructIdx("Mixed", mixedMember);
+
+    // struct Wide { long a; long b; long c; };
+    auto* wideMember = new NStructDeclaration(longIdx, new NDeclarator("a"));
+    wideMember->next.reset(new NStructDeclaration(longIdx, new NDeclarator("b")));
+    wideMember->next->next.reset(new NStructDeclaration(longIdx, new NDeclarator("c")));
+    TypeIdx wideIdx = tm->getStructIdx("Wide", wideMember);
+
+    ArgumentRegisters registers;
+    ArgumentPassing scalar = tm->classifyArgument(intIdx, registers);
+    EXPECT_EQ(scalar.kind, ArgumentPassing::Direct);
+    EXPECT_EQ(registers.integer, 5u);
+
+    ArgumentPassing mixed = tm->classifyArgument(mixedIdx, registers);
+    ASSERT_EQ(mixed.kind, ArgumentPassing::Coerced);
+    ASSERT_EQ(mixed.pieces.size(), 2u);
+    EXPECT_TRUE(mixed.pieces[0]->isIntegerTy(64));
+    EXPECT_TRUE(mixed.pieces[1]->isDoubleTy());
+    EXPECT_EQ(registers.integer, 4u);
+    EXPECT_EQ(registers.sse, 7u);
+
+    EXPECT_EQ(tm->classifyArgument(wideIdx, registers).kind, ArgumentPassing::Indirect);
+    EXPECT_EQ(tm->classifyReturn(wideIdx).kind, ArgumentPassing::Indirect);
+    EXPECT_EQ(registers.integer, 4u) << "a struct passed in memory should take no registers";
+
+    // Once the integer registers run out, a struct needing one goes to memory as a whole
+    registers.integer = 0;
+    EXPECT_EQ(tm->classifyArgument(mixedIdx, registers).kind, ArgumentPassing::Indirect);
+    EXPECT_EQ(registers.sse, 7u);
+}
+
 // ==================== CommonType ====================
 
 TEST_F(TypeManagerTest, CommonTypeSameType) {
@@ -341,6 +495,38 @@ TEST_F(TypeManagerTest, CommonTypeBoolIsLowest) {
     EXPECT_EQ(tm->getCommonTypeIdx(boolIdx, floatIdx), floatIdx);
 }
 
+TEST_F(TypeManagerTest, CommonTypePromotesSmallIntegers) {
+    TypeIdx charIdx = tm->getPrimitiveIdx(VAR_TYPE_CHAR);
+    TypeIdx ucharIdx = tm->getPrimitiveIdx(VAR_TYPE_UCHAR);
+    TypeIdx ushortIdx = tm->getPrimitiveIdx(VAR_TYPE_USHORT);
+    TypeIdx intIdx = tm->getPrimitiveIdx(VAR_TYPE_INT);
+
+    EXPECT_EQ(tm->getCommonTypeIdx(charIdx, charIdx), intIdx);
+    EXPECT_EQ(tm->getCommonTypeIdx(ucharIdx, charIdx), intIdx);
+    EXPECT_EQ(tm->getCommonTypeIdx(ushortIdx, intIdx), intIdx);
+}
+
+TEST_F(TypeManagerTest, CommonTypeRespectsSignedness) {
+    TypeIdx intIdx = tm->getPrimitiveIdx(VAR_TYPE_INT);
+    TypeIdx uintIdx = tm->getPrimitiveIdx(VAR_TYPE_UINT);
+    TypeIdx longIdx = tm->getPrimitiveIdx(VAR_TYPE_LONG);
+    TypeIdx ulongIdx = tm->getPrimitiveIdx(VAR_TYPE_ULONG);
+
+    EXPECT_EQ(tm->getCommonTypeIdx(intIdx, uintIdx), uintIdx);
+    EXPECT_EQ(tm->getCommonTypeIdx(uintIdx, longIdx), longIdx);
+    EXPECT_EQ(tm->getCommonTypeIdx(longIdx, ulongIdx), ulongIdx);
+    EXPECT_EQ(tm->getCommonTypeIdx(ulongIdx, intIdx), ulongIdx);
+}
+
+TEST_F(TypeManagerTest, UnsignedTypesShareWidthWithSigned) {
+    EXPECT_EQ(tm->realize(tm->getPrimitiveIdx(VAR_TYPE_UCHAR)), llvm::Type::getInt8Ty(ctx));
+    EXPECT_EQ(tm->realize(tm->getPrimitiveIdx(VAR_TYPE_USHORT)), llvm::Type::getInt16Ty(ctx));
+    EXPECT_EQ(tm->realize(tm->getPrimitiveIdx(VAR_TYPE_UINT)), llvm::Type::getInt32Ty(ctx));
+    EXPECT_EQ(tm->realize(tm->getPrimitiveIdx(VAR_TYPE_ULONG)), llvm::Type::getInt64Ty(ctx));
+    EXPECT_TRUE(tm->isUnsignedType(tm->getPrimitiveIdx(VAR_TYPE_UINT)));
+    EXPECT_FALSE(tm->isUnsignedType(tm->getPrimitiveIdx(VAR_TYPE_INT)));
+}
+
 // ==================== InvalidIdx ====================
 
 TEST_F(TypeManagerTest, InvalidIdxGetReturnsNull) {
@@ -404,6 +590,16 @@ TEST_F(TypeManagerTest, QualifiedPointerBothQualifiers) {
     EXPECT_TRUE(tm->isVolatileQualified(bothPtr));
 }
 
+TEST_F(TypeManagerTest, StackedQualifiersFoldIntoOneLayer) {
+    TypeIdx intIdx = tm->getPrimitiveIdx(VAR_TYPE_INT);
+    TypeIdx atomicIdx = tm->getQualifiedIdx(intIdx, QUAL_ATOMIC);
+    TypeIdx constAtomicIdx = tm->getQualifiedIdx(atomicIdx, QUAL_CONST);
+    EXPECT_TRUE(tm->isAtomicQualified(constAtomicIdx));
+    EXPECT_TRUE(tm->isConstQualified(constAtomicIdx));
+    EXPECT_EQ(constAtomicIdx, tm->getQualifiedIdx(intIdx, QUAL_CONST | QUAL_ATOMIC));
+    EXPECT_EQ(intIdx, tm->unqualify(constAtomicIdx));
+}
+
 TEST_F(TypeManagerTest, QualifiedPointerOnPrimitiveReturnsFalse) {
     TypeIdx intIdx = tm->getPrimitiveIdx(VAR_TYPE_INT);
     EXPECT_FALSE(tm->isConstQualified(intIdx));